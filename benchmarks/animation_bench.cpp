@@ -0,0 +1,47 @@
+// Skeletal animation benchmark: Animator::UpdateAnimation on generated skeletons of M bones with K keyframes,
+// built in memory (no model file, no OpenGL context needed).
+//
+// usage: animation_bench [--benchmark_filter=REGEX] [--benchmark_out=results.json] ...
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <learnopengl/animator.h>
+
+#include "benchmark.h"
+#include "scene_generators.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+// M bones (at most 100, the size of the Animator's matrix palette), K keyframes per bone
+static void BM_AnimatorUpdateAnimation(benchmark::State& state)
+{
+    const unsigned int bones = static_cast<unsigned int>(state.range(0));
+    const unsigned int keys = static_cast<unsigned int>(state.range(1));
+    std::unique_ptr<aiScene> scene(generateSkeletonScene(bones, keys));
+
+    // what Model::ExtractBoneWeightForVertices would have found in the skinned meshes
+    std::map<std::string, BoneInfo> boneInfoMap;
+    int boneCount = 0;
+    for(unsigned int i = 0; i < bones; i++)
+    {
+        BoneInfo info;
+        info.id = boneCount++;
+        info.offset = glm::mat4(1.0f);
+        boneInfoMap["bone" + std::to_string(i)] = info;
+    }
+    Animation animation(scene.get(), boneInfoMap, boneCount);
+    Animator animator(&animation);
+
+    for(auto _ : state)
+    {
+        animator.UpdateAnimation(1.0f / 60.0f);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * bones);
+}
+BENCHMARK(BM_AnimatorUpdateAnimation)->Args({16, 30})->Args({64, 30})->Args({100, 30})->Args({100, 300})->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
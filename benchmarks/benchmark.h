@@ -0,0 +1,651 @@
+// Minimal benchmark harness with the Google Benchmark API the benchmarks in this directory use. When CMake finds
+// Google Benchmark it defines USE_GOOGLE_BENCHMARK and the real library is used instead, the code is the same:
+//
+//     static void BM_Something(benchmark::State& state)
+//     {
+//         Scene scene(state.range(0));              // setup, not timed
+//         for (auto _ : state)
+//             benchmark::DoNotOptimize(scene.update());
+//         state.SetItemsProcessed(state.iterations() * state.range(0));
+//     }
+//     BENCHMARK(BM_Something)->Arg(1000)->Arg(100000);
+//     BENCHMARK_MAIN();
+//
+// Flags: --benchmark_filter=REGEX, --benchmark_min_time=SECONDS, --benchmark_repetitions=N,
+//        --benchmark_format=console|json, --benchmark_out=FILE (always JSON, same schema as Google Benchmark)
+
+#ifndef BENCHMARK_HARNESS_H
+#define BENCHMARK_HARNESS_H
+
+#ifdef USE_GOOGLE_BENCHMARK
+#include <benchmark/benchmark.h>
+#else
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
+
+namespace benchmark {
+
+enum TimeUnit { kNanosecond, kMicrosecond, kMillisecond, kSecond };
+
+// keeps the compiler from optimizing away a value (or the computation behind it)
+template <typename T>
+inline void DoNotOptimize(T const& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// makes every pending write to memory visible, so stores aren't optimized away either
+inline void ClobberMemory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+class State
+{
+public:
+    // user counters, reported next to the timings (rates are not computed, store the final value)
+    std::map<std::string, double> counters;
+
+    State(int64_t maxIterations, const std::vector<int64_t> &ranges)
+        : counters(), maxIterations(maxIterations), ranges(ranges), itemsProcessed(0), bytesProcessed(0),
+          skipped(false), running(false), cpuStart(0.0), realSeconds(0.0), cpuSeconds(0.0)
+    {
+    }
+
+    // marked unused so `for(auto _ : state)` doesn't warn
+#if defined(__GNUC__) || defined(__clang__)
+    struct __attribute__((unused)) Value {};
+#else
+    struct Value {};
+#endif
+    struct Iterator
+    {
+        State* state;
+        int64_t left;
+
+        bool operator!=(const Iterator&)
+        {
+            if(left > 0)
+                return true;
+            state->stopTimer();
+            return false;
+        }
+        void operator++()
+        {
+            --left;
+        }
+        Value operator*() const
+        {
+            return Value();
+        }
+    };
+
+    // the timer runs from begin() to the end of the last iteration
+    Iterator begin()
+    {
+        Iterator it = { this, skipped ? 0 : maxIterations };
+        startTimer();
+        return it;
+    }
+    Iterator end()
+    {
+        Iterator it = { this, 0 };
+        return it;
+    }
+
+    int64_t range(size_t i = 0) const
+    {
+        return i < ranges.size() ? ranges[i] : 0;
+    }
+
+    int64_t iterations() const
+    {
+        return maxIterations;
+    }
+
+    void PauseTiming()
+    {
+        stopTimer();
+    }
+
+    void ResumeTiming()
+    {
+        startTimer();
+    }
+
+    void SetItemsProcessed(int64_t items)
+    {
+        itemsProcessed = items;
+    }
+
+    void SetBytesProcessed(int64_t bytes)
+    {
+        bytesProcessed = bytes;
+    }
+
+    void SetLabel(const std::string &text)
+    {
+        label = text;
+    }
+
+    // stops the benchmark (call before the loop, which then runs no iteration) and reports the error
+    void SkipWithError(const std::string &message)
+    {
+        skipped = true;
+        error = message;
+    }
+
+private:
+    template <typename> friend class Runner;
+
+    int64_t maxIterations;
+    std::vector<int64_t> ranges;
+    int64_t itemsProcessed;
+    int64_t bytesProcessed;
+    std::string label;
+    bool skipped;
+    std::string error;
+
+    bool running;
+    std::chrono::steady_clock::time_point realStart;
+    double cpuStart;
+    double realSeconds;
+    double cpuSeconds;
+
+    static double processCpuSeconds()
+    {
+#if defined(_POSIX_CPUTIME) || defined(__linux__)
+        timespec ts;
+        if(clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) == 0)
+            return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+        return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+    }
+
+    void startTimer()
+    {
+        if(running)
+            return;
+        running = true;
+        cpuStart = processCpuSeconds();
+        realStart = std::chrono::steady_clock::now();
+    }
+
+    void stopTimer()
+    {
+        if(!running)
+            return;
+        realSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - realStart).count();
+        cpuSeconds += processCpuSeconds() - cpuStart;
+        running = false;
+    }
+};
+
+typedef void (*Function)(State&);
+
+class Benchmark
+{
+public:
+    Benchmark(const std::string &name, Function function)
+        : name(name), function(function), unit(kNanosecond), minTime(0.0)
+    {
+    }
+
+    Benchmark* Arg(int64_t x)
+    {
+        args.push_back(std::vector<int64_t>(1, x));
+        return this;
+    }
+
+    Benchmark* Args(const std::vector<int64_t> &x)
+    {
+        args.push_back(x);
+        return this;
+    }
+
+    // every x in [first, last], multiplying by 8 (like Google Benchmark's default)
+    Benchmark* Range(int64_t first, int64_t last)
+    {
+        for(int64_t x = first; x < last; x *= 8)
+            Arg(x);
+        return Arg(last);
+    }
+
+    Benchmark* Unit(TimeUnit timeUnit)
+    {
+        unit = timeUnit;
+        return this;
+    }
+
+    Benchmark* MinTime(double seconds)
+    {
+        minTime = seconds;
+        return this;
+    }
+
+private:
+    template <typename> friend class Runner;
+
+    std::string name;
+    Function function;
+    std::vector<std::vector<int64_t> > args;
+    TimeUnit unit;
+    double minTime;
+};
+
+// one measured run of a benchmark with one set of arguments
+struct Run
+{
+    std::string name;
+    std::string runName;
+    std::string aggregate; // "", "mean", "median" or "stddev"
+    int repetitionIndex;
+    int repetitions;
+    int64_t iterations;
+    double realTime; // per iteration, in unit
+    double cpuTime;
+    TimeUnit unit;
+    double itemsPerSecond;
+    double bytesPerSecond;
+    std::map<std::string, double> counters;
+    std::string label;
+    std::string error;
+};
+
+struct Settings
+{
+    std::string filter = ".";
+    double minTime = 0.5;
+    int repetitions = 1;
+    std::string format = "console";
+    std::string out;
+    std::string executable;
+};
+
+inline std::vector<Benchmark*>& registeredBenchmarks()
+{
+    static std::vector<Benchmark*> instance;
+    return instance;
+}
+
+inline Settings& settings()
+{
+    static Settings instance;
+    return instance;
+}
+
+inline Benchmark* RegisterBenchmark(const char* name, Function function)
+{
+    Benchmark* benchmark = new Benchmark(name, function); // lives until exit, like the registrations
+    registeredBenchmarks().push_back(benchmark);
+    return benchmark;
+}
+
+// the template only lets the runner live in a header without an extra translation unit
+template <typename Dummy>
+class Runner
+{
+public:
+    static std::vector<Run> runAll()
+    {
+        Settings &s = settings();
+        std::regex filter(s.filter);
+        std::vector<Run> runs;
+        std::vector<Benchmark*> &benchmarks = registeredBenchmarks();
+        for(size_t b = 0; b < benchmarks.size(); b++)
+        {
+            std::vector<std::vector<int64_t> > argSets = benchmarks[b]->args;
+            if(argSets.empty())
+                argSets.push_back(std::vector<int64_t>());
+            for(size_t a = 0; a < argSets.size(); a++)
+            {
+                std::string name = benchmarks[b]->name;
+                for(size_t i = 0; i < argSets[a].size(); i++)
+                    name += "/" + std::to_string(argSets[a][i]);
+                if(!std::regex_search(name, filter))
+                    continue;
+
+                std::vector<Run> repetitions;
+                for(int r = 0; r < s.repetitions; r++)
+                {
+                    Run run = runOne(*benchmarks[b], argSets[a], name);
+                    run.repetitionIndex = r;
+                    run.repetitions = s.repetitions;
+                    report(run);
+                    repetitions.push_back(run);
+                    runs.push_back(run);
+                    if(!run.error.empty())
+                        break;
+                }
+                if(repetitions.size() > 1)
+                {
+                    std::vector<Run> aggregates = aggregate(repetitions);
+                    for(size_t i = 0; i < aggregates.size(); i++)
+                    {
+                        report(aggregates[i]);
+                        runs.push_back(aggregates[i]);
+                    }
+                }
+            }
+        }
+        return runs;
+    }
+
+    static void printHeader()
+    {
+        std::cout << std::left << std::setw(nameWidth()) << "Benchmark" << std::right << std::setw(15) << "Time"
+                  << std::setw(15) << "CPU" << std::setw(12) << "Iterations" << std::endl;
+        std::cout << std::string(nameWidth() + 42, '-') << std::endl;
+    }
+
+    static void writeJson(std::ostream &out, const std::vector<Run> &runs)
+    {
+        Settings &s = settings();
+        char date[64];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+        char host[256] = "unknown";
+#ifdef __unix__
+        gethostname(host, sizeof(host) - 1);
+#endif
+        out << "{\n  \"context\": {\n";
+        out << "    \"date\": \"" << date << "\",\n";
+        out << "    \"host_name\": \"" << escape(host) << "\",\n";
+        out << "    \"executable\": \"" << escape(s.executable) << "\",\n";
+        out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+        out << "    \"library_build_type\": \"release\"\n";
+#else
+        out << "    \"library_build_type\": \"debug\"\n";
+#endif
+        out << "  },\n  \"benchmarks\": [\n";
+        for(size_t i = 0; i < runs.size(); i++)
+        {
+            const Run &run = runs[i];
+            out << "    {\n";
+            out << "      \"name\": \"" << escape(run.name) << "\",\n";
+            out << "      \"run_name\": \"" << escape(run.runName) << "\",\n";
+            out << "      \"run_type\": \"" << (run.aggregate.empty() ? "iteration" : "aggregate") << "\",\n";
+            out << "      \"repetitions\": " << run.repetitions << ",\n";
+            out << "      \"repetition_index\": " << run.repetitionIndex << ",\n";
+            out << "      \"threads\": 1,\n";
+            if(!run.aggregate.empty())
+                out << "      \"aggregate_name\": \"" << run.aggregate << "\",\n";
+            if(!run.error.empty())
+            {
+                out << "      \"error_occurred\": true,\n";
+                out << "      \"error_message\": \"" << escape(run.error) << "\",\n";
+            }
+            out << "      \"iterations\": " << run.iterations << ",\n";
+            out << "      \"real_time\": " << std::setprecision(10) << run.realTime << ",\n";
+            out << "      \"cpu_time\": " << run.cpuTime << ",\n";
+            out << "      \"time_unit\": \"" << unitName(run.unit) << "\"";
+            if(run.itemsPerSecond > 0.0)
+                out << ",\n      \"items_per_second\": " << run.itemsPerSecond;
+            if(run.bytesPerSecond > 0.0)
+                out << ",\n      \"bytes_per_second\": " << run.bytesPerSecond;
+            for(std::map<std::string, double>::const_iterator it = run.counters.begin(); it != run.counters.end(); ++it)
+                out << ",\n      \"" << escape(it->first) << "\": " << it->second;
+            if(!run.label.empty())
+                out << ",\n      \"label\": \"" << escape(run.label) << "\"";
+            out << "\n    }" << (i + 1 < runs.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+
+private:
+    static int nameWidth()
+    {
+        return 48;
+    }
+
+    static Run runOne(Benchmark &benchmark, const std::vector<int64_t> &args, const std::string &name)
+    {
+        Settings &s = settings();
+        double minTime = benchmark.minTime > 0.0 ? benchmark.minTime : s.minTime;
+        // grow the iteration count until a run lasts long enough, like Google Benchmark
+        int64_t iterations = 1;
+        for(;;)
+        {
+            State state(iterations, args);
+            benchmark.function(state);
+            bool done = state.skipped || state.realSeconds >= minTime || iterations >= 1000000000;
+            if(done)
+                return makeRun(benchmark, state, name, iterations);
+            double multiplier = state.realSeconds > 0.0 ? minTime * 1.4 / state.realSeconds : 10.0;
+            multiplier = std::min(10.0, std::max(multiplier, 2.0));
+            iterations = std::max<int64_t>(iterations + 1, static_cast<int64_t>(iterations * multiplier));
+        }
+    }
+
+    static Run makeRun(const Benchmark &benchmark, const State &state, const std::string &name, int64_t iterations)
+    {
+        Run run;
+        run.name = name;
+        run.runName = name;
+        run.repetitionIndex = 0;
+        run.repetitions = 1;
+        run.iterations = state.skipped ? 0 : iterations;
+        run.unit = benchmark.unit;
+        run.realTime = state.skipped ? 0.0 : state.realSeconds / iterations * unitMultiplier(benchmark.unit);
+        run.cpuTime = state.skipped ? 0.0 : state.cpuSeconds / iterations * unitMultiplier(benchmark.unit);
+        run.itemsPerSecond = state.realSeconds > 0.0 ? state.itemsProcessed / state.realSeconds : 0.0;
+        run.bytesPerSecond = state.realSeconds > 0.0 ? state.bytesProcessed / state.realSeconds : 0.0;
+        run.counters = state.counters;
+        run.label = state.label;
+        run.error = state.error;
+        return run;
+    }
+
+    static std::vector<Run> aggregate(const std::vector<Run> &runs)
+    {
+        const char* names[3] = { "mean", "median", "stddev" };
+        std::vector<Run> result;
+        for(int a = 0; a < 3; a++)
+        {
+            Run run = runs[0];
+            run.name = runs[0].runName + "_" + names[a];
+            run.aggregate = names[a];
+            run.realTime = statistic(runs, a, &Run::realTime);
+            run.cpuTime = statistic(runs, a, &Run::cpuTime);
+            run.itemsPerSecond = statistic(runs, a, &Run::itemsPerSecond);
+            run.bytesPerSecond = statistic(runs, a, &Run::bytesPerSecond);
+            run.iterations = static_cast<int64_t>(runs.size());
+            result.push_back(run);
+        }
+        return result;
+    }
+
+    static double statistic(const std::vector<Run> &runs, int which, double Run::*field)
+    {
+        std::vector<double> values;
+        for(size_t i = 0; i < runs.size(); i++)
+            values.push_back(runs[i].*field);
+        double mean = 0.0;
+        for(size_t i = 0; i < values.size(); i++)
+            mean += values[i];
+        mean /= values.size();
+        if(which == 0)
+            return mean;
+        if(which == 1)
+        {
+            std::sort(values.begin(), values.end());
+            size_t middle = values.size() / 2;
+            return values.size() % 2 ? values[middle] : 0.5 * (values[middle - 1] + values[middle]);
+        }
+        double variance = 0.0;
+        for(size_t i = 0; i < values.size(); i++)
+            variance += (values[i] - mean) * (values[i] - mean);
+        return values.size() > 1 ? std::sqrt(variance / (values.size() - 1)) : 0.0;
+    }
+
+    static void report(const Run &run)
+    {
+        if(settings().format == "json")
+            return;
+        std::cout << std::left << std::setw(nameWidth()) << run.name << std::right;
+        if(!run.error.empty())
+        {
+            std::cout << " ERROR: " << run.error << std::endl;
+            return;
+        }
+        std::ostringstream real, cpu;
+        real << std::fixed << std::setprecision(run.realTime < 10.0 ? 3 : 0) << run.realTime << " " << unitName(run.unit);
+        cpu << std::fixed << std::setprecision(run.cpuTime < 10.0 ? 3 : 0) << run.cpuTime << " " << unitName(run.unit);
+        std::cout << std::setw(15) << real.str() << std::setw(15) << cpu.str() << std::setw(12) << run.iterations;
+        if(run.itemsPerSecond > 0.0)
+            std::cout << " items_per_second=" << humanReadable(run.itemsPerSecond) << "/s";
+        for(std::map<std::string, double>::const_iterator it = run.counters.begin(); it != run.counters.end(); ++it)
+            std::cout << " " << it->first << "=" << humanReadable(it->second);
+        if(!run.label.empty())
+            std::cout << " " << run.label;
+        std::cout << std::endl;
+    }
+
+    static double unitMultiplier(TimeUnit unit)
+    {
+        switch(unit)
+        {
+        case kSecond:      return 1.0;
+        case kMillisecond: return 1e3;
+        case kMicrosecond: return 1e6;
+        default:           return 1e9;
+        }
+    }
+
+    static const char* unitName(TimeUnit unit)
+    {
+        switch(unit)
+        {
+        case kSecond:      return "s";
+        case kMillisecond: return "ms";
+        case kMicrosecond: return "us";
+        default:           return "ns";
+        }
+    }
+
+    static std::string humanReadable(double value)
+    {
+        const char* suffixes[] = { "", "k", "M", "G", "T" };
+        int i = 0;
+        while(std::fabs(value) >= 1000.0 && i < 4)
+        {
+            value /= 1000.0;
+            i++;
+        }
+        std::ostringstream out;
+        out << std::setprecision(4) << value << suffixes[i];
+        return out.str();
+    }
+
+    static std::string escape(const std::string &text)
+    {
+        std::string result;
+        for(size_t i = 0; i < text.size(); i++)
+        {
+            if(text[i] == '"' || text[i] == '\\')
+                result += '\\';
+            result += text[i];
+        }
+        return result;
+    }
+};
+
+inline void Initialize(int* argc, char** argv)
+{
+    Settings &s = settings();
+    s.executable = *argc > 0 ? argv[0] : "";
+    int kept = 1;
+    for(int i = 1; i < *argc; i++)
+    {
+        std::string argument = argv[i];
+        std::string value = argument.substr(argument.find('=') + 1);
+        if(argument.compare(0, 19, "--benchmark_filter=") == 0)
+            s.filter = value;
+        else if(argument.compare(0, 21, "--benchmark_min_time=") == 0)
+            s.minTime = std::atof(value.c_str());
+        else if(argument.compare(0, 24, "--benchmark_repetitions=") == 0)
+            s.repetitions = std::max(1, std::atoi(value.c_str()));
+        else if(argument.compare(0, 19, "--benchmark_format=") == 0)
+            s.format = value;
+        else if(argument.compare(0, 16, "--benchmark_out=") == 0)
+            s.out = value;
+        else if(argument.compare(0, 23, "--benchmark_out_format=") == 0)
+            continue; // JSON only
+        else
+            argv[kept++] = argv[i]; // left for the benchmark's own main
+    }
+    *argc = kept;
+}
+
+// the number of benchmarks run
+inline size_t RunSpecifiedBenchmarks()
+{
+    Settings &s = settings();
+    if(s.format != "json")
+        Runner<void>::printHeader();
+    std::vector<Run> runs = Runner<void>::runAll();
+    if(s.format == "json")
+        Runner<void>::writeJson(std::cout, runs);
+    if(!s.out.empty())
+    {
+        std::ofstream file(s.out.c_str());
+        if(file)
+            Runner<void>::writeJson(file, runs);
+        else
+            std::cerr << "can't write " << s.out << std::endl;
+    }
+    return runs.size();
+}
+
+inline void Shutdown()
+{
+}
+
+} // namespace benchmark
+
+#define BENCHMARK_CONCAT_(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_(a, b)
+#define BENCHMARK(function) \
+    static ::benchmark::Benchmark* BENCHMARK_CONCAT(benchmark_registration_, __LINE__) = \
+        ::benchmark::RegisterBenchmark(#function, function)
+
+#define BENCHMARK_MAIN()                               \
+    int main(int argc, char** argv)                    \
+    {                                                  \
+        ::benchmark::Initialize(&argc, argv);          \
+        ::benchmark::RunSpecifiedBenchmarks();         \
+        ::benchmark::Shutdown();                       \
+        return 0;                                      \
+    }                                                  \
+    int main(int, char**)
+
+#endif // USE_GOOGLE_BENCHMARK
+#endif
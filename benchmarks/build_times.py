@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+
+# Full build time of the project with and without the precompiled header and the unity build:
+# every configuration is configured in its own directory and built from scratch.
+#
+# usage: benchmarks/build_times.py [--jobs N] [--runs N]
+
+import argparse
+import os
+import shutil
+import statistics
+import subprocess
+import time
+
+
+CONFIGURATIONS = [
+    ("pch off", ["-DENABLE_PCH=OFF"]),
+    ("pch on", ["-DENABLE_PCH=ON"]),
+    ("unity", ["-DENABLE_PCH=OFF", "-DENABLE_UNITY_BUILD=ON"]),
+]
+
+
+def build_time(source: str, build: str, options: list, jobs: int) -> float:
+    shutil.rmtree(build, ignore_errors=True)
+    subprocess.run(["cmake", "-S", source, "-B", build] + options,
+                   check=True, stdout=subprocess.DEVNULL)
+    start = time.perf_counter()
+    subprocess.run(["cmake", "--build", build, "-j", str(jobs)],
+                   check=True, stdout=subprocess.DEVNULL)
+    return time.perf_counter() - start
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--jobs", type=int, default=os.cpu_count())
+    parser.add_argument("--runs", type=int, default=3)
+    arguments = parser.parse_args()
+
+    source = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    for name, options in CONFIGURATIONS:
+        build = os.path.join(source, "build", "build_times", name.replace(" ", "_"))
+        times = [build_time(source, build, options, arguments.jobs) for _ in range(arguments.runs)]
+        print(f"{name:8} median {statistics.median(times):7.1f} s, "
+              f"min {min(times):7.1f} s over {arguments.runs} runs, -j{arguments.jobs}")
+        shutil.rmtree(build, ignore_errors=True)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,238 @@
+// Cluster culling benchmarks: the import steps (vertex cache optimization, cluster build) of a high-poly mesh,
+// then the CPU culler (frustum + normal cone) and the index compaction over 240 frames of a camera orbiting the
+// mesh. The culling counters say how many clusters and triangles were removed. No OpenGL context
+// is needed.
+//
+// usage: cluster_culling_bench [model file] [--benchmark_filter=REGEX] [--benchmark_out=results.json] ...
+// without a model a ~1M triangles bumpy sphere is generated, so the benchmark runs anywhere.
+
+#include <glm/glm.hpp>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include <learnopengl/mesh_optimizer.h>
+#include <learnopengl/mesh_cluster.h>
+
+#include "benchmark.h"
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+struct BenchVertex {
+    glm::vec3 Position;
+    glm::vec3 Normal;
+};
+
+struct BenchPlane {
+    glm::vec3 normal;
+    float     distance;
+};
+
+// same construction as createFrustumFromCamera in entity.h, without the Camera class
+static void buildFrustum(const glm::vec3 &position, const glm::vec3 &front, float aspect, float fovY, float zNear, float zFar,
+                         BenchPlane planes[6])
+{
+    const glm::vec3 right = glm::normalize(glm::cross(front, glm::vec3(0.0f, 1.0f, 0.0f)));
+    const glm::vec3 up = glm::normalize(glm::cross(right, front));
+    const float halfVSide = zFar * tanf(fovY * 0.5f);
+    const float halfHSide = halfVSide * aspect;
+    const glm::vec3 frontMultFar = zFar * front;
+
+    glm::vec3 points[6] = { position + zNear * front, position + frontMultFar, position, position, position, position };
+    glm::vec3 normals[6] = {
+        front,
+        -front,
+        glm::cross(frontMultFar - right * halfHSide, up),
+        glm::cross(up, frontMultFar + right * halfHSide),
+        glm::cross(right, frontMultFar - up * halfVSide),
+        glm::cross(frontMultFar + up * halfVSide, right)
+    };
+    for(int i = 0; i < 6; i++)
+    {
+        planes[i].normal = glm::normalize(normals[i]);
+        planes[i].distance = glm::dot(planes[i].normal, points[i]);
+    }
+}
+
+// a sphere with some low frequency bumps, so the clusters don't all have the same curvature
+static void generateSphere(unsigned int slices, unsigned int stacks, vector<BenchVertex> &vertices, vector<unsigned int> &indices)
+{
+    const float pi = 3.14159265358979f;
+    for(unsigned int y = 0; y <= stacks; y++)
+        for(unsigned int x = 0; x <= slices; x++)
+        {
+            float theta = float(y) / float(stacks) * pi;
+            float phi = float(x) / float(slices) * 2.0f * pi;
+            glm::vec3 direction(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi));
+            float bump = 1.0f + 0.05f * sinf(6.0f * theta) * cosf(5.0f * phi);
+            BenchVertex vertex = { direction * bump, direction };
+            vertices.push_back(vertex);
+        }
+    for(unsigned int y = 0; y < stacks; y++)
+        for(unsigned int x = 0; x < slices; x++)
+        {
+            unsigned int a = y * (slices + 1) + x, b = a + slices + 1;
+            unsigned int quad[6] = { a, b, a + 1, a + 1, b, b + 1 };
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+}
+
+static bool loadModel(const string &path, vector<BenchVertex> &vertices, vector<unsigned int> &indices)
+{
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_PreTransformVertices);
+    if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+    {
+        cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << endl;
+        return false;
+    }
+    // all the meshes merged into one, the benchmark only cares about the geometry
+    for(unsigned int m = 0; m < scene->mNumMeshes; m++)
+    {
+        const aiMesh *mesh = scene->mMeshes[m];
+        unsigned int base = static_cast<unsigned int>(vertices.size());
+        for(unsigned int i = 0; i < mesh->mNumVertices; i++)
+        {
+            BenchVertex vertex;
+            vertex.Position = glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+            vertex.Normal = mesh->HasNormals() ? glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z) : glm::vec3(0.0f);
+            vertices.push_back(vertex);
+        }
+        for(unsigned int i = 0; i < mesh->mNumFaces; i++)
+            for(unsigned int j = 0; j < mesh->mFaces[i].mNumIndices; j++)
+                indices.push_back(base + mesh->mFaces[i].mIndices[j]);
+    }
+    return !indices.empty();
+}
+
+// the mesh every benchmark runs on, loaded (or generated) once by main
+struct BenchMesh {
+    string source;
+    vector<BenchVertex> vertices;
+    vector<unsigned int> indices;        // as imported
+    vector<unsigned int> optimized;      // after optimizeVertexCache, what the clusters are built from
+    vector<MeshCluster> clusters;
+};
+
+static BenchMesh benchMesh;
+
+// the camera positions of one orbit, an iteration of the culling benchmark
+const unsigned int ORBIT_FRAMES = 240;
+
+static void BM_OptimizeVertexCache(benchmark::State& state)
+{
+    vector<unsigned int> indices;
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        indices = benchMesh.indices;
+        state.ResumeTiming();
+        optimizeVertexCache(indices, benchMesh.vertices.size());
+        benchmark::DoNotOptimize(indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (benchMesh.indices.size() / 3));
+}
+BENCHMARK(BM_OptimizeVertexCache)->Unit(benchmark::kMillisecond);
+
+static void BM_BuildClusters(benchmark::State& state)
+{
+    vector<MeshCluster> clusters;
+    for(auto _ : state)
+    {
+        clusters = buildClusters(benchMesh.vertices, benchMesh.optimized);
+        benchmark::DoNotOptimize(clusters.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (benchMesh.optimized.size() / 3));
+    state.counters["clusters"] = static_cast<double>(clusters.size());
+    state.counters["triangles_per_cluster"] = clusters.empty() ? 0.0 : double(benchMesh.optimized.size() / 3) / clusters.size();
+}
+BENCHMARK(BM_BuildClusters)->Unit(benchmark::kMillisecond);
+
+// one orbit per iteration, cull + compaction every frame: the camera moves from right on the surface (most
+// clusters outside the frustum) to far away (only backfaces culled), always looking at the center of the mesh
+static void BM_CullClusters(benchmark::State& state)
+{
+    const vector<BenchVertex> &vertices = benchMesh.vertices;
+    glm::vec3 minPos = vertices[0].Position, maxPos = minPos;
+    for(unsigned int i = 1; i < vertices.size(); i++)
+    {
+        minPos = glm::min(minPos, vertices[i].Position);
+        maxPos = glm::max(maxPos, vertices[i].Position);
+    }
+    const glm::vec3 center = (minPos + maxPos) * 0.5f;
+    const float size = glm::length(maxPos - minPos);
+    const glm::mat4 model(1.0f);
+
+    // the frusta are set up outside of the measured loop
+    vector<glm::vec3> positions(ORBIT_FRAMES);
+    vector<BenchPlane> planes(ORBIT_FRAMES * 6);
+    for(unsigned int frame = 0; frame < ORBIT_FRAMES; frame++)
+    {
+        float angle = float(frame) / float(ORBIT_FRAMES) * 6.2831853f;
+        float distance = size * (0.35f + 0.9f * (0.5f + 0.5f * sinf(angle * 3.0f)));
+        positions[frame] = center + distance * glm::vec3(cosf(angle), 0.3f, sinf(angle));
+        buildFrustum(positions[frame], glm::normalize(center - positions[frame]), 16.0f / 9.0f, glm::radians(45.0f), 0.1f,
+                     100.0f * size, &planes[frame * 6]);
+    }
+
+    ClusterCullStats stats;
+    vector<unsigned int> visibleIndices;
+    visibleIndices.reserve(benchMesh.optimized.size());
+    for(auto _ : state)
+    {
+        stats = ClusterCullStats();
+        for(unsigned int frame = 0; frame < ORBIT_FRAMES; frame++)
+        {
+            const BenchPlane *frustum = &planes[frame * 6];
+            visibleIndices.clear();
+            cullClusters(benchMesh.clusters, benchMesh.optimized, model, positions[frame],
+                         [frustum](const glm::vec3 &c, float r)
+                         {
+                             for(int i = 0; i < 6; i++)
+                                 if(glm::dot(frustum[i].normal, c) - frustum[i].distance <= -r)
+                                     return false;
+                             return true;
+                         },
+                         visibleIndices, &stats);
+            benchmark::DoNotOptimize(visibleIndices.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * ORBIT_FRAMES * benchMesh.clusters.size());
+    if(stats.clusters > 0)
+    {
+        state.counters["frustum_culled"] = double(stats.frustumCulled) / stats.clusters;
+        state.counters["backface_culled"] = double(stats.backfaceCulled) / stats.clusters;
+        state.counters["triangles_drawn"] = double(stats.visibleTriangles) / stats.triangles;
+    }
+}
+BENCHMARK(BM_CullClusters)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+    benchMesh.source = "generated sphere";
+    if(argc > 1)
+    {
+        benchMesh.source = argv[1];
+        if(!loadModel(benchMesh.source, benchMesh.vertices, benchMesh.indices))
+            return 1;
+    }
+    else
+        generateSphere(1024, 512, benchMesh.vertices, benchMesh.indices);
+    cout << "cluster_culling_bench: " << benchMesh.source << ", " << benchMesh.vertices.size() << " vertices, "
+         << benchMesh.indices.size() / 3 << " triangles" << endl;
+
+    // same import pipeline as Model: cache optimization first, clusters last
+    benchMesh.optimized = benchMesh.indices;
+    optimizeVertexCache(benchMesh.optimized, benchMesh.vertices.size());
+    benchMesh.clusters = buildClusters(benchMesh.vertices, benchMesh.optimized);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
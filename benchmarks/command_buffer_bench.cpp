@@ -0,0 +1,78 @@
+// Command recording benchmark: CommandRecorder::record on N generated objects with T threads. Each object is
+// tested against a sphere, gets its model and normal matrices packed in a uniform block and a draw; nothing is
+// submitted, so no OpenGL context is needed. Compare the wall times of the same N for 1, 2, 4 and 8 threads.
+//
+// usage: command_buffer_bench [--benchmark_filter=REGEX] [--benchmark_out=results.json] ...
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <learnopengl/command_buffer.h>
+
+#include "benchmark.h"
+#include "scene_generators.h"
+
+#include <vector>
+
+struct BenchObject {
+    glm::vec3 position;
+    glm::vec3 axis;
+    float angle;
+    GLuint vertexArray;
+    GLuint firstIndex;
+};
+
+// the std140 block of the vertex shader
+struct BenchObjectBlock {
+    glm::mat4 model;
+    glm::mat4 normal;
+};
+
+// N objects, T threads
+static void BM_CommandRecord(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+    const unsigned int threads = static_cast<unsigned int>(state.range(1));
+    SceneRandom random;
+    std::vector<BenchObject> objects(count);
+    for(size_t i = 0; i < count; i++)
+    {
+        objects[i].position = random.nextVec3(-100.0f, 100.0f);
+        objects[i].axis = glm::normalize(random.nextVec3(0.1f, 1.0f));
+        objects[i].angle = random.next(0.0f, 6.28f);
+        objects[i].vertexArray = 1 + static_cast<GLuint>(i % 8);
+        objects[i].firstIndex = static_cast<GLuint>(i % 64) * 36;
+    }
+
+    CommandRecorder recorder(threads);
+    size_t recorded = 0;
+    for(auto _ : state)
+    {
+        recorder.record(count, [&](CommandBuffer &commands, size_t begin, size_t end) {
+            commands.useProgram(1);
+            for(size_t i = begin; i < end; i++)
+            {
+                const BenchObject &object = objects[i];
+                if(glm::length(object.position) > 150.0f)
+                    continue;
+                BenchObjectBlock block;
+                block.model = glm::rotate(glm::translate(glm::mat4(1.0f), object.position), object.angle, object.axis);
+                block.normal = glm::transpose(glm::inverse(block.model));
+                commands.bindVertexArray(object.vertexArray);
+                commands.uniformBlock(0, block);
+                commands.drawElements(GL_TRIANGLES, 36, object.firstIndex);
+            }
+        });
+        recorded = 0;
+        for(size_t b = 0; b < recorder.buffers().size(); b++)
+            recorded += recorder.buffers()[b].recorded().size();
+        benchmark::DoNotOptimize(recorded);
+    }
+    state.counters["commands"] = static_cast<double>(recorded);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_CommandRecord)->Args({10000, 1})->Args({10000, 2})->Args({10000, 4})->Args({10000, 8})
+                           ->Args({100000, 1})->Args({100000, 4})->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,78 @@
+// Frame graph benchmark: FrameGraph::compile on generated post-processing chains of N passes, every third one
+// with a debug branch that nothing reads. compile() doesn't call OpenGL, so no context is needed.
+//
+// usage: frame_graph_bench [--benchmark_filter=REGEX] [--benchmark_out=results.json] ...
+
+#include <glad/glad.h>
+
+#include <learnopengl/frame_graph.h>
+
+#include "benchmark.h"
+
+#include <string>
+
+// scene -> N post passes ping-ponging between full screen targets -> screen, plus dead debug passes
+static void buildChain(FrameGraph &graph, unsigned int passes)
+{
+    const FrameGraphTextureDesc hdr(1920, 1080, GL_RGBA16F);
+    FrameGraphResource screen = graph.importFramebuffer("screen", 0, 1920, 1080);
+    FrameGraphResource color = FRAME_GRAPH_INVALID;
+    FrameGraphResource depth = FRAME_GRAPH_INVALID;
+    graph.addPass("scene",
+        [&](FrameGraphBuilder &builder) {
+            color = builder.create("scene color", hdr);
+            depth = builder.create("scene depth", FrameGraphTextureDesc(1920, 1080, GL_DEPTH24_STENCIL8));
+        },
+        [](const FrameGraphPassResources &) {});
+    for(unsigned int i = 0; i < passes; i++)
+    {
+        const std::string name = "post" + std::to_string(i);
+        FrameGraphResource input = color;
+        graph.addPass(name,
+            [&](FrameGraphBuilder &builder) {
+                builder.read(input);
+                builder.read(depth);
+                color = builder.create(name, hdr);
+            },
+            [](const FrameGraphPassResources &) {});
+        if(i % 3 == 0)
+            graph.addPass("debug" + std::to_string(i),
+                [&](FrameGraphBuilder &builder) {
+                    builder.read(input);
+                    builder.create("debug", FrameGraphTextureDesc(1920, 1080, GL_RGBA8));
+                },
+                [](const FrameGraphPassResources &) {});
+    }
+    FrameGraphResource last = color;
+    graph.addPass("present",
+        [&](FrameGraphBuilder &builder) {
+            builder.read(last);
+            builder.write(screen);
+        },
+        [](const FrameGraphPassResources &) {});
+}
+
+// the graph is declared again every frame, as it would be when the passes depend on settings
+static void BM_FrameGraphCompile(benchmark::State& state)
+{
+    const unsigned int passes = static_cast<unsigned int>(state.range(0));
+    FrameGraph graph;
+    for(auto _ : state)
+    {
+        graph.clear();
+        buildChain(graph, passes);
+        bool ok = graph.compile();
+        benchmark::DoNotOptimize(ok);
+    }
+    size_t culled = 0;
+    for(unsigned int p = 0; p < graph.passCount(); p++)
+        culled += graph.isCulled(p) ? 1 : 0;
+    state.counters["kept"] = static_cast<double>(graph.passOrder().size());
+    state.counters["culled"] = static_cast<double>(culled);
+    state.counters["textures"] = static_cast<double>(graph.physicalCount());
+    state.counters["MiB_saved"] = static_cast<double>(graph.transientBytes() - graph.physicalBytes()) / (1024.0 * 1024.0);
+    state.SetItemsProcessed(state.iterations() * (passes + 2));
+}
+BENCHMARK(BM_FrameGraphCompile)->Arg(8)->Arg(64)->Arg(512)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,40 @@
+// A GL 3.3 core context for the benchmarks and tools that need one: a hidden window, or with headless GLFW's null
+// platform with an OSMesa context (see headless.h).
+
+#ifndef GL_CONTEXT_H
+#define GL_CONTEXT_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// nullptr when there's no context to be had
+inline GLFWwindow* createBenchmarkContext(const char* title, bool headless, int width = 64, int height = 64)
+{
+    if(headless)
+    {
+#ifdef GLFW_PLATFORM_NULL
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
+    }
+    if(!glfwInit())
+        return nullptr;
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef GLFW_PLATFORM_NULL
+    if(headless)
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+#endif
+    GLFWwindow* window = glfwCreateWindow(width, height, title, NULL, NULL);
+    if(window == NULL)
+        return nullptr;
+    glfwMakeContextCurrent(window);
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+        return nullptr;
+    return window;
+}
+#endif
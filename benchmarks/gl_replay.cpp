@@ -0,0 +1,83 @@
+// Replays a GL trace written with --gl-trace (see learnopengl/gl_trace.h) and times its frames: the GL cost of an
+// exercise without its CPU side, e.g. to compare drivers or to check what removing redundant calls buys.
+//
+// usage: gl_replay FILE [--headless] [--repeat N]
+//
+// Frame 0 (the setup) is played once, then every frame N times, each one waited for with glFinish.
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <learnopengl/gl_trace.h>
+
+#include "gl_context.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv)
+{
+    std::string path;
+    bool headless = false;
+    int repeat = 1;
+    for(int i = 1; i < argc; i++)
+    {
+        if(std::strcmp(argv[i], "--headless") == 0)
+            headless = true;
+        else if(std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = std::max(1, std::atoi(argv[++i]));
+        else
+            path = argv[i];
+    }
+    if(path.empty())
+    {
+        std::cout << "usage: gl_replay FILE [--headless] [--repeat N]" << std::endl;
+        return 1;
+    }
+
+    if(!createBenchmarkContext("gl_replay", headless))
+    {
+        std::cout << "ERROR::GL_REPLAY:: no OpenGL context" << std::endl;
+        glfwTerminate();
+        return 1;
+    }
+    std::cout << "gl_replay: " << glGetString(GL_RENDERER) << std::endl;
+
+    GLTraceReplay replay;
+    if(!replay.load(path) || replay.frameCount() == 0)
+    {
+        glfwTerminate();
+        return 1;
+    }
+    replay.playFrame(0);
+    glFinish();
+
+    size_t frames = 0, calls = 0;
+    double total = 0.0, fastest = 0.0, slowest = 0.0;
+    for(int r = 0; r < repeat; r++)
+    {
+        for(size_t f = 1; f < replay.frameCount(); f++)
+        {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            replay.playFrame(f);
+            glFinish();
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            fastest = frames == 0 ? ms : std::min(fastest, ms);
+            slowest = std::max(slowest, ms);
+            total += ms;
+            calls += replay.callCount(f);
+            frames++;
+        }
+    }
+    if(frames > 0)
+        std::cout << "gl_replay: " << frames << " frames, " << calls / frames << " calls/frame, " << total / frames
+                  << " ms/frame (min " << fastest << ", max " << slowest << ")" << std::endl;
+    if(glGetError() != GL_NO_ERROR)
+        std::cout << "ERROR::GL_REPLAY:: the replay raised GL errors" << std::endl;
+    glfwTerminate();
+    return 0;
+}
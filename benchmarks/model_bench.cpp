@@ -0,0 +1,219 @@
+// OpenGL benchmarks: Model::loadModel (import and upload of generated grids), Model::Draw with the full and the
+// compact vertex layouts, IndirectDrawList::submit of a scene of batched models, and Shader::setMat4. They need a context: a hidden window, or with --headless GLFW's
+// null platform with an OSMesa context (see headless.h). Without one they are reported as errors.
+// The draws use resources/shaders/model.vs, so run it from the bin directory.
+//
+// usage: model_bench [--headless] [--benchmark_filter=REGEX] [--benchmark_out=results.json] ...
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <learnopengl/camera.h>
+#include <learnopengl/model.h>
+#include <learnopengl/entity.h>
+
+#include "benchmark.h"
+#include "gl_context.h"
+#include "scene_generators.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+static bool contextAvailable = false;
+
+static std::string gridPath(unsigned int triangles)
+{
+    return "model_bench_grid_" + std::to_string(triangles) + ".obj";
+}
+
+// a grid of T triangles, imported and uploaded by the Model constructor every iteration
+static void BM_ModelLoadModel(benchmark::State& state)
+{
+    if(!contextAvailable)
+    {
+        state.SkipWithError("no OpenGL context");
+        return;
+    }
+    const unsigned int triangles = static_cast<unsigned int>(state.range(0));
+    const std::string path = gridPath(triangles);
+    if(!writeGridObj(path, triangles))
+    {
+        state.SkipWithError("can't write the grid");
+        return;
+    }
+
+    for(auto _ : state)
+    {
+        std::unique_ptr<Model> model(new Model(path));
+        benchmark::DoNotOptimize(model->meshes.data());
+        // the meshes free their buffers with the model, outside of the measured import
+        state.PauseTiming();
+        model.reset();
+        glFinish();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * triangles);
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_ModelLoadModel)->Arg(2048)->Arg(32768)->Arg(262144)->Unit(benchmark::kMillisecond);
+
+// a 32768 triangles grid stored with the given vertex layout, drawn with the model shader (which decodes the
+// compact layouts through vertex_layout.glsl) until the GPU is done with it
+static void BM_ModelDraw(benchmark::State& state)
+{
+    if(!contextAvailable)
+    {
+        state.SkipWithError("no OpenGL context");
+        return;
+    }
+    if(!std::ifstream("resources/shaders/model.vs"))
+    {
+        state.SkipWithError("resources/shaders/model.vs not found, run from the bin directory");
+        return;
+    }
+    const unsigned int triangles = 32768;
+    const std::string path = gridPath(triangles);
+    if(!writeGridObj(path, triangles))
+    {
+        state.SkipWithError("can't write the grid");
+        return;
+    }
+    const VertexLayout layout = static_cast<VertexLayout>(state.range(0));
+    Model model(path, false, ModelImportOptions(layout));
+    std::remove(path.c_str());
+    Shader shader("resources/shaders/model.vs", "resources/shaders/model.fs", vertexLayoutDefines(layout));
+    shader.use();
+    shader.setMat4("model", glm::mat4(1.0f));
+    shader.setMat4("view", glm::mat4(1.0f));
+    shader.setMat4("projection", glm::mat4(1.0f));
+
+    for(auto _ : state)
+    {
+        model.Draw(shader);
+        glFinish();
+    }
+    state.SetItemsProcessed(state.iterations() * triangles);
+    glDeleteProgram(shader.ID);
+}
+BENCHMARK(BM_ModelDraw)->Arg(VERTEX_LAYOUT_FULL)->Arg(VERTEX_LAYOUT_COMPACT)->Unit(benchmark::kMicrosecond);
+
+// N entities sharing a batched 2048 triangles grid: culled and collected into an IndirectDrawList, then submitted
+// with the instanced model shader, as one glMultiDrawElementsIndirect (multi = 1, GL 4.3) or as the fallback loop
+// of per-instance draws (multi = 0)
+static void BM_ModelDrawIndirect(benchmark::State& state)
+{
+    if(!contextAvailable)
+    {
+        state.SkipWithError("no OpenGL context");
+        return;
+    }
+    const unsigned int entities = static_cast<unsigned int>(state.range(0));
+    const bool multiDraw = state.range(1) != 0;
+    if(multiDraw && !hasMultiDrawIndirect())
+    {
+        state.SkipWithError("no multi-draw-indirect");
+        return;
+    }
+    if(!std::ifstream("resources/shaders/model.vs"))
+    {
+        state.SkipWithError("resources/shaders/model.vs not found, run from the bin directory");
+        return;
+    }
+    const std::string path = gridPath(2048);
+    if(!writeGridObj(path, 2048))
+    {
+        state.SkipWithError("can't write the grid");
+        return;
+    }
+    ModelImportOptions options;
+    options.batched = true;
+    Model model(path, false, options);
+    std::remove(path.c_str());
+
+    Entity root;
+    SceneRandom random;
+    for(unsigned int i = 0; i < entities; i++)
+    {
+        root.addChild(model);
+        root.children.back()->transform.setLocalPosition(random.nextVec3(-20.0f, 20.0f));
+        root.children.back()->transform.setLocalRotation(random.nextVec3(0.0f, 360.0f));
+    }
+    root.forceUpdateSelfAndChild();
+    Camera camera(glm::vec3(0.0f, 0.0f, 30.0f));
+    const Frustum frustum = createFrustumFromCamera(camera, 1.0f, glm::radians(45.0f), 0.1f, 100.0f);
+
+    Shader shader("resources/shaders/model.vs", "resources/shaders/model.fs", std::vector<std::string>(1, "INSTANCED"));
+    shader.use();
+    shader.setMat4("view", camera.GetViewMatrix());
+    shader.setMat4("projection", glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 100.0f));
+
+    IndirectDrawList drawList;
+    unsigned int display = 0, total = 0, drawCalls = 0;
+    for(auto _ : state)
+    {
+        drawList.clear();
+        display = total = 0;
+        root.collectSelfAndChild(frustum, drawList, display, total);
+        drawList.build();
+        drawCalls = drawList.submit(shader, multiDraw);
+        glFinish();
+    }
+    state.SetItemsProcessed(state.iterations() * entities);
+    state.counters["visible"] = display;
+    state.counters["draw_calls"] = drawCalls;
+    glDeleteProgram(shader.ID);
+}
+BENCHMARK(BM_ModelDrawIndirect)->Args({1000, 0})->Args({1000, 1})->Unit(benchmark::kMicrosecond);
+
+// one uniform upload, location lookup included
+static void BM_ShaderSetMat4(benchmark::State& state)
+{
+    if(!contextAvailable)
+    {
+        state.SkipWithError("no OpenGL context");
+        return;
+    }
+    if(!writeBenchmarkShaders("model_bench.vs", "model_bench.fs"))
+    {
+        state.SkipWithError("can't write the shaders");
+        return;
+    }
+    Shader shader("model_bench.vs", "model_bench.fs");
+    shader.use();
+
+    glm::mat4 matrices[2] = { glm::mat4(1.0f), glm::mat4(2.0f) };
+    unsigned int i = 0;
+    for(auto _ : state)
+        shader.setMat4("model", matrices[i++ & 1]);
+    glFinish();
+    state.SetItemsProcessed(state.iterations());
+    glDeleteProgram(shader.ID);
+    std::remove("model_bench.vs");
+    std::remove("model_bench.fs");
+}
+BENCHMARK(BM_ShaderSetMat4);
+
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    bool headless = false;
+    for(int i = 1; i < argc; i++)
+        headless = headless || std::strcmp(argv[i], "--headless") == 0;
+
+    contextAvailable = createBenchmarkContext("model_bench", headless) != nullptr;
+    if(contextAvailable)
+        std::cout << "model_bench: " << glGetString(GL_RENDERER) << std::endl;
+    else
+        std::cout << "model_bench: no OpenGL context, the benchmarks are skipped" << std::endl;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    glfwTerminate();
+    return 0;
+}
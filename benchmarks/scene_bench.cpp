@@ -0,0 +1,87 @@
+// Scene graph benchmarks: transform propagation (Entity::updateSelfAndChild) and frustum tests
+// (AABB::isOnFrustum) on generated scenes, no OpenGL context needed.
+//
+// usage: scene_bench [--benchmark_filter=REGEX] [--benchmark_out=results.json] ...
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <learnopengl/camera.h>
+#include <learnopengl/model.h>
+#include <learnopengl/entity.h>
+
+#include "benchmark.h"
+#include "scene_generators.h"
+
+#include <vector>
+
+// N entities, D levels: every frame the root moves, so the whole tree is recomputed
+static void BM_EntityUpdateSelfAndChild(benchmark::State& state)
+{
+    const unsigned int count = static_cast<unsigned int>(state.range(0));
+    Entity root;
+    buildEntityTree(root, count, static_cast<unsigned int>(state.range(1)));
+    root.updateSelfAndChild();
+
+    float angle = 0.0f;
+    for(auto _ : state)
+    {
+        angle += 1.0f;
+        root.transform.setLocalRotation(glm::vec3(0.0f, angle, 0.0f));
+        root.updateSelfAndChild();
+        benchmark::DoNotOptimize(root.children.back()->transform.getModelMatrix());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_EntityUpdateSelfAndChild)->Args({1000, 2})->Args({1000, 8})->Args({10000, 4})->Args({100000, 4})->Unit(benchmark::kMicrosecond);
+
+// same scenes with nothing dirty: the cost of walking the tree to find out
+static void BM_EntityUpdateSelfAndChildClean(benchmark::State& state)
+{
+    const unsigned int count = static_cast<unsigned int>(state.range(0));
+    Entity root;
+    buildEntityTree(root, count, static_cast<unsigned int>(state.range(1)));
+    root.updateSelfAndChild();
+
+    for(auto _ : state)
+    {
+        root.updateSelfAndChild();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_EntityUpdateSelfAndChildClean)->Args({1000, 2})->Args({10000, 4})->Args({100000, 4})->Unit(benchmark::kMicrosecond);
+
+// N boxes scattered around a camera, each tested against its frustum with its own transform
+static void BM_AABBIsOnFrustum(benchmark::State& state)
+{
+    const unsigned int count = static_cast<unsigned int>(state.range(0));
+    SceneRandom random;
+    std::vector<AABB> boxes;
+    std::vector<Transform> transforms(count);
+    for(unsigned int i = 0; i < count; i++)
+    {
+        boxes.push_back(AABB(glm::vec3(-0.5f), glm::vec3(0.5f)));
+        transforms[i].setLocalPosition(random.nextVec3(-100.0f, 100.0f));
+        transforms[i].setLocalRotation(random.nextVec3(0.0f, 360.0f));
+        transforms[i].setLocalScale(glm::vec3(random.next(0.5f, 4.0f)));
+        transforms[i].computeModelMatrix();
+    }
+    Camera camera(glm::vec3(0.0f, 0.0f, 0.0f));
+    const Frustum frustum = createFrustumFromCamera(camera, 800.0f / 600.0f, glm::radians(45.0f), 0.1f, 100.0f);
+
+    unsigned int visible = 0;
+    for(auto _ : state)
+    {
+        visible = 0;
+        for(unsigned int i = 0; i < count; i++)
+            visible += boxes[i].isOnFrustum(frustum, transforms[i]) ? 1 : 0;
+        benchmark::DoNotOptimize(visible);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.counters["visible"] = static_cast<double>(visible) / count;
+}
+BENCHMARK(BM_AABBIsOnFrustum)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,186 @@
+// Synthetic workloads for the benchmarks: generated from a fixed seed, so every run (and every machine) measures
+// the same scene and the results can be compared over time.
+
+#ifndef SCENE_GENERATORS_H
+#define SCENE_GENERATORS_H
+
+#include <glm/glm.hpp>
+
+#include <assimp/scene.h>
+
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// small LCG, the same sequence on every platform (unlike std::rand or the distributions of <random>)
+struct SceneRandom {
+    uint32_t state;
+
+    explicit SceneRandom(uint32_t seed = 12345u) : state(seed) {}
+
+    float next(float low, float high)
+    {
+        state = state * 1664525u + 1013904223u;
+        return low + (high - low) * static_cast<float>(state >> 8) / 16777216.0f;
+    }
+
+    glm::vec3 nextVec3(float low, float high)
+    {
+        float x = next(low, high);
+        float y = next(low, high);
+        return glm::vec3(x, y, next(low, high));
+    }
+};
+
+// the smallest number of children per node for `count` nodes to fit in `depth` levels below the root
+inline unsigned int sceneFanout(unsigned int count, unsigned int depth)
+{
+    for(unsigned int fanout = 1;; fanout++)
+    {
+        unsigned long long total = 1, level = 1;
+        for(unsigned int d = 0; d < depth && total < count; d++)
+        {
+            level *= fanout;
+            total += level;
+        }
+        if(total >= count || depth == 0)
+            return fanout;
+    }
+}
+
+// fills root with a tree of `count` entities (root included) at most `depth` levels deep, built breadth first
+// with the same number of children per node. EntityType needs a default constructor, addChild() and transform.
+template <typename EntityType>
+void buildEntityTree(EntityType &root, unsigned int count, unsigned int depth, uint32_t seed = 12345u)
+{
+    SceneRandom random(seed);
+    const unsigned int fanout = sceneFanout(count, depth);
+    std::deque<std::pair<EntityType*, unsigned int> > open(1, std::make_pair(&root, 0u));
+    unsigned int created = 1;
+    while(created < count && !open.empty())
+    {
+        EntityType* parent = open.front().first;
+        unsigned int level = open.front().second;
+        open.pop_front();
+        if(level >= depth)
+            continue;
+        for(unsigned int i = 0; i < fanout && created < count; i++, created++)
+        {
+            parent->addChild();
+            EntityType* child = parent->children.back().get();
+            child->transform.setLocalPosition(random.nextVec3(-10.0f, 10.0f));
+            child->transform.setLocalRotation(random.nextVec3(0.0f, 360.0f));
+            child->transform.setLocalScale(glm::vec3(random.next(0.5f, 1.5f)));
+            open.push_back(std::make_pair(child, level + 1));
+        }
+    }
+}
+
+// a skeleton of `bones` nodes named "bone0".."boneN" (up to 3 children each, breadth first) with one animation
+// of `keys` position/rotation/scale keyframes per bone. The scene owns everything, delete it when done.
+inline aiScene* generateSkeletonScene(unsigned int bones, unsigned int keys, uint32_t seed = 12345u)
+{
+    SceneRandom random(seed);
+    aiScene* scene = new aiScene();
+
+    std::vector<aiNode*> nodes;
+    std::vector<std::vector<aiNode*> > children(bones);
+    for(unsigned int i = 0; i < bones; i++)
+    {
+        nodes.push_back(new aiNode("bone" + std::to_string(i)));
+        if(i > 0)
+        {
+            nodes[i]->mParent = nodes[(i - 1) / 3];
+            children[(i - 1) / 3].push_back(nodes[i]);
+        }
+    }
+    for(unsigned int i = 0; i < bones; i++)
+    {
+        if(children[i].empty())
+            continue;
+        nodes[i]->mNumChildren = static_cast<unsigned int>(children[i].size());
+        nodes[i]->mChildren = new aiNode*[children[i].size()];
+        for(unsigned int c = 0; c < children[i].size(); c++)
+            nodes[i]->mChildren[c] = children[i][c];
+    }
+    scene->mRootNode = nodes.empty() ? new aiNode("root") : nodes[0];
+
+    aiAnimation* animation = new aiAnimation();
+    animation->mDuration = keys > 1 ? keys - 1 : 1;
+    animation->mTicksPerSecond = 25.0;
+    animation->mNumChannels = bones;
+    animation->mChannels = new aiNodeAnim*[bones];
+    for(unsigned int i = 0; i < bones; i++)
+    {
+        aiNodeAnim* channel = new aiNodeAnim();
+        channel->mNodeName = aiString("bone" + std::to_string(i));
+        channel->mNumPositionKeys = channel->mNumRotationKeys = channel->mNumScalingKeys = keys;
+        channel->mPositionKeys = new aiVectorKey[keys];
+        channel->mRotationKeys = new aiQuatKey[keys];
+        channel->mScalingKeys = new aiVectorKey[keys];
+        glm::vec3 offset = random.nextVec3(-1.0f, 1.0f);
+        aiVector3D axis(random.next(-1.0f, 1.0f), random.next(0.1f, 1.0f), random.next(-1.0f, 1.0f));
+        axis.Normalize();
+        for(unsigned int k = 0; k < keys; k++)
+        {
+            float t = static_cast<float>(k);
+            channel->mPositionKeys[k].mTime = t;
+            channel->mPositionKeys[k].mValue = aiVector3D(offset.x, offset.y + 0.1f * std::sin(t), offset.z);
+            channel->mRotationKeys[k].mTime = t;
+            channel->mRotationKeys[k].mValue = aiQuaternion(axis, 0.2f * t);
+            channel->mScalingKeys[k].mTime = t;
+            channel->mScalingKeys[k].mValue = aiVector3D(1.0f, 1.0f, 1.0f);
+        }
+        animation->mChannels[i] = channel;
+    }
+    scene->mNumAnimations = 1;
+    scene->mAnimations = new aiAnimation*[1];
+    scene->mAnimations[0] = animation;
+    return scene;
+}
+
+// writes a flat grid of about `triangles` triangles (with normals and texture coordinates) as a Wavefront OBJ
+inline bool writeGridObj(const std::string &path, unsigned int triangles)
+{
+    std::ofstream file(path.c_str());
+    if(!file)
+        return false;
+    unsigned int side = 1;
+    while(2u * side * side < triangles)
+        side++;
+    for(unsigned int y = 0; y <= side; y++)
+        for(unsigned int x = 0; x <= side; x++)
+        {
+            float u = static_cast<float>(x) / side, v = static_cast<float>(y) / side;
+            file << "v " << u * 2.0f - 1.0f << " 0 " << v * 2.0f - 1.0f << "\n";
+            file << "vt " << u << " " << v << "\n";
+        }
+    file << "vn 0 1 0\n";
+    for(unsigned int y = 0; y < side; y++)
+        for(unsigned int x = 0; x < side; x++)
+        {
+            // OBJ indices start at 1
+            unsigned int a = y * (side + 1) + x + 1, b = a + side + 1;
+            file << "f " << a << "/" << a << "/1 " << b << "/" << b << "/1 " << a + 1 << "/" << a + 1 << "/1\n";
+            file << "f " << a + 1 << "/" << a + 1 << "/1 " << b << "/" << b << "/1 " << b + 1 << "/" << b + 1 << "/1\n";
+        }
+    return static_cast<bool>(file);
+}
+
+// a vertex/fragment pair with the usual model/view/projection uniforms
+inline bool writeBenchmarkShaders(const std::string &vertexPath, const std::string &fragmentPath)
+{
+    std::ofstream vertex(vertexPath.c_str());
+    vertex << "#version 330 core\n"
+              "layout (location = 0) in vec3 aPos;\n"
+              "uniform mat4 model;\nuniform mat4 view;\nuniform mat4 projection;\n"
+              "void main() { gl_Position = projection * view * model * vec4(aPos, 1.0); }\n";
+    std::ofstream fragment(fragmentPath.c_str());
+    fragment << "#version 330 core\nout vec4 FragColor;\nvoid main() { FragColor = vec4(1.0); }\n";
+    return static_cast<bool>(vertex) && static_cast<bool>(fragment);
+}
+#endif
@@ -27,13 +27,14 @@ public:
 		Assimp::Importer importer;
 		const aiScene* scene = importer.ReadFile(animationPath, aiProcess_Triangulate);
 		assert(scene && scene->mRootNode);
-		auto animation = scene->mAnimations[0];
-		m_Duration = animation->mDuration;
-		m_TicksPerSecond = animation->mTicksPerSecond;
-		aiMatrix4x4 globalTransformation = scene->mRootNode->mTransformation;
-		globalTransformation = globalTransformation.Inverse();
-		ReadHierarchyData(m_RootNode, scene->mRootNode);
-		ReadMissingBones(animation, *model);
+		Load(scene, model->GetBoneInfoMap(), model->GetBoneCount());
+	}
+
+	//From a scene already in memory (e.g. generated), bones missing from boneInfoMap are added to it
+	Animation(const aiScene* scene, std::map<std::string, BoneInfo>& boneInfoMap, int& boneCount)
+	{
+		assert(scene && scene->mRootNode);
+		Load(scene, boneInfoMap, boneCount);
 	}
 
 	~Animation()
@@ -62,12 +63,21 @@ public:
 	}
 
 private:
-	void ReadMissingBones(const aiAnimation* animation, Model& model)
+	void Load(const aiScene* scene, std::map<std::string, BoneInfo>& boneInfoMap, int& boneCount)
 	{
-		int size = animation->mNumChannels;
+		auto animation = scene->mAnimations[0];
+		m_Duration = animation->mDuration;
+		m_TicksPerSecond = animation->mTicksPerSecond;
+		aiMatrix4x4 globalTransformation = scene->mRootNode->mTransformation;
+		globalTransformation = globalTransformation.Inverse();
+		ReadHierarchyData(m_RootNode, scene->mRootNode);
+		ReadMissingBones(animation, boneInfoMap, boneCount);
+	}
 
-		auto& boneInfoMap = model.GetBoneInfoMap();//getting m_BoneInfoMap from Model class
-		int& boneCount = model.GetBoneCount(); //getting the m_BoneCounter from Model class
+	//boneInfoMap and boneCount are m_BoneInfoMap and m_BoneCounter of the Model the animation is for
+	void ReadMissingBones(const aiAnimation* animation, std::map<std::string, BoneInfo>& boneInfoMap, int& boneCount)
+	{
+		int size = animation->mNumChannels;
 
 		//reading channels(bones engaged in an animation and their keyframes)
 		for (int i = 0; i < size; i++)
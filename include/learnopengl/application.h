@@ -0,0 +1,67 @@
+#ifndef APPLICATION_H
+#define APPLICATION_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <functional>
+
+// What every exercise does around its own code: GLFW and the window, the GL functions, the viewport, the main
+// loop with its timing, headless runs and cleaning up at the end. Compiled once in the learnopengl_app library
+// (src/learnopengl/application.cpp), which every exercise links:
+//
+//     int main(int argc, char** argv)
+//     {
+//         GLFWwindow* window = Application::init(argc, argv, "LearnOpenGL", 800, 600);
+//         if (!window)
+//             return -1;
+//         ...shaders, buffers, textures...
+//         Application::onExit([=] { glDeleteVertexArrays(1, &VAO); });
+//         while (Application::beginFrame())
+//         {
+//             ...input, draw...
+//             Application::endFrame();
+//         }
+//         return Application::terminate();
+//     }
+//
+// init() takes the arguments of headless.h (--headless, --frames, --screenshot, --stats, --gl-trace, --vsync,
+// --fps-cap, --latency); that library is the translation unit compiling the PNG writer of headless.h, so the
+// exercises include this header instead of headless.h.
+class Application
+{
+public:
+    // a 3.3 core context in a window (offscreen with --headless) of the given size, with the GL functions loaded;
+    // NULL, after printing why, if GLFW, the window or the GL functions fail
+    static GLFWwindow* init(int argc, char** argv, const char* title, int width, int height);
+
+    // the window of init()
+    static GLFWwindow* window();
+
+    // --headless: nobody looks at the frames, so time can be stepped by frame for reproducible screenshots
+    static bool headless();
+
+    // the start of a frame: waits for --fps-cap and polls the events (see frame_pacing.h); false when the loop
+    // must end (window closed, Esc pressed or --frames reached)
+    static bool beginFrame();
+
+    // the end of a frame: swaps the buffers and deletes the resources released a few frames ago (see
+    // resource_manager.h). After the first frame it prints the shader cache summary (see shader_cache.h)
+    static void endFrame();
+
+    // seconds since init(), and between the starts of the last two frames
+    static double time();
+    static double deltaTime();
+
+    // the framebuffer size, following the window when it's resized
+    static int width();
+    static int height();
+
+    // cleanup run by terminate() while the context still exists, the last one registered first
+    static void onExit(const std::function<void()> &cleanup);
+
+    // the onExit() functions, the resource pools, then GLFW; returns main's exit code. GL handles owned by
+    // main's locals (see gl_handle.h) outlive the context: when they go they delete nothing
+    static int terminate();
+};
+#endif
@@ -0,0 +1,402 @@
+#ifndef COMMAND_BUFFER_H
+#define COMMAND_BUFFER_H
+
+#include <glad/glad.h>
+
+#include <learnopengl/gl_handle.h>
+#include <learnopengl/gl_state.h>
+#include <learnopengl/profiler.h>
+#include <learnopengl/render_stats.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// GL calls can only be made on the thread owning the context, but deciding what to draw (culling, sorting,
+// packing uniforms) can happen anywhere. A CommandBuffer records binds, uniform block data and draws without
+// touching GL, so worker threads can fill one each; CommandQueue then replays them on the GL thread:
+//
+//     CommandRecorder recorder;                  // worker threads, kept between frames
+//     CommandQueue queue;                        // on the GL thread, owns the uniform buffer
+//     recorder.record(objects.size(), [&](CommandBuffer &commands, size_t begin, size_t end) {
+//         for(size_t i = begin; i < end; i++)    // runs on several threads, one buffer each
+//             if(visible(objects[i]))
+//             {
+//                 commands.useProgram(shader.ID);
+//                 commands.uniformBlock(0, objects[i].uniforms);
+//                 commands.drawElements(GL_TRIANGLES, objects[i].indexCount, objects[i].firstIndex);
+//             }
+//     });
+//     queue.submit(recorder.buffers());          // GL thread, buffers in order
+//
+// The buffers are replayed in order, so the frame doesn't depend on how the threads were scheduled. Uniform
+// block data of all buffers goes to one uniform buffer with a single upload, and binds go through GLState, so
+// the state shared by consecutive commands is only set once.
+
+enum CommandType {
+    COMMAND_USE_PROGRAM,
+    COMMAND_BIND_VERTEX_ARRAY,
+    COMMAND_BIND_TEXTURE,
+    COMMAND_ENABLE,
+    COMMAND_DISABLE,
+    COMMAND_UNIFORM_BLOCK,
+    COMMAND_DRAW_ELEMENTS,
+    COMMAND_DRAW_ARRAYS
+};
+
+// one recorded command; the meaning of the fields depends on the type
+struct Command {
+    CommandType type;
+    GLenum      target;     // texture target, capability or primitive mode
+    GLuint      name;       // program, vertex array, texture or uniform block binding
+    GLuint      unit;       // texture unit
+    GLuint      first;      // first index or vertex, offset of the uniform block data in the buffer
+    GLsizei     count;      // indices or vertices, bytes of uniform block data
+    GLint       baseVertex;
+    GLsizei     instances;
+};
+
+class CommandBuffer
+{
+public:
+    void clear()
+    {
+        commands.clear();
+        data.clear();
+    }
+
+    bool empty() const
+    {
+        return commands.empty();
+    }
+
+    void useProgram(GLuint program)
+    {
+        push(COMMAND_USE_PROGRAM, 0, program);
+    }
+
+    void bindVertexArray(GLuint vertexArray)
+    {
+        push(COMMAND_BIND_VERTEX_ARRAY, 0, vertexArray);
+    }
+
+    void bindTexture(GLuint unit, GLenum target, GLuint texture)
+    {
+        push(COMMAND_BIND_TEXTURE, target, texture).unit = unit;
+    }
+
+    void enable(GLenum capability)
+    {
+        push(COMMAND_ENABLE, capability, 0);
+    }
+
+    void disable(GLenum capability)
+    {
+        push(COMMAND_DISABLE, capability, 0);
+    }
+
+    // copies size bytes to the buffer; the draws after it see them in the uniform block bound to binding
+    void uniformBlock(GLuint binding, const void* bytes, size_t size)
+    {
+        Command &command = push(COMMAND_UNIFORM_BLOCK, 0, binding);
+        command.first = static_cast<GLuint>(data.size());
+        command.count = static_cast<GLsizei>(size);
+        data.insert(data.end(), static_cast<const unsigned char*>(bytes), static_cast<const unsigned char*>(bytes) + size);
+    }
+
+    // a std140 struct
+    template<typename T>
+    void uniformBlock(GLuint binding, const T &block)
+    {
+        uniformBlock(binding, &block, sizeof(T));
+    }
+
+    // unsigned int indices of the bound vertex array, starting at firstIndex
+    void drawElements(GLenum mode, GLsizei count, GLuint firstIndex = 0, GLint baseVertex = 0, GLsizei instances = 1)
+    {
+        Command &command = push(COMMAND_DRAW_ELEMENTS, mode, 0);
+        command.first = firstIndex;
+        command.count = count;
+        command.baseVertex = baseVertex;
+        command.instances = instances;
+    }
+
+    void drawArrays(GLenum mode, GLuint first, GLsizei count, GLsizei instances = 1)
+    {
+        Command &command = push(COMMAND_DRAW_ARRAYS, mode, 0);
+        command.first = first;
+        command.count = count;
+        command.instances = instances;
+    }
+
+    const std::vector<Command>& recorded() const
+    {
+        return commands;
+    }
+
+    const std::vector<unsigned char>& blockData() const
+    {
+        return data;
+    }
+
+private:
+    std::vector<Command> commands;
+    std::vector<unsigned char> data;
+
+    Command& push(CommandType type, GLenum target, GLuint name)
+    {
+        Command command;
+        command.type = type;
+        command.target = target;
+        command.name = name;
+        command.unit = 0;
+        command.first = 0;
+        command.count = 0;
+        command.baseVertex = 0;
+        command.instances = 1;
+        commands.push_back(command);
+        return commands.back();
+    }
+};
+
+// Worker threads recording into one CommandBuffer each. The threads are started once and wait between calls;
+// the calling thread records the first buffer itself.
+class CommandRecorder
+{
+public:
+    typedef std::function<void(CommandBuffer&, size_t, size_t)> Record;
+
+    // 0 threads: one per core
+    explicit CommandRecorder(unsigned int threads = 0)
+        : generation(0), pending(0), stopping(false), items(0)
+    {
+        if(threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        commandBuffers.resize(threads);
+        for(unsigned int i = 1; i < threads; i++)
+            workers.push_back(std::thread(&CommandRecorder::work, this, i));
+    }
+
+    ~CommandRecorder()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        start.notify_all();
+        for(size_t i = 0; i < workers.size(); i++)
+            workers[i].join();
+    }
+
+    CommandRecorder(const CommandRecorder &) = delete;
+    CommandRecorder &operator=(const CommandRecorder &) = delete;
+
+    unsigned int threadCount() const
+    {
+        return static_cast<unsigned int>(commandBuffers.size());
+    }
+
+    // splits [0, count) in one contiguous range per thread and returns when every range is recorded;
+    // the buffers are cleared first
+    void record(size_t count, const Record &function)
+    {
+        PROFILE_ZONE("record commands");
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = function;
+            items = count;
+            pending = workers.size();
+            generation++;
+        }
+        start.notify_all();
+        run(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return pending == 0; });
+        job = Record();
+    }
+
+    // in the order of the ranges they cover
+    const std::vector<CommandBuffer>& buffers() const
+    {
+        return commandBuffers;
+    }
+
+private:
+    std::vector<CommandBuffer> commandBuffers;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable start;
+    std::condition_variable done;
+    unsigned long long generation;
+    size_t pending;
+    bool stopping;
+    Record job;
+    size_t items;
+
+    void run(unsigned int index)
+    {
+        const size_t threads = commandBuffers.size();
+        const size_t begin = items * index / threads;
+        const size_t end = items * (index + 1) / threads;
+        commandBuffers[index].clear();
+        job(commandBuffers[index], begin, end);
+    }
+
+    void work(unsigned int index)
+    {
+        PROFILE_THREAD("command recorder");
+        unsigned long long seen = 0;
+        for(;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                start.wait(lock, [&] { return stopping || generation != seen; });
+                if(stopping)
+                    return;
+                seen = generation;
+            }
+            {
+                PROFILE_ZONE("record commands");
+                run(index);
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending--;
+            }
+            done.notify_one();
+        }
+    }
+};
+
+// Replays command buffers on the GL thread
+class CommandQueue
+{
+public:
+    CommandQueue() : capacity(0), alignment(0)
+    {
+    }
+
+    CommandQueue(const CommandQueue &) = delete;
+    CommandQueue &operator=(const CommandQueue &) = delete;
+
+    void submit(const std::vector<CommandBuffer> &buffers)
+    {
+        if(!buffers.empty())
+            submit(&buffers[0], buffers.size());
+    }
+
+    void submit(const CommandBuffer* buffers, size_t count)
+    {
+        PROFILE_ZONE("submit commands");
+        uploadBlocks(buffers, count);
+        size_t block = 0;
+        for(size_t b = 0; b < count; b++)
+        {
+            const std::vector<Command> &commands = buffers[b].recorded();
+            for(size_t i = 0; i < commands.size(); i++)
+            {
+                const Command &command = commands[i];
+                switch(command.type)
+                {
+                case COMMAND_USE_PROGRAM:
+                    if(GLState::useProgram(command.name))
+                        RenderStatsCollector::bindProgram();
+                    break;
+                case COMMAND_BIND_VERTEX_ARRAY:
+                    if(GLState::bindVertexArray(command.name))
+                        RenderStatsCollector::bindVertexArray();
+                    break;
+                case COMMAND_BIND_TEXTURE:
+                    if(GLState::bindTextureUnit(command.unit, command.target, command.name))
+                        RenderStatsCollector::bindTextures(1);
+                    break;
+                case COMMAND_ENABLE:
+                    GLState::enable(command.target);
+                    break;
+                case COMMAND_DISABLE:
+                    GLState::disable(command.target);
+                    break;
+                case COMMAND_UNIFORM_BLOCK:
+                    glBindBufferRange(GL_UNIFORM_BUFFER, command.name, uniformBuffer.get(), offsets[block++], command.count);
+                    break;
+                case COMMAND_DRAW_ELEMENTS:
+                {
+                    const void* indices = reinterpret_cast<const void*>(static_cast<size_t>(command.first) * sizeof(unsigned int));
+                    if(command.instances == 1 && command.baseVertex == 0)
+                        glDrawElements(command.target, command.count, GL_UNSIGNED_INT, indices);
+                    else
+                        glDrawElementsInstancedBaseVertex(command.target, command.count, GL_UNSIGNED_INT, indices, command.instances, command.baseVertex);
+                    RenderStatsCollector::draw(triangles(command.target, command.count), command.instances);
+                    break;
+                }
+                case COMMAND_DRAW_ARRAYS:
+                    if(command.instances == 1)
+                        glDrawArrays(command.target, command.first, command.count);
+                    else
+                        glDrawArraysInstanced(command.target, command.first, command.count, command.instances);
+                    RenderStatsCollector::draw(triangles(command.target, command.count), command.instances);
+                    break;
+                }
+            }
+        }
+    }
+
+private:
+    GLBuffer uniformBuffer;
+    size_t capacity;
+    size_t alignment;
+    std::vector<unsigned char> staging;
+    std::vector<GLintptr> offsets;
+
+    // the uniform block data of every buffer, each block aligned for glBindBufferRange, in one upload
+    void uploadBlocks(const CommandBuffer* buffers, size_t count)
+    {
+        if(alignment == 0)
+        {
+            GLint value = 0;
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &value);
+            alignment = value > 0 ? static_cast<size_t>(value) : 256;
+        }
+        staging.clear();
+        offsets.clear();
+        for(size_t b = 0; b < count; b++)
+        {
+            const std::vector<Command> &commands = buffers[b].recorded();
+            const std::vector<unsigned char> &data = buffers[b].blockData();
+            for(size_t i = 0; i < commands.size(); i++)
+            {
+                if(commands[i].type != COMMAND_UNIFORM_BLOCK)
+                    continue;
+                const size_t offset = (staging.size() + alignment - 1) / alignment * alignment;
+                staging.resize(offset + commands[i].count);
+                memcpy(&staging[offset], &data[commands[i].first], commands[i].count);
+                offsets.push_back(static_cast<GLintptr>(offset));
+            }
+        }
+        if(staging.empty())
+            return;
+
+        if(!uniformBuffer)
+            uniformBuffer.create();
+        glBindBuffer(GL_UNIFORM_BUFFER, uniformBuffer.get());
+        // a new store every frame: the draws of the previous one may still be reading the old store
+        capacity = std::max(capacity, staging.size());
+        glBufferData(GL_UNIFORM_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, staging.size(), &staging[0]);
+        RenderStatsCollector::uploadBuffer(staging.size());
+    }
+
+    static size_t triangles(GLenum mode, GLsizei count)
+    {
+        if(mode == GL_TRIANGLES)
+            return count / 3;
+        if(mode == GL_TRIANGLE_STRIP || mode == GL_TRIANGLE_FAN)
+            return count > 2 ? count - 2 : 0;
+        return 0;
+    }
+};
+#endif
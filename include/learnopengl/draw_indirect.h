@@ -0,0 +1,403 @@
+#ifndef DRAW_INDIRECT_H
+#define DRAW_INDIRECT_H
+
+#include <glad/glad.h> // holds all OpenGL type declarations
+
+#include <glm/glm.hpp>
+
+#include <learnopengl/gl_handle.h>
+#include <learnopengl/gl_state.h>
+#include <learnopengl/mesh.h>
+#include <learnopengl/render_stats.h>
+#include <learnopengl/shader.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+using namespace std;
+
+// first attribute location of the per-instance model matrix (a mat4 takes 4 consecutive locations: 7, 8, 9, 10).
+// vertex shaders used with the batched path read it as: layout (location = 7) in mat4 aInstanceModel;
+// resources/shaders/model.vs does when built with the INSTANCED define
+#define INSTANCE_MODEL_LOCATION 7
+
+// the command layout consumed by glMultiDrawElementsIndirect, as mandated by the GL spec
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint  baseVertex;
+    GLuint baseInstance;
+};
+
+// returns true when the current context honours the baseInstance of the commands (core since 4.2, or through
+// GL_ARB_base_instance): IndirectDrawList::build() stores each command's first matrix there
+inline bool hasBaseInstance()
+{
+#ifdef GL_VERSION_4_2
+    if (GLAD_GL_VERSION_4_2)
+        return true;
+#endif
+#ifdef GL_ARB_base_instance
+    if (GLAD_GL_ARB_base_instance)
+        return true;
+#endif
+    return false;
+}
+
+// returns true when the current context can consume indirect commands through glMultiDrawElementsIndirect
+// (core since 4.3, or through GL_ARB_multi_draw_indirect) with their baseInstance
+inline bool hasMultiDrawIndirect()
+{
+#ifdef GL_VERSION_4_3
+    if (GLAD_GL_VERSION_4_3)
+        return true;
+#endif
+#ifdef GL_ARB_multi_draw_indirect
+    if (GLAD_GL_ARB_multi_draw_indirect)
+        return hasBaseInstance();
+#endif
+    return false;
+}
+
+// All the meshes of a model packed into a single vertex and index buffer, so that every mesh can be drawn
+// with the same VAO bound and addressed by a (firstIndex, baseVertex) pair instead of its own buffers.
+class MeshBatch {
+public:
+    // where a mesh lives inside the shared buffers
+    struct Range {
+        unsigned int    firstIndex;
+        unsigned int    indexCount;
+        int             baseVertex;
+        vector<Texture> textures;
+        vector<MeshLod> lods;      // levels of detail, with absolute first indices (empty: only the full mesh)
+    };
+
+    vector<Range> ranges;
+    GLVertexArray VAO;
+
+    // an empty batch owns no GL objects; ranges can be filled by hand (useful to build commands without a context)
+    MeshBatch()
+    {
+    }
+
+    // packs the given meshes and uploads them to the GPU
+    MeshBatch(const vector<Mesh> &meshes)
+    {
+        vector<Vertex>       vertices;
+        vector<unsigned int> indices;
+        // the meshes share one vertex buffer, so they must share one layout: use the widest one among them
+        VertexLayout layout = meshes.empty() ? VERTEX_LAYOUT_FULL : VERTEX_LAYOUT_STATIC;
+        for(unsigned int i = 0; i < meshes.size(); i++)
+        {
+            if(meshes[i].layout == VERTEX_LAYOUT_FULL || (meshes[i].layout == VERTEX_LAYOUT_SKINNED && layout == VERTEX_LAYOUT_STATIC))
+                layout = meshes[i].layout;
+
+            Range range;
+            range.firstIndex = static_cast<unsigned int>(indices.size());
+            range.indexCount = static_cast<unsigned int>(meshes[i].indices.size());
+            range.baseVertex = static_cast<int>(vertices.size());
+            range.textures   = meshes[i].textures;
+            range.lods       = meshes[i].lods;
+            for(unsigned int lod = 0; lod < range.lods.size(); lod++)
+                range.lods[lod].firstIndex += range.firstIndex;
+            ranges.push_back(range);
+
+            vertices.insert(vertices.end(), meshes[i].vertices.begin(), meshes[i].vertices.end());
+            indices.insert(indices.end(), meshes[i].indices.begin(), meshes[i].indices.end());
+            indices.insert(indices.end(), meshes[i].lodIndices.begin(), meshes[i].lodIndices.end());
+        }
+        setupBatch(vertices, indices, layout);
+    }
+
+    // the batch owns GL objects, so it must not be copied around
+    MeshBatch(const MeshBatch &) = delete;
+    MeshBatch &operator=(const MeshBatch &) = delete;
+
+    // draws one mesh on its own, with the model matrix set as a uniform (shaders built without INSTANCED, see
+    // resources/shaders/model.vs)
+    void Draw(unsigned int range, Shader &shader, unsigned int lod = 0)
+    {
+        const Range &r = ranges[range];
+        const unsigned int firstIndex = r.lods.empty() ? r.firstIndex : r.lods[min<size_t>(lod, r.lods.size() - 1)].firstIndex;
+        const unsigned int indexCount = r.lods.empty() ? r.indexCount : r.lods[min<size_t>(lod, r.lods.size() - 1)].indexCount;
+        Mesh::BindTextures(r.textures, shader);
+        if(GLState::bindVertexArray(VAO.get()))
+            RenderStatsCollector::bindVertexArray();
+        glDrawElementsBaseVertex(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, (void*)(firstIndex * sizeof(unsigned int)), r.baseVertex);
+        RenderStatsCollector::draw(indexCount / 3);
+    }
+
+    // sources the per-instance model matrix from the given buffer (0 disables the instanced arrays, so the
+    // matrix can be fed as a constant attribute with glVertexAttrib4fv instead). Expects the VAO to be bound.
+    // Not cached: the buffer belongs to an IndirectDrawList, and a name freed with it can come back for another
+    void bindInstanceBuffer(unsigned int buffer)
+    {
+        if(buffer == 0)
+        {
+            for(unsigned int i = 0; i < 4; i++)
+                glDisableVertexAttribArray(INSTANCE_MODEL_LOCATION + i);
+            return;
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        for(unsigned int i = 0; i < 4; i++)
+        {
+            glEnableVertexAttribArray(INSTANCE_MODEL_LOCATION + i);
+            glVertexAttribPointer(INSTANCE_MODEL_LOCATION + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(i * sizeof(glm::vec4)));
+            glVertexAttribDivisor(INSTANCE_MODEL_LOCATION + i, 1);
+        }
+    }
+
+private:
+    GLBuffer VBO, EBO;
+
+    // same vertex layout and attribute locations as Mesh::setupMesh, so the same shaders work on both paths
+    void setupBatch(const vector<Vertex> &vertices, const vector<unsigned int> &indices, VertexLayout layout)
+    {
+        if(vertices.empty() || indices.empty())
+            return;
+
+        VAO.create();
+        VBO.create();
+        EBO.create();
+
+        GLState::bindVertexArray(VAO.get());
+        glBindBuffer(GL_ARRAY_BUFFER, VBO.get());
+        vector<unsigned char> data = Mesh::PackVertices(vertices, layout);
+        glBufferData(GL_ARRAY_BUFFER, data.size(), &data[0], GL_STATIC_DRAW);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO.get());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+        RenderStatsCollector::uploadBuffer(data.size());
+        RenderStatsCollector::uploadBuffer(indices.size() * sizeof(unsigned int));
+
+        Mesh::SetupVertexAttributes(layout);
+        GLState::bindVertexArray(0);
+    }
+};
+
+// a run of consecutive commands that share the same batch and textures, submitted with a single call
+struct IndirectDrawGroup {
+    MeshBatch   *batch;
+    unsigned int range;        // any range of the group, used to bind the textures
+    unsigned int firstCommand;
+    unsigned int commandCount;
+};
+
+// Collects the visible (batch, mesh, model matrix) triples of a frame and turns them into indirect draw
+// commands. Every mesh drawn by several entities becomes a single instanced command, and consecutive commands
+// sharing the same textures are merged into one glMultiDrawElementsIndirect call.
+//
+// clear(), add() and build() only touch CPU memory, so the command stream can be built and inspected without
+// a GL context; submit() is the only part that talks to the driver.
+class IndirectDrawList {
+public:
+    IndirectDrawList()
+    {
+    }
+
+    IndirectDrawList(const IndirectDrawList &) = delete;
+    IndirectDrawList &operator=(const IndirectDrawList &) = delete;
+
+    // forgets the previous frame, keeping the allocated memory around
+    void clear()
+    {
+        entries.clear();
+        matrices.clear();
+        commands.clear();
+        instances.clear();
+        groups.clear();
+    }
+
+    // queues every mesh of the batch with the given model matrix, at the given level of detail
+    void add(MeshBatch &batch, const glm::mat4 &model, unsigned int lod = 0)
+    {
+        unsigned int matrix = static_cast<unsigned int>(matrices.size());
+        matrices.push_back(model);
+        for(unsigned int i = 0; i < batch.ranges.size(); i++)
+        {
+            Entry entry = { &batch, i, clampLod(batch.ranges[i], lod), matrix };
+            entries.push_back(entry);
+        }
+    }
+
+    // queues a single mesh of the batch with the given model matrix, at the given level of detail
+    void add(MeshBatch &batch, unsigned int range, const glm::mat4 &model, unsigned int lod = 0)
+    {
+        Entry entry = { &batch, range, clampLod(batch.ranges[range], lod), static_cast<unsigned int>(matrices.size()) };
+        matrices.push_back(model);
+        entries.push_back(entry);
+    }
+
+    // sorts the queued draws and produces the commands, the per-instance matrices (indexed by baseInstance)
+    // and the submission groups
+    void build()
+    {
+        commands.clear();
+        instances.clear();
+        groups.clear();
+
+        // the stable sort keeps the submission order of the instances of a same mesh
+        stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+            if(a.batch != b.batch)
+                return less<MeshBatch *>()(a.batch, b.batch);
+            if(a.range != b.range)
+                return a.range < b.range;
+            return a.lod < b.lod;
+        });
+
+        for(unsigned int i = 0; i < entries.size(); i++)
+        {
+            const Entry &entry = entries[i];
+            const MeshBatch::Range &range = entry.batch->ranges[entry.range];
+            bool sameMesh = i > 0 && entries[i - 1].batch == entry.batch && entries[i - 1].range == entry.range &&
+                            entries[i - 1].lod == entry.lod;
+
+            if(sameMesh)
+                commands.back().instanceCount++;
+            else
+            {
+                DrawElementsIndirectCommand command;
+                command.count         = range.lods.empty() ? range.indexCount : range.lods[entry.lod].indexCount;
+                command.instanceCount = 1;
+                command.firstIndex    = range.lods.empty() ? range.firstIndex : range.lods[entry.lod].firstIndex;
+                command.baseVertex    = range.baseVertex;
+                command.baseInstance  = static_cast<GLuint>(instances.size());
+                commands.push_back(command);
+
+                bool sameGroup = !groups.empty() && groups.back().batch == entry.batch &&
+                                 sameTextures(groups.back().batch->ranges[groups.back().range].textures, range.textures);
+                if(sameGroup)
+                    groups.back().commandCount++;
+                else
+                {
+                    IndirectDrawGroup group = { entry.batch, entry.range, static_cast<unsigned int>(commands.size() - 1), 1 };
+                    groups.push_back(group);
+                }
+            }
+            instances.push_back(matrices[entry.matrix]);
+        }
+    }
+
+    // uploads the commands and issues one glMultiDrawElementsIndirect per group. When the context lacks
+    // multi-draw-indirect (or allowMultiDraw is false) it falls back to a plain loop over the same commands,
+    // feeding each instance's matrix as a constant vertex attribute, which works on any 3.3 core context.
+    // Returns the number of draw calls issued.
+    unsigned int submit(Shader &shader, bool allowMultiDraw = true)
+    {
+        if(commands.empty())
+            return 0;
+
+        bool multiDraw = allowMultiDraw && hasMultiDrawIndirect();
+        unsigned int drawCalls = 0;
+
+        if(multiDraw)
+        {
+            if(!indirectBuffer)
+                indirectBuffer.create();
+            if(!instanceBuffer)
+                instanceBuffer.create();
+
+            // orphan the previous frame's storage so the driver doesn't have to wait on it
+            glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer.get());
+            glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(glm::mat4), &instances[0], GL_STREAM_DRAW);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer.get());
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), &commands[0], GL_STREAM_DRAW);
+            RenderStatsCollector::uploadBuffer(instances.size() * sizeof(glm::mat4));
+            RenderStatsCollector::uploadBuffer(commands.size() * sizeof(DrawElementsIndirectCommand));
+        }
+
+        for(unsigned int g = 0; g < groups.size(); g++)
+        {
+            const IndirectDrawGroup &group = groups[g];
+            MeshBatch &batch = *group.batch;
+            Mesh::BindTextures(batch.ranges[group.range].textures, shader);
+            if(GLState::bindVertexArray(batch.VAO.get()))
+                RenderStatsCollector::bindVertexArray();
+
+            if(multiDraw)
+            {
+                batch.bindInstanceBuffer(instanceBuffer.get());
+                multiDrawElementsIndirect(group);
+                drawCalls++;
+                size_t groupInstances = 0, groupTriangles = 0;
+                for(unsigned int c = group.firstCommand; c < group.firstCommand + group.commandCount; c++)
+                {
+                    groupInstances += commands[c].instanceCount;
+                    groupTriangles += static_cast<size_t>(commands[c].count / 3) * commands[c].instanceCount;
+                }
+                RenderStatsCollector::draw(groupTriangles, groupInstances);
+                continue;
+            }
+
+            batch.bindInstanceBuffer(0);
+            for(unsigned int c = group.firstCommand; c < group.firstCommand + group.commandCount; c++)
+            {
+                const DrawElementsIndirectCommand &command = commands[c];
+                for(unsigned int i = 0; i < command.instanceCount; i++)
+                {
+                    const glm::mat4 &model = instances[command.baseInstance + i];
+                    for(unsigned int col = 0; col < 4; col++)
+                        glVertexAttrib4fv(INSTANCE_MODEL_LOCATION + col, &model[col][0]);
+                    glDrawElementsBaseVertex(GL_TRIANGLES, command.count, GL_UNSIGNED_INT,
+                                             (void*)(command.firstIndex * sizeof(unsigned int)), command.baseVertex);
+                    drawCalls++;
+                    RenderStatsCollector::draw(command.count / 3);
+                }
+            }
+        }
+
+        if(multiDraw)
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        return drawCalls;
+    }
+
+    const vector<DrawElementsIndirectCommand> &getCommands() const { return commands; }
+    const vector<glm::mat4> &getInstances() const { return instances; }
+    const vector<IndirectDrawGroup> &getGroups() const { return groups; }
+
+private:
+    struct Entry {
+        MeshBatch   *batch;
+        unsigned int range;
+        unsigned int lod;
+        unsigned int matrix;
+    };
+
+    vector<Entry>                       entries;
+    vector<glm::mat4>                   matrices;
+    vector<DrawElementsIndirectCommand> commands;
+    vector<glm::mat4>                   instances;
+    vector<IndirectDrawGroup>           groups;
+    GLBuffer indirectBuffer, instanceBuffer;
+
+    static unsigned int clampLod(const MeshBatch::Range &range, unsigned int lod)
+    {
+        return range.lods.empty() ? 0 : min<unsigned int>(lod, static_cast<unsigned int>(range.lods.size() - 1));
+    }
+
+    static bool sameTextures(const vector<Texture> &a, const vector<Texture> &b)
+    {
+        if(a.size() != b.size())
+            return false;
+        for(unsigned int i = 0; i < a.size(); i++)
+        {
+            if(a[i].id != b[i].id || a[i].type != b[i].type)
+                return false;
+        }
+        return true;
+    }
+
+    void multiDrawElementsIndirect(const IndirectDrawGroup &group)
+    {
+        const void *offset = (const void*)(group.firstCommand * sizeof(DrawElementsIndirectCommand));
+#if defined(GL_VERSION_4_3) || defined(GL_ARB_multi_draw_indirect)
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, offset, group.commandCount, 0);
+#else
+        (void)offset;
+#endif
+    }
+};
+#endif
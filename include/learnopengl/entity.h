@@ -5,6 +5,9 @@
 #include <list> //std::list
 #include <array> //std::array
 #include <memory> //std::unique_ptr
+#include <vector> //std::vector
+
+#include <learnopengl/render_stats.h> //RenderStatsCollector
 
 class Transform
 {
@@ -383,6 +386,101 @@ Sphere generateSphereBV(const Model& model)
 	return Sphere((maxAABB + minAABB) * 0.5f, glm::length(minAABB - maxAABB));
 }
 
+//Picks the level of detail of an entity from how much of the screen its bounding sphere covers.
+//Coverage is the projected radius over half the viewport height: 1 fills the screen vertically.
+struct LodSelector
+{
+	glm::vec3 cameraPosition{ 0.f, 0.f, 0.f };
+	float projectionScale = 1.f; // 1 / tan(fovY / 2)
+
+	//Minimum coverage to keep each level: above thresholds[0] LOD 0, above thresholds[1] LOD 1 and so on
+	std::vector<float> thresholds{ 0.25f, 0.12f, 0.06f, 0.03f };
+
+	//Stats of the current frame, see resetStats()
+	std::vector<unsigned int> drawsPerLod;
+	std::vector<size_t> trianglesPerLod;
+
+	LodSelector(const Camera& cam, float fovY)
+		: cameraPosition{ cam.Position }, projectionScale{ 1.f / tanf(fovY * .5f) }
+	{}
+
+	float screenCoverage(const Sphere& sphere, const Transform& transform) const
+	{
+		const glm::vec3 globalScale = transform.getGlobalScale();
+		const glm::vec3 globalCenter{ transform.getModelMatrix() * glm::vec4(sphere.center, 1.f) };
+		const float maxScale = std::max(std::max(globalScale.x, globalScale.y), globalScale.z);
+
+		//Same convention as Sphere::isOnFrustum, the stored radius is a diameter
+		const float worldRadius = sphere.radius * (maxScale * 0.5f);
+		const float distance = glm::length(globalCenter - cameraPosition);
+		if (distance <= worldRadius)
+			return std::numeric_limits<float>::max();
+		return worldRadius * projectionScale / distance;
+	}
+
+	unsigned int select(const Sphere& sphere, const Transform& transform, unsigned int lodCount) const
+	{
+		if (lodCount <= 1)
+			return 0;
+
+		const float coverage = screenCoverage(sphere, transform);
+		unsigned int lod = 0;
+		while (lod + 1 < lodCount && lod < thresholds.size() && coverage < thresholds[lod])
+			lod++;
+		return lod;
+	}
+
+	void record(unsigned int lod, size_t triangles)
+	{
+		if (drawsPerLod.size() <= lod)
+		{
+			drawsPerLod.resize(lod + 1, 0);
+			trianglesPerLod.resize(lod + 1, 0);
+		}
+		drawsPerLod[lod]++;
+		trianglesPerLod[lod] += triangles;
+	}
+
+	void resetStats()
+	{
+		drawsPerLod.clear();
+		trianglesPerLod.clear();
+	}
+};
+
+//Draws only the clusters of the meshes that are inside the frustum and facing the camera.
+//Meshes have to be imported with ModelImportOptions::buildClusters, the others are drawn whole.
+struct ClusterCuller
+{
+	Frustum frustum;
+	glm::vec3 cameraPosition{ 0.f, 0.f, 0.f };
+
+	//Stats of the current frame, see resetStats()
+	ClusterCullStats stats;
+	unsigned int drawCalls = 0;
+
+	ClusterCuller(const Camera& cam, const Frustum& camFrustum)
+		: frustum{ camFrustum }, cameraPosition{ cam.Position }
+	{}
+
+	void draw(Model& model, const Transform& transform, Shader& ourShader)
+	{
+		const Frustum& planes = frustum;
+		drawCalls += model.DrawCulled(ourShader, transform.getModelMatrix(), cameraPosition,
+			[&planes](const glm::vec3& center, float radius)
+			{
+				const Sphere sphere(center, radius);
+				return static_cast<const BoundingVolume&>(sphere).isOnFrustum(planes);
+			}, &stats);
+	}
+
+	void resetStats()
+	{
+		stats.reset();
+		drawCalls = 0;
+	}
+};
+
 class Entity
 {
 public:
@@ -395,10 +493,15 @@ public:
 
 	Model* pModel = nullptr;
 	std::unique_ptr<AABB> boundingVolume;
+	Sphere lodSphere;
 
+	//Empty node: only groups its children (and moves them with its transform), it has no model and is never drawn
+	Entity() : lodSphere{ glm::vec3(0.f), 0.f }
+	{
+	}
 
 	// constructor, expects a filepath to a 3D model.
-	Entity(Model& model) : pModel{ &model }
+	Entity(Model& model) : pModel{ &model }, lodSphere{ generateSphereBV(model) }
 	{
 		boundingVolume = std::make_unique<AABB>(generateAABB(model));
 		//boundingVolume = std::make_unique<Sphere>(generateSphereBV(model));
@@ -466,20 +569,83 @@ public:
 	}
 
 
-	void drawSelfAndChild(const Frustum& frustum, Shader& ourShader, unsigned int& display, unsigned int& total)
+	//When lods is given, every visible entity is drawn at the level of detail it selects (and counted in its stats)
+	void drawSelfAndChild(const Frustum& frustum, Shader& ourShader, unsigned int& display, unsigned int& total, LodSelector* lods = nullptr)
 	{
-		if (boundingVolume->isOnFrustum(frustum, transform))
+		if (pModel)
 		{
-			ourShader.setMat4("model", transform.getModelMatrix());
-			pModel->Draw(ourShader);
-			display++;
+			const bool visible = boundingVolume->isOnFrustum(frustum, transform);
+			RenderStatsCollector::cullObject(visible);
+			if (visible)
+			{
+				const unsigned int lod = selectLod(lods);
+				ourShader.setMat4("model", transform.getModelMatrix());
+				pModel->Draw(ourShader, lod);
+				display++;
+			}
+			total++;
 		}
-		total++;
 
 		for (auto&& child : children)
 		{
-			child->drawSelfAndChild(frustum, ourShader, display, total);
+			child->drawSelfAndChild(frustum, ourShader, display, total, lods);
+		}
+	}
+
+	//Same traversal as drawSelfAndChild, but only queues the visible models in the indirect draw list.
+	//Call drawList.build() and drawList.submit(shader) once the whole scene graph has been collected.
+	void collectSelfAndChild(const Frustum& frustum, IndirectDrawList& drawList, unsigned int& display, unsigned int& total, LodSelector* lods = nullptr)
+	{
+		if (pModel)
+		{
+			const bool visible = boundingVolume->isOnFrustum(frustum, transform);
+			RenderStatsCollector::cullObject(visible);
+			if (visible)
+			{
+				drawList.add(pModel->GetBatch(), transform.getModelMatrix(), selectLod(lods));
+				display++;
+			}
+			total++;
 		}
+
+		for (auto&& child : children)
+		{
+			child->collectSelfAndChild(frustum, drawList, display, total, lods);
+		}
+	}
+
+	//Same traversal as drawSelfAndChild, but visible entities only draw their visible clusters
+	void drawClustersSelfAndChild(ClusterCuller& culler, Shader& ourShader, unsigned int& display, unsigned int& total)
+	{
+		if (pModel)
+		{
+			const bool visible = boundingVolume->isOnFrustum(culler.frustum, transform);
+			RenderStatsCollector::cullObject(visible);
+			if (visible)
+			{
+				ourShader.setMat4("model", transform.getModelMatrix());
+				culler.draw(*pModel, transform, ourShader);
+				display++;
+			}
+			total++;
+		}
+
+		for (auto&& child : children)
+		{
+			child->drawClustersSelfAndChild(culler, ourShader, display, total);
+		}
+	}
+
+private:
+	unsigned int selectLod(LodSelector* lods) const
+	{
+		if (!lods)
+			return 0;
+
+		const unsigned int lod = lods->select(lodSphere, transform, pModel->GetLodCount());
+		const std::vector<size_t>& triangles = pModel->GetLodTriangleCounts();
+		lods->record(lod, triangles.empty() ? 0 : triangles[std::min<size_t>(lod, triangles.size() - 1)]);
+		return lod;
 	}
 };
 #endif
@@ -0,0 +1,685 @@
+#ifndef FRAME_GRAPH_H
+#define FRAME_GRAPH_H
+
+#include <glad/glad.h>
+
+#include <learnopengl/gl_handle.h>
+#include <learnopengl/gl_state.h>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <vector>
+
+// The passes of a frame and the textures they pass to each other, declared instead of hard-coded in main:
+//
+//     FrameGraph graph;
+//     FrameGraphResource screen = graph.importFramebuffer("screen", 0, width, height);
+//     FrameGraphResource color;
+//     graph.addPass("scene",
+//         [&](FrameGraphBuilder &builder) { color = builder.create("color", FrameGraphTextureDesc(width, height, GL_RGBA8));
+//                                           builder.create("depth", FrameGraphTextureDesc(width, height, GL_DEPTH24_STENCIL8)); },
+//         [&](const FrameGraphPassResources &) { ...draw the scene... });
+//     graph.addPass("post",
+//         [&](FrameGraphBuilder &builder) { builder.read(color); builder.write(screen); },
+//         [&](const FrameGraphPassResources &resources) { GLState::bindTextureUnit(0, GL_TEXTURE_2D, resources.texture(color)); ... });
+//     graph.compile();                   // no GL calls: can run without a context
+//     while (...)
+//         graph.execute();               // binds each pass's framebuffer and runs it
+//
+// compile() orders the passes so that every pass runs after the passes writing what it reads (the ones declared
+// before it, if any; writers of the same resource keep their declaration order), culls the passes nothing needs,
+// and gives the transient textures physical textures: two textures with the same description whose lifetimes
+// (first to last pass using them) don't overlap share one. Passes are needed when they write an imported
+// resource, an output (markOutput) or declare a side effect, or when a needed pass reads what they write.
+//
+// A pass renders to the textures it writes (colour attachments in order, depth/stencil formats to the depth
+// attachment), or to the imported framebuffer it writes. It samples what it reads through its
+// FrameGraphPassResources. The GL textures and framebuffers are kept from one execute() to the next.
+
+typedef unsigned int FrameGraphResource;
+
+const FrameGraphResource FRAME_GRAPH_INVALID = 0xffffffffu;
+
+struct FrameGraphTextureDesc {
+    int width;
+    int height;
+    GLenum internalFormat;
+
+    FrameGraphTextureDesc(int width = 0, int height = 0, GLenum internalFormat = GL_RGBA8)
+        : width(width), height(height), internalFormat(internalFormat)
+    {
+    }
+
+    bool operator==(const FrameGraphTextureDesc &other) const
+    {
+        return width == other.width && height == other.height && internalFormat == other.internalFormat;
+    }
+
+    bool isDepth() const
+    {
+        return internalFormat == GL_DEPTH_COMPONENT16 || internalFormat == GL_DEPTH_COMPONENT24 ||
+               internalFormat == GL_DEPTH_COMPONENT32F || internalFormat == GL_DEPTH24_STENCIL8 ||
+               internalFormat == GL_DEPTH32F_STENCIL8;
+    }
+
+    bool hasStencil() const
+    {
+        return internalFormat == GL_DEPTH24_STENCIL8 || internalFormat == GL_DEPTH32F_STENCIL8;
+    }
+
+    // what the texture takes in video memory, roughly
+    size_t bytes() const
+    {
+        size_t pixel = 4;
+        switch(internalFormat)
+        {
+        case GL_R8: pixel = 1; break;
+        case GL_RG8: case GL_R16F: case GL_DEPTH_COMPONENT16: pixel = 2; break;
+        case GL_RGBA16F: case GL_RG32F: case GL_DEPTH32F_STENCIL8: pixel = 8; break;
+        case GL_RGB16F: pixel = 6; break;
+        case GL_RGB32F: pixel = 12; break;
+        case GL_RGBA32F: pixel = 16; break;
+        default: break;
+        }
+        return pixel * static_cast<size_t>(width) * static_cast<size_t>(height);
+    }
+};
+
+class FrameGraph;
+
+// handed to a pass's setup: what it reads and writes
+class FrameGraphBuilder
+{
+public:
+    FrameGraphBuilder(FrameGraph &graph, unsigned int pass) : graph(graph), pass(pass)
+    {
+    }
+
+    // a new transient texture, written by this pass
+    FrameGraphResource create(const std::string &name, const FrameGraphTextureDesc &desc);
+    FrameGraphResource read(FrameGraphResource resource);
+    FrameGraphResource write(FrameGraphResource resource);
+    // the pass is kept even if nothing reads what it writes
+    void sideEffect();
+
+private:
+    FrameGraph &graph;
+    unsigned int pass;
+};
+
+// handed to a pass when it runs
+class FrameGraphPassResources
+{
+public:
+    FrameGraphPassResources(const FrameGraph &graph) : graph(graph)
+    {
+    }
+
+    // the GL texture behind a resource this pass reads or writes
+    GLuint texture(FrameGraphResource resource) const;
+    const FrameGraphTextureDesc& desc(FrameGraphResource resource) const;
+
+private:
+    const FrameGraph &graph;
+};
+
+class FrameGraph
+{
+public:
+    typedef std::function<void(FrameGraphBuilder&)> Setup;
+    typedef std::function<void(const FrameGraphPassResources&)> Execute;
+
+    FrameGraph()
+    {
+    }
+
+    ~FrameGraph()
+    {
+        releaseResources();
+    }
+
+    // the graph owns GL objects, so it must not be copied around
+    FrameGraph(const FrameGraph &) = delete;
+    FrameGraph &operator=(const FrameGraph &) = delete;
+
+    // setup runs now and declares the resources, execute runs in every execute() unless the pass is culled
+    unsigned int addPass(const std::string &name, const Setup &setup, const Execute &execute)
+    {
+        Pass pass;
+        pass.name = name;
+        pass.execute = execute;
+        passes.push_back(pass);
+        compiled = false;
+        FrameGraphBuilder builder(*this, static_cast<unsigned int>(passes.size() - 1));
+        setup(builder);
+        return static_cast<unsigned int>(passes.size() - 1);
+    }
+
+    // a framebuffer owned by someone else (0 is the default one), drawn to by the passes that write it
+    FrameGraphResource importFramebuffer(const std::string &name, GLuint framebuffer, int width, int height)
+    {
+        Resource resource;
+        resource.name = name;
+        resource.desc = FrameGraphTextureDesc(width, height, GL_RGBA8);
+        resource.imported = true;
+        resource.framebuffer = framebuffer;
+        resources.push_back(resource);
+        compiled = false;
+        return static_cast<FrameGraphResource>(resources.size() - 1);
+    }
+
+    // a texture owned by someone else, e.g. loaded from a file
+    FrameGraphResource importTexture(const std::string &name, GLuint texture, const FrameGraphTextureDesc &desc)
+    {
+        Resource resource;
+        resource.name = name;
+        resource.desc = desc;
+        resource.imported = true;
+        resource.texture = texture;
+        resources.push_back(resource);
+        compiled = false;
+        return static_cast<FrameGraphResource>(resources.size() - 1);
+    }
+
+    // a transient texture declared ahead of the passes, so that a pass can read it before its writer is declared;
+    // some pass must still write it
+    FrameGraphResource createTexture(const std::string &name, const FrameGraphTextureDesc &desc)
+    {
+        compiled = false;
+        return addResource(name, desc);
+    }
+
+    // the resource is used after execute(), its writers are never culled
+    void markOutput(FrameGraphResource resource)
+    {
+        resources[resource].output = true;
+        compiled = false;
+    }
+
+    // forget the passes and resources, keep the GL textures and framebuffers for the next declaration
+    void clear()
+    {
+        passes.clear();
+        resources.clear();
+        order.clear();
+        slotDescs.clear();
+        compiled = false;
+    }
+
+    // orders, culls and aliases; false (and nothing executes) if the graph has a cycle or an invalid pass
+    bool compile()
+    {
+        compiled = false;
+        order.clear();
+        slotDescs.clear();
+        const size_t passCount = passes.size();
+
+        // writers of each resource, in declaration order
+        std::vector<std::vector<unsigned int> > writers(resources.size());
+        for(unsigned int p = 0; p < passCount; p++)
+        {
+            passes[p].culled = true;
+            passes[p].dependencies.clear();
+            for(size_t i = 0; i < passes[p].writes.size(); i++)
+                writers[passes[p].writes[i]].push_back(p);
+        }
+
+        for(unsigned int p = 0; p < passCount; p++)
+        {
+            Pass &pass = passes[p];
+            unsigned int framebuffers = 0, textures = 0;
+            for(size_t i = 0; i < pass.writes.size(); i++)
+            {
+                const Resource &resource = resources[pass.writes[i]];
+                if(resource.imported && resource.texture == 0)
+                    framebuffers++;
+                else
+                    textures++;
+            }
+            if(framebuffers > 1 || (framebuffers == 1 && textures > 0))
+            {
+                std::cout << "ERROR::FRAME_GRAPH::PASS:: " << pass.name << " writes to an imported framebuffer and other targets" << std::endl;
+                return false;
+            }
+            // a read sees the writers declared before the pass, or all of them when it is declared before they are
+            for(size_t i = 0; i < pass.reads.size(); i++)
+            {
+                const FrameGraphResource r = pass.reads[i];
+                const bool writtenBefore = !writers[r].empty() && writers[r][0] < p;
+                for(size_t w = 0; w < writers[r].size(); w++)
+                    if(writers[r][w] != p && (!writtenBefore || writers[r][w] < p))
+                        pass.dependencies.push_back(writers[r][w]);
+                if(writers[r].empty() && !resources[r].imported)
+                {
+                    std::cout << "ERROR::FRAME_GRAPH::RESOURCE:: " << pass.name << " reads " << resources[r].name << ", which nothing writes" << std::endl;
+                    return false;
+                }
+            }
+            // writers of the same resource keep their declaration order
+            for(size_t i = 0; i < pass.writes.size(); i++)
+            {
+                const std::vector<unsigned int> &w = writers[pass.writes[i]];
+                const std::vector<unsigned int>::const_iterator self = std::find(w.begin(), w.end(), p);
+                if(self != w.begin())
+                    pass.dependencies.push_back(*(self - 1));
+            }
+        }
+
+        // culling: from the passes with visible results back through what they read
+        std::vector<unsigned int> stack;
+        for(unsigned int p = 0; p < passCount; p++)
+        {
+            bool needed = passes[p].sideEffect;
+            for(size_t i = 0; i < passes[p].writes.size(); i++)
+                needed = needed || resources[passes[p].writes[i]].imported || resources[passes[p].writes[i]].output;
+            if(needed)
+            {
+                passes[p].culled = false;
+                stack.push_back(p);
+            }
+        }
+        while(!stack.empty())
+        {
+            const unsigned int p = stack.back();
+            stack.pop_back();
+            for(size_t i = 0; i < passes[p].dependencies.size(); i++)
+            {
+                Pass &dependency = passes[passes[p].dependencies[i]];
+                if(dependency.culled)
+                {
+                    dependency.culled = false;
+                    stack.push_back(passes[p].dependencies[i]);
+                }
+            }
+        }
+
+        // topological order of the kept passes, declaration order among the ready ones
+        std::vector<unsigned int> waiting(passCount, 0);
+        std::vector<std::vector<unsigned int> > dependents(passCount);
+        for(unsigned int p = 0; p < passCount; p++)
+        {
+            if(passes[p].culled)
+                continue;
+            for(size_t i = 0; i < passes[p].dependencies.size(); i++)
+            {
+                const unsigned int d = passes[p].dependencies[i];
+                if(std::find(dependents[d].begin(), dependents[d].end(), p) == dependents[d].end())
+                {
+                    dependents[d].push_back(p);
+                    waiting[p]++;
+                }
+            }
+        }
+        std::priority_queue<unsigned int, std::vector<unsigned int>, std::greater<unsigned int> > ready;
+        size_t kept = 0;
+        for(unsigned int p = 0; p < passCount; p++)
+        {
+            if(passes[p].culled)
+                continue;
+            kept++;
+            if(waiting[p] == 0)
+                ready.push(p);
+        }
+        while(!ready.empty())
+        {
+            const unsigned int p = ready.top();
+            ready.pop();
+            order.push_back(p);
+            for(size_t i = 0; i < dependents[p].size(); i++)
+                if(--waiting[dependents[p][i]] == 0)
+                    ready.push(dependents[p][i]);
+        }
+        if(order.size() != kept)
+        {
+            std::cout << "ERROR::FRAME_GRAPH::CYCLE:: the passes";
+            for(unsigned int p = 0; p < passCount; p++)
+                if(!passes[p].culled && waiting[p] > 0)
+                    std::cout << " " << passes[p].name;
+            std::cout << " depend on each other" << std::endl;
+            order.clear();
+            return false;
+        }
+
+        // lifetimes of the transient textures, in positions of the order
+        for(size_t r = 0; r < resources.size(); r++)
+        {
+            resources[r].first = FRAME_GRAPH_INVALID;
+            resources[r].last = 0;
+            resources[r].slot = FRAME_GRAPH_INVALID;
+        }
+        for(unsigned int position = 0; position < order.size(); position++)
+        {
+            const Pass &pass = passes[order[position]];
+            for(int list = 0; list < 2; list++)
+            {
+                const std::vector<FrameGraphResource> &used = list == 0 ? pass.reads : pass.writes;
+                for(size_t i = 0; i < used.size(); i++)
+                {
+                    Resource &resource = resources[used[i]];
+                    resource.first = std::min(resource.first, position);
+                    resource.last = std::max(resource.last, position);
+                }
+            }
+        }
+        // outputs live until the end of the frame
+        for(size_t r = 0; r < resources.size(); r++)
+            if(resources[r].output && resources[r].first != FRAME_GRAPH_INVALID)
+                resources[r].last = static_cast<unsigned int>(order.size());
+
+        // aliasing: by first use, into the first slot of the same description that is free by then
+        std::vector<FrameGraphResource> transient;
+        for(size_t r = 0; r < resources.size(); r++)
+            if(!resources[r].imported && resources[r].first != FRAME_GRAPH_INVALID)
+                transient.push_back(static_cast<FrameGraphResource>(r));
+        std::stable_sort(transient.begin(), transient.end(), FirstUse(resources));
+        std::vector<unsigned int> slotLast;
+        for(size_t i = 0; i < transient.size(); i++)
+        {
+            Resource &resource = resources[transient[i]];
+            for(unsigned int s = 0; s < slotDescs.size() && resource.slot == FRAME_GRAPH_INVALID; s++)
+                if(slotDescs[s] == resource.desc && slotLast[s] < resource.first)
+                    resource.slot = s;
+            if(resource.slot == FRAME_GRAPH_INVALID)
+            {
+                resource.slot = static_cast<unsigned int>(slotDescs.size());
+                slotDescs.push_back(resource.desc);
+                slotLast.push_back(0);
+            }
+            slotLast[resource.slot] = resource.last;
+        }
+        compiled = true;
+        return true;
+    }
+
+    // runs the passes in order, compiling first if needed
+    void execute()
+    {
+        if(!compiled && !compile())
+            return;
+        allocate();
+        FrameGraphPassResources access(*this);
+        for(size_t position = 0; position < order.size(); position++)
+        {
+            const unsigned int p = order[position];
+            bindTarget(p);
+            passes[p].execute(access);
+        }
+    }
+
+    // the compiled schedule, for inspection and tests
+    const std::vector<unsigned int>& passOrder() const
+    {
+        return order;
+    }
+
+    size_t passCount() const
+    {
+        return passes.size();
+    }
+
+    bool isCulled(unsigned int pass) const
+    {
+        return passes[pass].culled;
+    }
+
+    const std::string& passName(unsigned int pass) const
+    {
+        return passes[pass].name;
+    }
+
+    // the physical texture a transient resource got, FRAME_GRAPH_INVALID if imported or unused
+    unsigned int physicalSlot(FrameGraphResource resource) const
+    {
+        return resources[resource].slot;
+    }
+
+    size_t physicalCount() const
+    {
+        return slotDescs.size();
+    }
+
+    // memory of the used transient textures without and with aliasing
+    size_t transientBytes() const
+    {
+        size_t bytes = 0;
+        for(size_t r = 0; r < resources.size(); r++)
+            if(resources[r].slot != FRAME_GRAPH_INVALID)
+                bytes += resources[r].desc.bytes();
+        return bytes;
+    }
+
+    size_t physicalBytes() const
+    {
+        size_t bytes = 0;
+        for(size_t s = 0; s < slotDescs.size(); s++)
+            bytes += slotDescs[s].bytes();
+        return bytes;
+    }
+
+    void print(std::ostream &out) const
+    {
+        out << "FRAME_GRAPH::";
+        for(size_t i = 0; i < order.size(); i++)
+            out << (i ? " -> " : " ") << passes[order[i]].name;
+        for(size_t p = 0; p < passes.size(); p++)
+            if(passes[p].culled)
+                out << " (culled " << passes[p].name << ")";
+        out << ", " << slotDescs.size() << " textures for " << transientBytes() / 1024 << " KiB of transient ones, "
+            << physicalBytes() / 1024 << " KiB allocated" << std::endl;
+    }
+
+    // deletes the GL textures and framebuffers
+    void releaseResources()
+    {
+        slots.clear();
+        framebuffers.clear();
+    }
+
+private:
+    friend class FrameGraphBuilder;
+    friend class FrameGraphPassResources;
+
+    struct Pass {
+        std::string name;
+        Execute execute;
+        std::vector<FrameGraphResource> reads;
+        std::vector<FrameGraphResource> writes;
+        bool sideEffect = false;
+        // compile()
+        std::vector<unsigned int> dependencies;
+        bool culled = false;
+    };
+
+    struct Resource {
+        std::string name;
+        FrameGraphTextureDesc desc;
+        bool imported = false;
+        bool output = false;
+        GLuint framebuffer = 0;     // imported framebuffer
+        GLuint texture = 0;         // imported texture
+        // compile()
+        unsigned int first = FRAME_GRAPH_INVALID;
+        unsigned int last = 0;
+        unsigned int slot = FRAME_GRAPH_INVALID;
+    };
+
+    struct FirstUse {
+        const std::vector<Resource> &resources;
+        FirstUse(const std::vector<Resource> &resources) : resources(resources) {}
+        bool operator()(FrameGraphResource a, FrameGraphResource b) const
+        {
+            return resources[a].first < resources[b].first;
+        }
+    };
+
+    // a GL texture, kept between frames
+    struct Slot {
+        FrameGraphTextureDesc desc;
+        GLTexture texture;
+    };
+
+    // the framebuffer of a set of attachments, kept between frames
+    struct Target {
+        std::vector<GLuint> attachments;
+        GLFramebuffer framebuffer;
+    };
+
+    std::vector<Pass> passes;
+    std::vector<Resource> resources;
+    std::vector<unsigned int> order;
+    std::vector<FrameGraphTextureDesc> slotDescs;
+    bool compiled = false;
+    std::vector<Slot> slots;
+    std::vector<Target> framebuffers;
+
+    FrameGraphResource addResource(const std::string &name, const FrameGraphTextureDesc &desc)
+    {
+        Resource resource;
+        resource.name = name;
+        resource.desc = desc;
+        resources.push_back(resource);
+        return static_cast<FrameGraphResource>(resources.size() - 1);
+    }
+
+    GLuint textureOf(FrameGraphResource resource) const
+    {
+        const Resource &r = resources[resource];
+        if(r.imported)
+            return r.texture;
+        return r.slot < slots.size() ? slots[r.slot].texture.get() : 0;
+    }
+
+    // (re)creates the textures whose description changed since the last frame
+    void allocate()
+    {
+        slots.resize(std::max(slots.size(), slotDescs.size()));
+        for(size_t s = 0; s < slotDescs.size(); s++)
+        {
+            Slot &slot = slots[s];
+            if(slot.texture && slot.desc == slotDescs[s])
+                continue;
+            if(!slot.texture)
+                slot.texture.create();
+            slot.desc = slotDescs[s];
+            GLenum format = GL_RGBA, type = GL_UNSIGNED_BYTE;
+            pixelFormat(slot.desc, format, type);
+            GLState::bindTexture(GL_TEXTURE_2D, slot.texture.get());
+            glTexImage2D(GL_TEXTURE_2D, 0, slot.desc.internalFormat, slot.desc.width, slot.desc.height, 0, format, type, NULL);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+    }
+
+    static void pixelFormat(const FrameGraphTextureDesc &desc, GLenum &format, GLenum &type)
+    {
+        format = GL_RGBA;
+        type = GL_UNSIGNED_BYTE;
+        if(desc.hasStencil())
+            format = GL_DEPTH_STENCIL, type = desc.internalFormat == GL_DEPTH24_STENCIL8 ? GL_UNSIGNED_INT_24_8 : GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+        else if(desc.isDepth())
+            format = GL_DEPTH_COMPONENT, type = GL_FLOAT;
+        else if(desc.internalFormat == GL_R8 || desc.internalFormat == GL_R16F || desc.internalFormat == GL_R32F)
+            format = GL_RED;
+        else if(desc.internalFormat == GL_RG8 || desc.internalFormat == GL_RG16F || desc.internalFormat == GL_RG32F)
+            format = GL_RG;
+        else if(desc.internalFormat == GL_RGB8 || desc.internalFormat == GL_RGB16F || desc.internalFormat == GL_RGB32F)
+            format = GL_RGB;
+    }
+
+    // binds the framebuffer the pass renders to and sets the viewport to its size
+    void bindTarget(unsigned int p)
+    {
+        const Pass &pass = passes[p];
+        if(pass.writes.empty())
+            return;
+        const Resource &first = resources[pass.writes[0]];
+        if(first.imported && first.texture == 0)
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, first.framebuffer);
+            glViewport(0, 0, first.desc.width, first.desc.height);
+            return;
+        }
+
+        std::vector<GLuint> attachments;
+        for(size_t i = 0; i < pass.writes.size(); i++)
+            attachments.push_back(textureOf(pass.writes[i]));
+        Target* target = nullptr;
+        for(size_t i = 0; i < framebuffers.size() && !target; i++)
+            if(framebuffers[i].attachments == attachments)
+                target = &framebuffers[i];
+        if(target)
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer.get());
+            glViewport(0, 0, first.desc.width, first.desc.height);
+            return;
+        }
+
+        framebuffers.push_back(Target());
+        target = &framebuffers.back();
+        target->attachments = attachments;
+        target->framebuffer.create();
+        glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer.get());
+        std::vector<GLenum> drawBuffers;
+        for(size_t i = 0; i < pass.writes.size(); i++)
+        {
+            const FrameGraphTextureDesc &desc = resources[pass.writes[i]].desc;
+            GLenum attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(drawBuffers.size());
+            if(desc.hasStencil())
+                attachment = GL_DEPTH_STENCIL_ATTACHMENT;
+            else if(desc.isDepth())
+                attachment = GL_DEPTH_ATTACHMENT;
+            else
+                drawBuffers.push_back(attachment);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, attachments[i], 0);
+        }
+        if(drawBuffers.empty())
+            glDrawBuffer(GL_NONE);
+        else
+            glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), &drawBuffers[0]);
+        if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            std::cout << "ERROR::FRAME_GRAPH::FRAMEBUFFER:: the targets of " << pass.name << " are not complete" << std::endl;
+        glViewport(0, 0, first.desc.width, first.desc.height);
+    }
+};
+
+inline FrameGraphResource FrameGraphBuilder::create(const std::string &name, const FrameGraphTextureDesc &desc)
+{
+    return write(graph.addResource(name, desc));
+}
+
+inline FrameGraphResource FrameGraphBuilder::read(FrameGraphResource resource)
+{
+    std::vector<FrameGraphResource> &reads = graph.passes[pass].reads;
+    if(std::find(reads.begin(), reads.end(), resource) == reads.end())
+        reads.push_back(resource);
+    return resource;
+}
+
+inline FrameGraphResource FrameGraphBuilder::write(FrameGraphResource resource)
+{
+    std::vector<FrameGraphResource> &writes = graph.passes[pass].writes;
+    if(std::find(writes.begin(), writes.end(), resource) == writes.end())
+        writes.push_back(resource);
+    return resource;
+}
+
+inline void FrameGraphBuilder::sideEffect()
+{
+    graph.passes[pass].sideEffect = true;
+}
+
+inline GLuint FrameGraphPassResources::texture(FrameGraphResource resource) const
+{
+    return graph.textureOf(resource);
+}
+
+inline const FrameGraphTextureDesc& FrameGraphPassResources::desc(FrameGraphResource resource) const
+{
+    return graph.resources[resource].desc;
+}
+#endif
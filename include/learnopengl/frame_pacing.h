@@ -0,0 +1,279 @@
+#ifndef FRAME_PACING_H
+#define FRAME_PACING_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <learnopengl/gpu_timestamps.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// When frames are started and how long they take to reach the screen:
+//
+//  - pacing: vsync (swap interval 1, the default), off (0), or adaptive (-1: waits for vblank unless the frame
+//    is late, where the driver has EXT_swap_control_tear, vsync otherwise), optionally capped at N frames per
+//    second by sleeping before the frame starts
+//  - late input: the events are polled right after that sleep, so the input of a frame is as recent as possible
+//    when its draw calls are built
+//  - measurement: the time between frame starts goes into a histogram (p50, p99), and with --latency the time
+//    from polling the input to the GPU finishing the frame, read back with timestamp queries a few frames later
+//
+// Headless::begin and Headless::shouldClose drive it (see headless.h: --vsync, --fps-cap, --latency), so an
+// exercise's loop doesn't change. The GPU finishing a frame is when it can be presented: with vsync it is shown
+// at the next vblank, up to one refresh later, which the latency doesn't include.
+
+enum FramePacing {
+    PACING_VSYNC,
+    PACING_OFF,
+    PACING_ADAPTIVE
+};
+
+// times in ms, in buckets of 0.05 ms up to 100 ms; longer ones share the last bucket
+struct FrameHistogram {
+    static const unsigned int BUCKETS = 2000;
+    static constexpr double BUCKET_MS = 0.05;
+
+    std::vector<unsigned int> counts;
+    unsigned long long total = 0;
+    double sum = 0.0;
+    double max = 0.0;
+
+    FrameHistogram() : counts(BUCKETS, 0)
+    {
+    }
+
+    void add(double ms)
+    {
+        const unsigned int bucket = static_cast<unsigned int>(std::max(0.0, ms) / BUCKET_MS);
+        counts[std::min(bucket, BUCKETS - 1)]++;
+        total++;
+        sum += ms;
+        max = std::max(max, ms);
+    }
+
+    double mean() const
+    {
+        return total > 0 ? sum / total : 0.0;
+    }
+
+    // upper edge of the bucket holding the p-th percentile (p in [0, 100])
+    double percentile(double p) const
+    {
+        if(total == 0)
+            return 0.0;
+        const unsigned long long rank = static_cast<unsigned long long>(p / 100.0 * (total - 1)) + 1;
+        unsigned long long seen = 0;
+        for(unsigned int i = 0; i < BUCKETS; i++)
+        {
+            seen += counts[i];
+            if(seen >= rank)
+                return i == BUCKETS - 1 ? max : std::min(max, (i + 1) * BUCKET_MS);
+        }
+        return max;
+    }
+
+    void print(std::ostream &out, const char* name) const
+    {
+        out << "FRAME_PACING:: " << name << " " << total << " samples, mean " << mean() << " ms, p50 "
+            << percentile(50.0) << " ms, p90 " << percentile(90.0) << " ms, p99 " << percentile(99.0)
+            << " ms, max " << max << " ms" << std::endl;
+    }
+};
+
+class FramePacer
+{
+public:
+    static const unsigned int FRAMES = GPU_QUERY_FRAMES;
+
+    static void setPacing(FramePacing pacing)
+    {
+        state().pacing = pacing;
+    }
+
+    // 0: no cap
+    static void setFrameCap(double fps)
+    {
+        state().period = fps > 0.0 ? static_cast<int64_t>(1e9 / fps) : 0;
+    }
+
+    static void measureLatency(bool enabled)
+    {
+        state().measureLatency = enabled;
+    }
+
+    // "on", "off" or "adaptive"
+    static bool parsePacing(const std::string &value)
+    {
+        if(value == "on")
+            setPacing(PACING_VSYNC);
+        else if(value == "off")
+            setPacing(PACING_OFF);
+        else if(value == "adaptive")
+            setPacing(PACING_ADAPTIVE);
+        else
+            return false;
+        return true;
+    }
+
+    // once the context is current; without a window to swap (headless) only the cap applies
+    static void begin(bool swaps)
+    {
+        State &s = state();
+        if(swaps)
+        {
+            int interval = s.pacing == PACING_OFF ? 0 : 1;
+            if(s.pacing == PACING_ADAPTIVE)
+            {
+                if(glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+                    interval = -1;
+                else
+                    std::cout << "FRAME_PACING:: no EXT_swap_control_tear, adaptive vsync falls back to vsync" << std::endl;
+            }
+            glfwSwapInterval(interval);
+        }
+        if(s.measureLatency)
+        {
+            s.timestamps = timerQueryBits(GL_TIMESTAMP) > 0;
+            if(s.timestamps)
+                s.clock.synchronize();
+            else
+                std::cout << "FRAME_PACING:: no timestamp queries, the latency ends when the swap returns" << std::endl;
+        }
+        s.frameStart = 0;
+        s.deadline = 0;
+    }
+
+    // the start of a frame, after the previous one was swapped: waits for the cap, then polls the input
+    static void frame()
+    {
+        State &s = state();
+        const int64_t swapped = now();
+        if(s.frameStart != 0)
+        {
+            if(s.measureLatency)
+                presented(swapped);
+            if(s.period > 0)
+                wait();
+        }
+        const int64_t start = now();
+        if(s.frameStart != 0)
+            s.frameTimes.add((start - s.frameStart) / 1e6);
+        s.frameStart = start;
+
+        glfwPollEvents();
+        s.inputTime = now();
+    }
+
+    static const FrameHistogram& frameTimes()
+    {
+        return state().frameTimes;
+    }
+
+    static const FrameHistogram& latency()
+    {
+        return state().latency;
+    }
+
+    static void report(std::ostream &out)
+    {
+        State &s = state();
+        if(s.measureLatency)
+        {
+            // the frames still on the GPU
+            glFinish();
+            collect();
+        }
+        s.frameTimes.print(out, "frame time");
+        if(s.measureLatency)
+        {
+            s.latency.print(out, s.timestamps ? "input to GPU done" : "input to swap");
+            if(s.queries.droppedFrames() > 0)
+                out << "FRAME_PACING:: " << s.queries.droppedFrames() << " latency samples dropped, the GPU was more than " << FRAMES << " frames behind" << std::endl;
+        }
+    }
+
+private:
+    // a frame's latency sample: a timestamp query when the GPU is done with it, and when its input was polled
+    typedef GpuQueryRing<int64_t> Samples;
+
+    struct State {
+        FramePacing pacing = PACING_VSYNC;
+        int64_t period = 0;             // ns between frame starts, 0 when not capped
+        int64_t deadline = 0;
+        int64_t frameStart = 0;
+        int64_t inputTime = 0;
+        bool measureLatency = false;
+        bool timestamps = false;
+        Samples queries;
+        GpuClock clock{&FramePacer::now};
+        FrameHistogram frameTimes;
+        FrameHistogram latency;
+    };
+
+    static State& state()
+    {
+        static State instance;
+        return instance;
+    }
+
+    static int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // sleeps most of the way and spins the rest: sleeping alone overshoots by up to a scheduler tick
+    static void wait()
+    {
+        State &s = state();
+        s.deadline = s.deadline == 0 ? now() + s.period : s.deadline + s.period;
+        const int64_t start = now();
+        if(s.deadline < start)
+        {
+            // late already: start counting from here instead of rushing the next frames
+            s.deadline = start;
+            return;
+        }
+        const int64_t margin = 1000000;
+        if(s.deadline - start > margin)
+            std::this_thread::sleep_for(std::chrono::nanoseconds(s.deadline - start - margin));
+        while(now() < s.deadline)
+            std::this_thread::yield();
+    }
+
+    // the previous frame was swapped: its latency ends when the GPU reaches this point
+    static void presented(int64_t swapped)
+    {
+        State &s = state();
+        if(!s.timestamps)
+        {
+            s.latency.add((swapped - s.inputTime) / 1e6);
+            return;
+        }
+        collect();
+        Samples::Frame &sample = s.queries.beginFrame();
+        glQueryCounter(sample.queries[s.queries.query()], GL_TIMESTAMP);
+        sample.data = s.inputTime;
+        s.queries.endFrame();
+        s.clock.frame();
+    }
+
+    // reads back the samples the GPU is done with, oldest first, never waits
+    static void collect()
+    {
+        state().queries.resolve(addLatency);
+    }
+
+    // from the input of a frame to the GPU being done with it
+    static void addLatency(Samples::Frame &sample)
+    {
+        State &s = state();
+        s.latency.add((s.clock.toCpu(Samples::result(sample, 0)) - sample.data) / 1e6);
+    }
+};
+#endif
@@ -0,0 +1,156 @@
+#ifndef GL_HANDLE_H
+#define GL_HANDLE_H
+
+#include <glad/glad.h>
+
+#include <learnopengl/gl_state.h>
+
+// A GL object owned by a C++ object: created by create() (or adopted from a raw name), deleted when the handle is
+// destroyed or reset, and moved rather than copied, so a name can neither leak nor be deleted twice.
+//
+//     GLBuffer vbo;
+//     vbo.create();
+//     glBindBuffer(GL_ARRAY_BUFFER, vbo.get());
+//     ...
+//     vector<GLBuffer> buffers;
+//     buffers.push_back(std::move(vbo));  // vbo is empty now, the vector deletes the buffer
+//
+// Deleting a bound vertex array or texture also clears it from the GL state cache (see gl_state.h). Handles
+// destroyed after the context (e.g. locals of main() after `return Application::terminate();`) delete nothing:
+// their objects went with the context.
+
+// whether the GL context the handles were created in still exists
+class GLContext
+{
+public:
+    static bool exists()
+    {
+        return state();
+    }
+
+    // before the context is destroyed (Application::terminate() does it)
+    static void destroyed()
+    {
+        state() = false;
+    }
+
+    // once a new context is current
+    static void created()
+    {
+        state() = true;
+    }
+
+private:
+    // true by default, for contexts not made by Application (benchmarks, tools)
+    static bool& state()
+    {
+        static bool instance = true;
+        return instance;
+    }
+};
+
+template<typename Traits>
+class GLHandle
+{
+public:
+    GLHandle() : name(0)
+    {
+    }
+
+    // takes ownership of a name created elsewhere (e.g. by TextureFromFile)
+    explicit GLHandle(GLuint adopted) : name(adopted)
+    {
+    }
+
+    ~GLHandle()
+    {
+        reset();
+    }
+
+    GLHandle(GLHandle &&other) noexcept : name(other.name)
+    {
+        other.name = 0;
+    }
+
+    GLHandle& operator=(GLHandle &&other) noexcept
+    {
+        if(this != &other)
+        {
+            reset();
+            name = other.name;
+            other.name = 0;
+        }
+        return *this;
+    }
+
+    GLHandle(const GLHandle &) = delete;
+    GLHandle& operator=(const GLHandle &) = delete;
+
+    // deletes the current object, if any, and creates a new one
+    GLuint create()
+    {
+        reset();
+        Traits::create(name);
+        return name;
+    }
+
+    // deletes the object now (forgets it if the context is gone)
+    void reset(GLuint adopted = 0)
+    {
+        if(name && GLContext::exists())
+            Traits::destroy(name);
+        name = adopted;
+    }
+
+    // gives up ownership without deleting the object
+    GLuint release()
+    {
+        GLuint released = name;
+        name = 0;
+        return released;
+    }
+
+    GLuint get() const { return name; }
+    explicit operator bool() const { return name != 0; }
+
+private:
+    GLuint name;
+};
+
+struct GLBufferTraits
+{
+    static void create(GLuint &name) { glGenBuffers(1, &name); }
+    static void destroy(GLuint name) { glDeleteBuffers(1, &name); }
+};
+
+struct GLVertexArrayTraits
+{
+    static void create(GLuint &name) { glGenVertexArrays(1, &name); }
+    static void destroy(GLuint name)
+    {
+        glDeleteVertexArrays(1, &name);
+        GLState::vertexArrayDeleted(name);
+    }
+};
+
+struct GLTextureTraits
+{
+    static void create(GLuint &name) { glGenTextures(1, &name); }
+    static void destroy(GLuint name)
+    {
+        glDeleteTextures(1, &name);
+        GLState::textureDeleted(name);
+    }
+};
+
+struct GLFramebufferTraits
+{
+    static void create(GLuint &name) { glGenFramebuffers(1, &name); }
+    static void destroy(GLuint name) { glDeleteFramebuffers(1, &name); }
+};
+
+typedef GLHandle<GLBufferTraits>      GLBuffer;
+typedef GLHandle<GLVertexArrayTraits> GLVertexArray;
+typedef GLHandle<GLTextureTraits>     GLTexture;
+typedef GLHandle<GLFramebufferTraits> GLFramebuffer;
+#endif
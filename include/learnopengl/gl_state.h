@@ -0,0 +1,371 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h>
+
+#include <iostream>
+
+// Shadow of the GL state the helpers bind over and over (program, vertex array, texture units, depth and blend
+// state): the calls below only reach GL when the value changes, and return whether they did.
+//
+//     GLState::useProgram(shader.ID);
+//     GLState::bindTextureUnit(0, GL_TEXTURE_2D, texture);
+//     GLState::bindVertexArray(VAO);
+//
+// The shadow starts unknown, so the first call always goes through. Code that changes the same state with raw gl*
+// calls afterwards must call GLState::invalidate(), and code that deletes a bound vertex array or texture must tell
+// the cache (GL unbinds them). With LEARNOPENGL_GL_STATE_VERIFY (cmake -DVERIFY_GL_STATE=ON) every cached call
+// first checks its shadow against glGet* and reports the mismatches, and Headless checks the whole shadow once a
+// frame: slow, for debugging the places that bypass the cache.
+class GLState
+{
+public:
+    static const unsigned int MAX_TEXTURE_UNITS = 32;
+
+    static bool useProgram(GLuint program)
+    {
+        State &s = state();
+#ifdef LEARNOPENGL_GL_STATE_VERIFY
+        check("GL_CURRENT_PROGRAM", GL_CURRENT_PROGRAM, s.program);
+#endif
+        if(s.program == program)
+            return skip();
+        s.program = program;
+        glUseProgram(program);
+        return issue();
+    }
+
+    static bool bindVertexArray(GLuint vertexArray)
+    {
+        State &s = state();
+#ifdef LEARNOPENGL_GL_STATE_VERIFY
+        check("GL_VERTEX_ARRAY_BINDING", GL_VERTEX_ARRAY_BINDING, s.vertexArray);
+#endif
+        if(s.vertexArray == vertexArray)
+            return skip();
+        s.vertexArray = vertexArray;
+        glBindVertexArray(vertexArray);
+        return issue();
+    }
+
+    // unit is GL_TEXTURE0 + i, like glActiveTexture
+    static bool activeTexture(GLenum unit)
+    {
+        State &s = state();
+#ifdef LEARNOPENGL_GL_STATE_VERIFY
+        check("GL_ACTIVE_TEXTURE", GL_ACTIVE_TEXTURE, s.activeTexture);
+#endif
+        if(s.activeTexture == unit)
+            return skip();
+        s.activeTexture = unit;
+        glActiveTexture(unit);
+        return issue();
+    }
+
+    // binds to the active unit
+    static bool bindTexture(GLenum target, GLuint texture)
+    {
+        State &s = state();
+        GLuint* binding = textureBinding(s.activeTexture, target);
+        if(!binding)
+        {
+            // a target or unit that isn't cached
+            glBindTexture(target, texture);
+            return issue();
+        }
+#ifdef LEARNOPENGL_GL_STATE_VERIFY
+        check("GL_TEXTURE_BINDING", textureBindingQuery(target), *binding);
+#endif
+        if(*binding == texture)
+            return skip();
+        *binding = texture;
+        glBindTexture(target, texture);
+        return issue();
+    }
+
+    // binds to unit GL_TEXTURE0 + unit; when the texture is already there the active unit is left alone
+    static bool bindTextureUnit(unsigned int unit, GLenum target, GLuint texture)
+    {
+        GLuint* binding = textureBinding(GL_TEXTURE0 + unit, target);
+        if(binding && *binding == texture)
+            return skip();
+        activeTexture(GL_TEXTURE0 + unit);
+        return bindTexture(target, texture);
+    }
+
+    // glEnable / glDisable, cached for the capabilities below
+    static bool setEnabled(GLenum capability, bool enabled)
+    {
+        int* shadow = capabilityState(capability);
+        if(!shadow)
+        {
+            if(enabled)
+                glEnable(capability);
+            else
+                glDisable(capability);
+            return issue();
+        }
+#ifdef LEARNOPENGL_GL_STATE_VERIFY
+        checkCapability(capability, *shadow);
+#endif
+        if(*shadow == (enabled ? 1 : 0))
+            return skip();
+        *shadow = enabled ? 1 : 0;
+        if(enabled)
+            glEnable(capability);
+        else
+            glDisable(capability);
+        return issue();
+    }
+
+    static bool enable(GLenum capability)
+    {
+        return setEnabled(capability, true);
+    }
+
+    static bool disable(GLenum capability)
+    {
+        return setEnabled(capability, false);
+    }
+
+    static bool depthFunc(GLenum func)
+    {
+        State &s = state();
+#ifdef LEARNOPENGL_GL_STATE_VERIFY
+        check("GL_DEPTH_FUNC", GL_DEPTH_FUNC, s.depthFunc);
+#endif
+        if(s.depthFunc == func)
+            return skip();
+        s.depthFunc = func;
+        glDepthFunc(func);
+        return issue();
+    }
+
+    static bool depthMask(GLboolean write)
+    {
+        State &s = state();
+#ifdef LEARNOPENGL_GL_STATE_VERIFY
+        check("GL_DEPTH_WRITEMASK", GL_DEPTH_WRITEMASK, s.depthMask);
+#endif
+        if(s.depthMask == static_cast<GLuint>(write))
+            return skip();
+        s.depthMask = write;
+        glDepthMask(write);
+        return issue();
+    }
+
+    static bool blendFunc(GLenum source, GLenum destination)
+    {
+        State &s = state();
+#ifdef LEARNOPENGL_GL_STATE_VERIFY
+        check("GL_BLEND_SRC_RGB", GL_BLEND_SRC_RGB, s.blendSource);
+        check("GL_BLEND_DST_RGB", GL_BLEND_DST_RGB, s.blendDestination);
+#endif
+        if(s.blendSource == source && s.blendDestination == destination)
+            return skip();
+        s.blendSource = source;
+        s.blendDestination = destination;
+        glBlendFunc(source, destination);
+        return issue();
+    }
+
+    // GL deletes bound objects by unbinding them first
+    static void vertexArrayDeleted(GLuint vertexArray)
+    {
+        State &s = state();
+        if(s.vertexArray == vertexArray)
+            s.vertexArray = 0;
+    }
+
+    static void textureDeleted(GLuint texture)
+    {
+        State &s = state();
+        for(unsigned int unit = 0; unit < MAX_TEXTURE_UNITS; unit++)
+            for(unsigned int target = 0; target < TEXTURE_TARGETS; target++)
+                if(s.textures[unit][target] == texture)
+                    s.textures[unit][target] = 0;
+    }
+
+    // forget everything, e.g. after code that changed the state with raw gl* calls or on a new context
+    static void invalidate()
+    {
+        State &s = state();
+        s.program = s.vertexArray = s.activeTexture = UNKNOWN;
+        for(unsigned int unit = 0; unit < MAX_TEXTURE_UNITS; unit++)
+            for(unsigned int target = 0; target < TEXTURE_TARGETS; target++)
+                s.textures[unit][target] = UNKNOWN;
+        for(unsigned int i = 0; i < CAPABILITIES; i++)
+            s.capabilities[i] = UNKNOWN_CAPABILITY;
+        s.depthFunc = s.depthMask = s.blendSource = s.blendDestination = UNKNOWN;
+    }
+
+    // compares the whole shadow with glGet*, reports and forgets what doesn't match; false if anything didn't
+    static bool verify()
+    {
+        State &s = state();
+        const unsigned long long before = s.mismatches;
+        check("GL_CURRENT_PROGRAM", GL_CURRENT_PROGRAM, s.program);
+        check("GL_VERTEX_ARRAY_BINDING", GL_VERTEX_ARRAY_BINDING, s.vertexArray);
+        check("GL_DEPTH_FUNC", GL_DEPTH_FUNC, s.depthFunc);
+        check("GL_DEPTH_WRITEMASK", GL_DEPTH_WRITEMASK, s.depthMask);
+        check("GL_BLEND_SRC_RGB", GL_BLEND_SRC_RGB, s.blendSource);
+        check("GL_BLEND_DST_RGB", GL_BLEND_DST_RGB, s.blendDestination);
+        for(unsigned int i = 0; i < CAPABILITIES; i++)
+            checkCapability(capabilityEnum(i), s.capabilities[i]);
+        // the texture bindings need each unit made active in turn
+        GLint active = 0;
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &active);
+        for(unsigned int unit = 0; unit < MAX_TEXTURE_UNITS; unit++)
+        {
+            bool known = false;
+            for(unsigned int target = 0; target < TEXTURE_TARGETS; target++)
+                known = known || s.textures[unit][target] != UNKNOWN;
+            if(!known)
+                continue;
+            glActiveTexture(GL_TEXTURE0 + unit);
+            for(unsigned int target = 0; target < TEXTURE_TARGETS; target++)
+                check("GL_TEXTURE_BINDING", textureBindingQuery(textureTarget(target)), s.textures[unit][target]);
+        }
+        glActiveTexture(static_cast<GLenum>(active));
+        check("GL_ACTIVE_TEXTURE", GL_ACTIVE_TEXTURE, s.activeTexture);
+        return s.mismatches == before;
+    }
+
+    // calls that reached GL and calls the cache saved, since the start
+    static unsigned long long issuedCalls()
+    {
+        return state().issued;
+    }
+
+    static unsigned long long skippedCalls()
+    {
+        return state().skipped;
+    }
+
+    static unsigned long long mismatches()
+    {
+        return state().mismatches;
+    }
+
+private:
+    static const GLuint UNKNOWN = 0xffffffffu;
+    static const int UNKNOWN_CAPABILITY = -1;
+    static const unsigned int TEXTURE_TARGETS = 4;
+    static const unsigned int CAPABILITIES = 6;
+
+    struct State {
+        GLuint program = UNKNOWN;
+        GLuint vertexArray = UNKNOWN;
+        GLuint activeTexture = UNKNOWN;
+        GLuint textures[MAX_TEXTURE_UNITS][TEXTURE_TARGETS];
+        int capabilities[CAPABILITIES];     // 0, 1 or UNKNOWN_CAPABILITY
+        GLuint depthFunc = UNKNOWN;
+        GLuint depthMask = UNKNOWN;
+        GLuint blendSource = UNKNOWN;
+        GLuint blendDestination = UNKNOWN;
+        unsigned long long issued = 0;
+        unsigned long long skipped = 0;
+        unsigned long long mismatches = 0;
+
+        State()
+        {
+            for(unsigned int unit = 0; unit < MAX_TEXTURE_UNITS; unit++)
+                for(unsigned int target = 0; target < TEXTURE_TARGETS; target++)
+                    textures[unit][target] = UNKNOWN;
+            for(unsigned int i = 0; i < CAPABILITIES; i++)
+                capabilities[i] = UNKNOWN_CAPABILITY;
+        }
+    };
+
+    static State& state()
+    {
+        static State instance;
+        return instance;
+    }
+
+    static bool issue()
+    {
+        state().issued++;
+        return true;
+    }
+
+    static bool skip()
+    {
+        state().skipped++;
+        return false;
+    }
+
+    static GLenum textureTarget(unsigned int index)
+    {
+        static const GLenum targets[TEXTURE_TARGETS] = { GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_3D };
+        return targets[index];
+    }
+
+    static GLenum textureBindingQuery(GLenum target)
+    {
+        switch(target)
+        {
+        case GL_TEXTURE_CUBE_MAP: return GL_TEXTURE_BINDING_CUBE_MAP;
+        case GL_TEXTURE_2D_ARRAY: return GL_TEXTURE_BINDING_2D_ARRAY;
+        case GL_TEXTURE_3D:       return GL_TEXTURE_BINDING_3D;
+        default:                  return GL_TEXTURE_BINDING_2D;
+        }
+    }
+
+    // the shadow of a (unit, target) binding, NULL if not cached
+    static GLuint* textureBinding(GLenum unit, GLenum target)
+    {
+        if(unit < GL_TEXTURE0 || unit >= GL_TEXTURE0 + MAX_TEXTURE_UNITS)
+            return nullptr;
+        for(unsigned int i = 0; i < TEXTURE_TARGETS; i++)
+            if(textureTarget(i) == target)
+                return &state().textures[unit - GL_TEXTURE0][i];
+        return nullptr;
+    }
+
+    static GLenum capabilityEnum(unsigned int index)
+    {
+        static const GLenum capabilities[CAPABILITIES] = { GL_DEPTH_TEST, GL_BLEND, GL_CULL_FACE, GL_STENCIL_TEST, GL_SCISSOR_TEST, GL_FRAMEBUFFER_SRGB };
+        return capabilities[index];
+    }
+
+    static int* capabilityState(GLenum capability)
+    {
+        for(unsigned int i = 0; i < CAPABILITIES; i++)
+            if(capabilityEnum(i) == capability)
+                return &state().capabilities[i];
+        return nullptr;
+    }
+
+    // a known shadow value that GL disagrees with is reported and forgotten
+    static void check(const char* name, GLenum query, GLuint &shadow)
+    {
+        if(shadow == UNKNOWN)
+            return;
+        GLint actual = 0;
+        glGetIntegerv(query, &actual);
+        if(static_cast<GLuint>(actual) != shadow)
+        {
+            mismatch(name, static_cast<GLuint>(actual), shadow);
+            shadow = UNKNOWN;
+        }
+    }
+
+    static void mismatch(const char* name, GLuint actual, GLuint shadow)
+    {
+        state().mismatches++;
+        std::cout << "ERROR::GL_STATE::MISMATCH:: " << name << " " << actual << " is cached as " << shadow
+                  << ", a raw gl* call changed it" << std::endl;
+    }
+
+    static void checkCapability(GLenum capability, int &shadow)
+    {
+        if(shadow == UNKNOWN_CAPABILITY || (glIsEnabled(capability) != GL_FALSE) == (shadow != 0))
+            return;
+        state().mismatches++;
+        std::cout << "ERROR::GL_STATE::MISMATCH:: capability " << capability << " is cached as "
+                  << (shadow ? "enabled" : "disabled") << ", a raw gl* call changed it" << std::endl;
+        shadow = UNKNOWN_CAPABILITY;
+    }
+};
+#endif
@@ -0,0 +1,1029 @@
+#ifndef GL_TRACE_H
+#define GL_TRACE_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// GL call tracing over the glad loader: GLTrace::install() swaps the glad_gl* function pointers of the entry
+// points listed in GLTrace::hooks() for wrappers, so the code keeps calling gl* as usual. For every call it
+//  - counts it (per entry point, per frame and in total),
+//  - flags it as redundant when it binds or sets what is already bound or set (programs, vertex arrays, buffers,
+//    textures, framebuffers, capabilities, fixed function state and uniform values),
+//  - and, with a trace file open, writes it with its data (buffer contents, uniforms, shader sources, pixels), so
+//    that GLTraceReplay can play the frames again on another context (benchmarks/gl_replay.cpp).
+//
+//     GLTrace::install();                // once the GL functions are loaded
+//     GLTrace::open("frames.gltrace");   // optional
+//     while (...)
+//     {
+//         ...
+//         GLTrace::frame();              // Headless::shouldClose does it
+//     }
+//     GLTrace::report(std::cout);
+//
+// Headless runs do all of this with --gl-trace FILE (see headless.h). It is a debugging layer: every call goes
+// through the wrapper, and while a file is open every call is formatted as text.
+//
+// The trace is one call per line: the entry point and its arguments, "= value" for what it returned and
+// "# redundant" when flagged. Pointers are @offset (into the bound buffer), <hex> data or [names]; "frame N"
+// starts each frame, frame 0 being everything before the first GLTrace::frame().
+
+enum GLTraceArgKind {
+    TRACE_VALUE,            // integer or float, as is
+    TRACE_NAME,             // an object name, remapped on replay
+    TRACE_OFFSET,           // pointer argument that is an offset into a bound buffer
+    TRACE_DATA,             // input data: size bytes times the count argument (or size bytes when count < 0)
+    TRACE_IMAGE,            // pixels: width at count, height after it, format and type right before the pointer
+    TRACE_STRING,           // zero terminated string
+    TRACE_SOURCE_COUNT,     // glShaderSource: the strings are joined, so the count is written as 1 ...
+    TRACE_SOURCE,           // ... the joined strings ...
+    TRACE_SOURCE_LENGTHS,   // ... and the lengths as NULL
+    TRACE_OUT,              // output, not written
+    TRACE_GEN_NAMES,        // count new names written to the pointer
+    TRACE_DELETE_NAMES      // count names read from the pointer
+};
+
+enum GLTraceNames {
+    TRACE_NAMES_NONE,
+    TRACE_BUFFERS,
+    TRACE_TEXTURES,
+    TRACE_VERTEX_ARRAYS,
+    TRACE_FRAMEBUFFERS,
+    TRACE_RENDERBUFFERS,
+    TRACE_PROGRAMS,         // shaders and programs share their names
+    TRACE_QUERIES
+};
+
+// how a call changes the state it can be redundant with
+enum GLTraceState {
+    TRACE_STATE_NONE,
+    TRACE_STATE_PROGRAM,
+    TRACE_STATE_VERTEX_ARRAY,
+    TRACE_STATE_BUFFER,         // target, the element array binding belongs to the bound vertex array
+    TRACE_STATE_ACTIVE_TEXTURE,
+    TRACE_STATE_TEXTURE,        // active unit and target
+    TRACE_STATE_FRAMEBUFFER,
+    TRACE_STATE_BIND,           // other (target, name) bindings
+    TRACE_STATE_ENABLE,
+    TRACE_STATE_DISABLE,
+    TRACE_STATE_SET,            // keyed by the first `keys` arguments, the others are the value
+    TRACE_STATE_UNIFORM,        // current program and location
+    TRACE_STATE_LINK,           // forgets the uniforms of the program
+    TRACE_STATE_DELETE          // forgets the bindings of the deleted names
+};
+
+struct GLTraceArg {
+    GLTraceArgKind kind;
+    GLTraceNames names;
+    int count;
+    size_t size;
+};
+
+enum GLTraceType {
+    TRACE_NONE,             // void result
+    TRACE_INT,
+    TRACE_FLOAT,
+    TRACE_POINTER
+};
+
+struct GLTraceValue {
+    GLTraceType type;
+    int64_t i;
+    double d;
+    const void* p;
+};
+
+class GLTraceReplay;
+
+// a traced entry point
+struct GLTraceEntry {
+    const char* name;
+    bool replayed;                      // false for queries (glGet*, ...), they change nothing
+    GLTraceState state;
+    unsigned int keys;                  // TRACE_STATE_SET
+    std::vector<GLTraceArg> args;
+    GLTraceNames returns;
+    void (*replay)(GLTraceReplay &replay, const std::vector<std::string> &tokens);
+    unsigned long long calls;           // this frame
+    unsigned long long redundant;
+    unsigned long long totalCalls;
+    unsigned long long totalRedundant;
+};
+
+// argument conversions, by type
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, GLTraceValue>::type traceValue(T v)
+{
+    GLTraceValue value = { TRACE_INT, static_cast<int64_t>(v), 0.0, nullptr };
+    return value;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, GLTraceValue>::type traceValue(T v)
+{
+    GLTraceValue value = { TRACE_FLOAT, 0, static_cast<double>(v), nullptr };
+    return value;
+}
+
+template <typename T>
+inline GLTraceValue traceValue(T* v)
+{
+    GLTraceValue value = { TRACE_POINTER, 0, 0.0, reinterpret_cast<const void*>(v) };
+    return value;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, T>::type fromTraceValue(const GLTraceValue &v)
+{
+    return static_cast<T>(v.i);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, T>::type fromTraceValue(const GLTraceValue &v)
+{
+    return static_cast<T>(v.d);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_pointer<T>::value, T>::type fromTraceValue(const GLTraceValue &v)
+{
+    return reinterpret_cast<T>(const_cast<void*>(v.p));
+}
+
+template <typename T>
+struct GLTraceTypeOf {
+    static const GLTraceType value = std::is_pointer<T>::value ? TRACE_POINTER : std::is_floating_point<T>::value ? TRACE_FLOAT : TRACE_INT;
+};
+
+// 0, 1, ..., N - 1 to expand the arguments of a replayed call (std::index_sequence is C++14)
+template <size_t... I> struct GLTraceIndices {};
+template <size_t N, size_t... I> struct GLTraceMakeIndices : GLTraceMakeIndices<N - 1, N - 1, I...> {};
+template <size_t... I> struct GLTraceMakeIndices<0, I...> { typedef GLTraceIndices<I...> type; };
+
+class GLTrace
+{
+public:
+    // wraps the entry points, call once the GL functions are loaded
+    static void install()
+    {
+        State &s = state();
+        if(s.installed)
+            return;
+        hooks(true);
+        s.installed = true;
+        std::cout << "GL_TRACE:: tracing " << s.entries.size() << " entry points" << std::endl;
+    }
+
+    static bool installed()
+    {
+        return state().installed;
+    }
+
+    // writes every following call to path
+    static bool open(const std::string &path)
+    {
+        State &s = state();
+        s.file.close();
+        s.file.clear();
+        s.file.open(path.c_str());
+        if(!s.file)
+        {
+            std::cout << "ERROR::GL_TRACE::FILE:: can't write " << path << std::endl;
+            return false;
+        }
+        s.file << "# LearnOpenGL GL trace 1\nframe " << s.frames << "\n";
+        return true;
+    }
+
+    static void close()
+    {
+        state().file.close();
+    }
+
+    // end of a frame: its counts move to the totals
+    static void frame()
+    {
+        State &s = state();
+        if(!s.installed)
+            return;
+        unsigned long long calls = 0, redundant = 0;
+        for(size_t i = 0; i < s.entries.size(); i++)
+        {
+            GLTraceEntry &entry = s.entries[i];
+            calls += entry.calls;
+            redundant += entry.redundant;
+            entry.totalCalls += entry.calls;
+            entry.totalRedundant += entry.redundant;
+            entry.calls = entry.redundant = 0;
+        }
+        s.lastCalls = calls;
+        s.lastRedundant = redundant;
+        s.frames++;
+        if(s.file.is_open())
+            s.file << "# " << calls << " calls, " << redundant << " redundant\nframe " << s.frames << "\n";
+    }
+
+    // calls and redundant calls of the last complete frame
+    static unsigned long long lastFrameCalls()
+    {
+        return state().lastCalls;
+    }
+
+    static unsigned long long lastFrameRedundant()
+    {
+        return state().lastRedundant;
+    }
+
+    static const std::vector<GLTraceEntry>& entries()
+    {
+        return state().entries;
+    }
+
+    // the entry points called so far, most called first
+    static void report(std::ostream &out, size_t top = 20)
+    {
+        State &s = state();
+        std::vector<const GLTraceEntry*> called;
+        unsigned long long calls = 0, redundant = 0;
+        for(size_t i = 0; i < s.entries.size(); i++)
+        {
+            const GLTraceEntry &entry = s.entries[i];
+            if(entry.totalCalls + entry.calls == 0)
+                continue;
+            called.push_back(&entry);
+            calls += entry.totalCalls + entry.calls;
+            redundant += entry.totalRedundant + entry.redundant;
+        }
+        for(size_t i = 1; i < called.size(); i++)
+            for(size_t j = i; j > 0 && called[j]->totalCalls + called[j]->calls > called[j - 1]->totalCalls + called[j - 1]->calls; j--)
+                std::swap(called[j], called[j - 1]);
+        out << "GL_TRACE:: " << calls << " calls in " << s.frames << " frames, " << redundant << " redundant" << std::endl;
+        for(size_t i = 0; i < called.size() && i < top; i++)
+        {
+            out << "GL_TRACE::   " << called[i]->name << " " << called[i]->totalCalls + called[i]->calls;
+            if(called[i]->totalRedundant + called[i]->redundant > 0)
+                out << " (" << called[i]->totalRedundant + called[i]->redundant << " redundant)";
+            out << std::endl;
+        }
+    }
+
+    // the entry points a trace can contain, registered without wrapping them (for GLTraceReplay)
+    static void registerEntries()
+    {
+        if(state().entries.empty())
+            hooks(false);
+    }
+
+    static const GLTraceEntry* find(const std::string &name)
+    {
+        State &s = state();
+        std::unordered_map<std::string, size_t>::const_iterator it = s.byName.find(name);
+        return it == s.byName.end() ? nullptr : &s.entries[it->second];
+    }
+
+    // called by the wrappers
+    static void before(unsigned int id, const GLTraceValue* values, size_t count)
+    {
+        State &s = state();
+        GLTraceEntry &entry = s.entries[id];
+        entry.calls++;
+        s.redundant = checkState(entry, values, count);
+        if(s.redundant)
+            entry.redundant++;
+    }
+
+    static void after(unsigned int id, const GLTraceValue* values, size_t count, const GLTraceValue &result)
+    {
+        State &s = state();
+        if(!s.file.is_open())
+            return;
+        const GLTraceEntry &entry = s.entries[id];
+        std::ostream &out = s.file;
+        out << entry.name;
+        for(size_t i = 0; i < count; i++)
+        {
+            out << ' ';
+            writeArg(out, entry, values, i);
+        }
+        if(result.type == TRACE_INT)
+            out << " = " << result.i;
+        if(s.redundant)
+            out << " # redundant";
+        out << '\n';
+    }
+
+    static const GLTraceArg& argument(const GLTraceEntry &entry, size_t i)
+    {
+        static const GLTraceArg value = { TRACE_VALUE, TRACE_NAMES_NONE, -1, 0 };
+        return i < entry.args.size() ? entry.args[i] : value;
+    }
+
+    // bytes of a glTexImage2D / glTexSubImage2D upload with the tracked unpack alignment
+    static size_t imageSize(GLsizei width, GLsizei height, GLenum format, GLenum type)
+    {
+        size_t channels = 4;
+        switch(format)
+        {
+        case GL_RED: case GL_RED_INTEGER: case GL_DEPTH_COMPONENT: case GL_STENCIL_INDEX: channels = 1; break;
+        case GL_RG: case GL_RG_INTEGER: case GL_DEPTH_STENCIL: channels = 2; break;
+        case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: channels = 3; break;
+        default: break;
+        }
+        size_t bytes = 1;
+        switch(type)
+        {
+        case GL_UNSIGNED_BYTE: case GL_BYTE: bytes = 1; break;
+        case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: bytes = 2; break;
+        case GL_UNSIGNED_INT_24_8: case GL_UNSIGNED_INT_8_8_8_8: case GL_UNSIGNED_INT_8_8_8_8_REV:
+        case GL_UNSIGNED_INT_2_10_10_10_REV: case GL_UNSIGNED_INT_10F_11F_11F_REV: case GL_UNSIGNED_INT_5_9_9_9_REV:
+            bytes = 4, channels = 1; break;
+        default: bytes = 4; break;
+        }
+        const size_t alignment = static_cast<size_t>(state().unpackAlignment);
+        const size_t row = (static_cast<size_t>(width) * channels * bytes + alignment - 1) / alignment * alignment;
+        return row * static_cast<size_t>(height);
+    }
+
+private:
+    struct Shadow {
+        uint64_t value;
+        GLTraceNames names;         // the object the binding refers to, forgotten when it's deleted
+        GLuint name;
+        GLuint program;             // uniforms, forgotten when the program is relinked
+    };
+
+    struct State {
+        bool installed = false;
+        std::vector<GLTraceEntry> entries;
+        std::unordered_map<std::string, size_t> byName;
+        std::unordered_map<uint64_t, Shadow> shadow;
+        GLuint program = 0;
+        GLuint vertexArray = 0;
+        GLuint activeTexture = GL_TEXTURE0;
+        GLint unpackAlignment = 4;
+        bool redundant = false;     // the call being traced
+        unsigned long long frames = 0;
+        unsigned long long lastCalls = 0;
+        unsigned long long lastRedundant = 0;
+        std::ofstream file;
+    };
+
+    static State& state()
+    {
+        static State instance;
+        return instance;
+    }
+
+    // the wrapper of one entry point: Slot is its glad_gl* pointer
+    template <typename F, F* Slot, typename R, typename... A>
+    struct Hook
+    {
+        static F real;
+        static unsigned int id;
+
+        static R APIENTRY call(A... args)
+        {
+            GLTraceValue values[sizeof...(A) + 1] = { traceValue(args)... };
+            GLTrace::before(id, values, sizeof...(A));
+            return forward(std::is_void<R>(), values, args...);
+        }
+
+        static R forward(std::false_type, const GLTraceValue* values, A... args)
+        {
+            R result = real(args...);
+            GLTrace::after(id, values, sizeof...(A), traceValue(result));
+            return result;
+        }
+
+        static R forward(std::true_type, const GLTraceValue* values, A... args)
+        {
+            real(args...);
+            GLTrace::after(id, values, sizeof...(A), GLTraceValue());
+        }
+
+        static void replay(GLTraceReplay &replay, const std::vector<std::string> &tokens);
+
+        // the call with parsed arguments, bypassing the wrapper
+        template <size_t... I>
+        static GLTraceValue invoke(std::false_type, const GLTraceValue* values, GLTraceIndices<I...>)
+        {
+            (void)values;
+            return traceValue((real ? real : *Slot)(fromTraceValue<A>(values[I])...));
+        }
+
+        template <size_t... I>
+        static GLTraceValue invoke(std::true_type, const GLTraceValue* values, GLTraceIndices<I...>)
+        {
+            (void)values;
+            (real ? real : *Slot)(fromTraceValue<A>(values[I])...);
+            return GLTraceValue();
+        }
+    };
+
+    template <typename F, F* Slot, typename R, typename... A>
+    static void addHook(R (APIENTRYP function)(A...), const char* name, bool replayed, GLTraceState state, unsigned int keys,
+                        GLTraceNames returns, std::initializer_list<GLTraceArg> args, bool wrap)
+    {
+        typedef Hook<F, Slot, R, A...> HookType;
+        State &s = GLTrace::state();
+        if(s.byName.find(name) == s.byName.end())
+        {
+            GLTraceEntry entry = { name, replayed, state, keys, std::vector<GLTraceArg>(args), returns, &HookType::replay, 0, 0, 0, 0 };
+            HookType::id = static_cast<unsigned int>(s.entries.size());
+            s.byName[name] = s.entries.size();
+            s.entries.push_back(entry);
+        }
+        // entry points the driver doesn't have stay NULL
+        if(wrap && function && function != &HookType::call)
+        {
+            HookType::real = function;
+            *Slot = &HookType::call;
+        }
+    }
+
+    static GLTraceArg value() { GLTraceArg a = { TRACE_VALUE, TRACE_NAMES_NONE, -1, 0 }; return a; }
+    static GLTraceArg name(GLTraceNames names) { GLTraceArg a = { TRACE_NAME, names, -1, 0 }; return a; }
+    static GLTraceArg offset() { GLTraceArg a = { TRACE_OFFSET, TRACE_NAMES_NONE, -1, 0 }; return a; }
+    static GLTraceArg data(int count, size_t size) { GLTraceArg a = { TRACE_DATA, TRACE_NAMES_NONE, count, size }; return a; }
+    static GLTraceArg image(int width) { GLTraceArg a = { TRACE_IMAGE, TRACE_NAMES_NONE, width, 0 }; return a; }
+    static GLTraceArg string() { GLTraceArg a = { TRACE_STRING, TRACE_NAMES_NONE, -1, 0 }; return a; }
+    static GLTraceArg out() { GLTraceArg a = { TRACE_OUT, TRACE_NAMES_NONE, -1, 0 }; return a; }
+    static GLTraceArg gen(GLTraceNames names) { GLTraceArg a = { TRACE_GEN_NAMES, names, 0, 0 }; return a; }
+    static GLTraceArg del(GLTraceNames names) { GLTraceArg a = { TRACE_DELETE_NAMES, names, 0, 0 }; return a; }
+    static GLTraceArg sourceCount() { GLTraceArg a = { TRACE_SOURCE_COUNT, TRACE_NAMES_NONE, -1, 0 }; return a; }
+    static GLTraceArg source() { GLTraceArg a = { TRACE_SOURCE, TRACE_NAMES_NONE, 1, 0 }; return a; }
+    static GLTraceArg sourceLengths() { GLTraceArg a = { TRACE_SOURCE_LENGTHS, TRACE_NAMES_NONE, -1, 0 }; return a; }
+
+// CALL changes state and is replayed, CREATE also returns a new name, SET is TRACE_STATE_SET and QUERY only reads
+// state; the arguments not listed are values
+#define GL_TRACE_HOOK(pointer, name, replayed, rule, keys, returns, ...) \
+    addHook<decltype(pointer), &pointer>(pointer, name, replayed, rule, keys, returns, { __VA_ARGS__ }, wrap)
+#define GL_TRACE_CALL(function, rule, ...) GL_TRACE_HOOK(glad_##function, #function, true, rule, 0, TRACE_NAMES_NONE, __VA_ARGS__)
+#define GL_TRACE_CREATE(function, returns) GL_TRACE_HOOK(glad_##function, #function, true, TRACE_STATE_NONE, 0, returns, value())
+#define GL_TRACE_SET(function, keys, ...) GL_TRACE_HOOK(glad_##function, #function, true, TRACE_STATE_SET, keys, TRACE_NAMES_NONE, __VA_ARGS__)
+#define GL_TRACE_QUERY(function, ...) GL_TRACE_HOOK(glad_##function, #function, false, TRACE_STATE_NONE, 0, TRACE_NAMES_NONE, __VA_ARGS__)
+#define GL_TRACE_NO_ARGS(function, replayed) \
+    addHook<decltype(glad_##function), &glad_##function>(glad_##function, #function, replayed, TRACE_STATE_NONE, 0, TRACE_NAMES_NONE, {}, wrap)
+
+    // the entry points used by the LearnOpenGL headers and exercises
+    static void hooks(bool wrap)
+    {
+        // objects
+        GL_TRACE_CALL(glGenBuffers, TRACE_STATE_NONE, value(), gen(TRACE_BUFFERS));
+        GL_TRACE_CALL(glDeleteBuffers, TRACE_STATE_DELETE, value(), del(TRACE_BUFFERS));
+        GL_TRACE_CALL(glGenVertexArrays, TRACE_STATE_NONE, value(), gen(TRACE_VERTEX_ARRAYS));
+        GL_TRACE_CALL(glDeleteVertexArrays, TRACE_STATE_DELETE, value(), del(TRACE_VERTEX_ARRAYS));
+        GL_TRACE_CALL(glGenTextures, TRACE_STATE_NONE, value(), gen(TRACE_TEXTURES));
+        GL_TRACE_CALL(glDeleteTextures, TRACE_STATE_DELETE, value(), del(TRACE_TEXTURES));
+        GL_TRACE_CALL(glGenFramebuffers, TRACE_STATE_NONE, value(), gen(TRACE_FRAMEBUFFERS));
+        GL_TRACE_CALL(glDeleteFramebuffers, TRACE_STATE_DELETE, value(), del(TRACE_FRAMEBUFFERS));
+        GL_TRACE_CALL(glGenRenderbuffers, TRACE_STATE_NONE, value(), gen(TRACE_RENDERBUFFERS));
+        GL_TRACE_CALL(glDeleteRenderbuffers, TRACE_STATE_DELETE, value(), del(TRACE_RENDERBUFFERS));
+        GL_TRACE_CALL(glGenQueries, TRACE_STATE_NONE, value(), gen(TRACE_QUERIES));
+        GL_TRACE_CALL(glDeleteQueries, TRACE_STATE_DELETE, value(), del(TRACE_QUERIES));
+
+        // shaders and programs
+        GL_TRACE_CREATE(glCreateShader, TRACE_PROGRAMS);
+        GL_TRACE_CALL(glShaderSource, TRACE_STATE_NONE, name(TRACE_PROGRAMS), sourceCount(), source(), sourceLengths());
+        GL_TRACE_CALL(glCompileShader, TRACE_STATE_NONE, name(TRACE_PROGRAMS));
+        GL_TRACE_CALL(glDeleteShader, TRACE_STATE_NONE, name(TRACE_PROGRAMS));
+        GL_TRACE_CREATE(glCreateProgram, TRACE_PROGRAMS);
+        GL_TRACE_CALL(glAttachShader, TRACE_STATE_NONE, name(TRACE_PROGRAMS), name(TRACE_PROGRAMS));
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+        GL_TRACE_CALL(glProgramParameteri, TRACE_STATE_NONE, name(TRACE_PROGRAMS));
+#endif
+        GL_TRACE_CALL(glLinkProgram, TRACE_STATE_LINK, name(TRACE_PROGRAMS));
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+        GL_TRACE_CALL(glProgramBinary, TRACE_STATE_LINK, name(TRACE_PROGRAMS), value(), data(3, 1), value());
+#endif
+        GL_TRACE_CALL(glDeleteProgram, TRACE_STATE_NONE, name(TRACE_PROGRAMS));
+        GL_TRACE_CALL(glUseProgram, TRACE_STATE_PROGRAM, name(TRACE_PROGRAMS));
+        GL_TRACE_QUERY(glGetShaderiv, name(TRACE_PROGRAMS), value(), out());
+        GL_TRACE_QUERY(glGetShaderInfoLog, name(TRACE_PROGRAMS), value(), out(), out());
+        GL_TRACE_QUERY(glGetProgramiv, name(TRACE_PROGRAMS), value(), out());
+        GL_TRACE_QUERY(glGetProgramInfoLog, name(TRACE_PROGRAMS), value(), out(), out());
+        GL_TRACE_QUERY(glGetUniformLocation, name(TRACE_PROGRAMS), string());
+
+        // uniforms (of the current program)
+        GL_TRACE_CALL(glUniform1i, TRACE_STATE_UNIFORM, value());
+        GL_TRACE_CALL(glUniform1f, TRACE_STATE_UNIFORM, value());
+        GL_TRACE_CALL(glUniform2f, TRACE_STATE_UNIFORM, value());
+        GL_TRACE_CALL(glUniform3f, TRACE_STATE_UNIFORM, value());
+        GL_TRACE_CALL(glUniform4f, TRACE_STATE_UNIFORM, value());
+        GL_TRACE_CALL(glUniform1iv, TRACE_STATE_UNIFORM, value(), value(), data(1, 4));
+        GL_TRACE_CALL(glUniform2iv, TRACE_STATE_UNIFORM, value(), value(), data(1, 8));
+        GL_TRACE_CALL(glUniform3iv, TRACE_STATE_UNIFORM, value(), value(), data(1, 12));
+        GL_TRACE_CALL(glUniform4iv, TRACE_STATE_UNIFORM, value(), value(), data(1, 16));
+        GL_TRACE_CALL(glUniform1uiv, TRACE_STATE_UNIFORM, value(), value(), data(1, 4));
+        GL_TRACE_CALL(glUniform2uiv, TRACE_STATE_UNIFORM, value(), value(), data(1, 8));
+        GL_TRACE_CALL(glUniform3uiv, TRACE_STATE_UNIFORM, value(), value(), data(1, 12));
+        GL_TRACE_CALL(glUniform4uiv, TRACE_STATE_UNIFORM, value(), value(), data(1, 16));
+        GL_TRACE_CALL(glUniform1fv, TRACE_STATE_UNIFORM, value(), value(), data(1, 4));
+        GL_TRACE_CALL(glUniform2fv, TRACE_STATE_UNIFORM, value(), value(), data(1, 8));
+        GL_TRACE_CALL(glUniform3fv, TRACE_STATE_UNIFORM, value(), value(), data(1, 12));
+        GL_TRACE_CALL(glUniform4fv, TRACE_STATE_UNIFORM, value(), value(), data(1, 16));
+        GL_TRACE_CALL(glUniformMatrix2fv, TRACE_STATE_UNIFORM, value(), value(), value(), data(1, 16));
+        GL_TRACE_CALL(glUniformMatrix3fv, TRACE_STATE_UNIFORM, value(), value(), value(), data(1, 36));
+        GL_TRACE_CALL(glUniformMatrix4fv, TRACE_STATE_UNIFORM, value(), value(), value(), data(1, 64));
+
+        // buffers and vertex arrays
+        GL_TRACE_CALL(glBindBuffer, TRACE_STATE_BUFFER, value(), name(TRACE_BUFFERS));
+        GL_TRACE_CALL(glBufferData, TRACE_STATE_NONE, value(), value(), data(1, 1), value());
+        GL_TRACE_CALL(glBufferSubData, TRACE_STATE_NONE, value(), value(), value(), data(2, 1));
+        GL_TRACE_CALL(glBindVertexArray, TRACE_STATE_VERTEX_ARRAY, name(TRACE_VERTEX_ARRAYS));
+        GL_TRACE_CALL(glEnableVertexAttribArray, TRACE_STATE_NONE, value());
+        GL_TRACE_CALL(glDisableVertexAttribArray, TRACE_STATE_NONE, value());
+        GL_TRACE_CALL(glVertexAttribPointer, TRACE_STATE_NONE, value(), value(), value(), value(), value(), offset());
+        GL_TRACE_CALL(glVertexAttribIPointer, TRACE_STATE_NONE, value(), value(), value(), value(), offset());
+        GL_TRACE_CALL(glVertexAttribDivisor, TRACE_STATE_NONE, value());
+        GL_TRACE_CALL(glVertexAttrib4fv, TRACE_STATE_NONE, value(), data(-1, 16));
+
+        // textures
+        GL_TRACE_CALL(glActiveTexture, TRACE_STATE_ACTIVE_TEXTURE, value());
+        GL_TRACE_CALL(glBindTexture, TRACE_STATE_TEXTURE, value(), name(TRACE_TEXTURES));
+        GL_TRACE_CALL(glTexParameteri, TRACE_STATE_NONE, value());
+        GL_TRACE_CALL(glTexImage2D, TRACE_STATE_NONE, value(), value(), value(), value(), value(), value(), value(), value(), image(3));
+        GL_TRACE_CALL(glTexSubImage2D, TRACE_STATE_NONE, value(), value(), value(), value(), value(), value(), value(), value(), image(4));
+        GL_TRACE_CALL(glGenerateMipmap, TRACE_STATE_NONE, value());
+        GL_TRACE_SET(glPixelStorei, 1, value());
+
+        // framebuffers
+        GL_TRACE_CALL(glBindFramebuffer, TRACE_STATE_FRAMEBUFFER, value(), name(TRACE_FRAMEBUFFERS));
+        GL_TRACE_CALL(glBindRenderbuffer, TRACE_STATE_BIND, value(), name(TRACE_RENDERBUFFERS));
+        GL_TRACE_CALL(glRenderbufferStorage, TRACE_STATE_NONE, value());
+        GL_TRACE_CALL(glFramebufferRenderbuffer, TRACE_STATE_NONE, value(), value(), value(), name(TRACE_RENDERBUFFERS));
+        GL_TRACE_CALL(glFramebufferTexture2D, TRACE_STATE_NONE, value(), value(), value(), name(TRACE_TEXTURES), value());
+        GL_TRACE_QUERY(glCheckFramebufferStatus, value());
+        GL_TRACE_CALL(glReadBuffer, TRACE_STATE_NONE, value());
+        GL_TRACE_QUERY(glReadPixels, value(), value(), value(), value(), value(), value(), out());
+
+        // fixed function state
+        GL_TRACE_CALL(glEnable, TRACE_STATE_ENABLE, value());
+        GL_TRACE_CALL(glDisable, TRACE_STATE_DISABLE, value());
+        GL_TRACE_SET(glViewport, 0, value());
+        GL_TRACE_SET(glClearColor, 0, value());
+        GL_TRACE_SET(glPolygonMode, 1, value());
+        GL_TRACE_SET(glDepthFunc, 0, value());
+        GL_TRACE_SET(glDepthMask, 0, value());
+        GL_TRACE_SET(glBlendFunc, 0, value());
+        GL_TRACE_SET(glCullFace, 0, value());
+
+        // drawing
+        GL_TRACE_CALL(glClear, TRACE_STATE_NONE, value());
+        GL_TRACE_CALL(glDrawArrays, TRACE_STATE_NONE, value());
+        GL_TRACE_CALL(glDrawElements, TRACE_STATE_NONE, value(), value(), value(), offset());
+        GL_TRACE_CALL(glDrawElementsBaseVertex, TRACE_STATE_NONE, value(), value(), value(), offset(), value());
+#if defined(GL_VERSION_4_3) || defined(GL_ARB_multi_draw_indirect)
+        GL_TRACE_CALL(glMultiDrawElementsIndirect, TRACE_STATE_NONE, value(), value(), offset(), value(), value());
+#endif
+        GL_TRACE_NO_ARGS(glFlush, true);
+        GL_TRACE_NO_ARGS(glFinish, true);
+
+        // queries
+        GL_TRACE_CALL(glBeginQuery, TRACE_STATE_NONE, value(), name(TRACE_QUERIES));
+        GL_TRACE_CALL(glEndQuery, TRACE_STATE_NONE, value());
+        GL_TRACE_CALL(glQueryCounter, TRACE_STATE_NONE, name(TRACE_QUERIES), value());
+        GL_TRACE_QUERY(glGetQueryObjectuiv, name(TRACE_QUERIES), value(), out());
+        GL_TRACE_QUERY(glGetQueryObjectui64v, name(TRACE_QUERIES), value(), out());
+        GL_TRACE_QUERY(glGetIntegerv, value(), out());
+        GL_TRACE_NO_ARGS(glGetError, false);
+    }
+
+#undef GL_TRACE_HOOK
+#undef GL_TRACE_CALL
+#undef GL_TRACE_CREATE
+#undef GL_TRACE_SET
+#undef GL_TRACE_QUERY
+#undef GL_TRACE_NO_ARGS
+
+    static uint64_t hash(uint64_t h, uint64_t value)
+    {
+        // FNV-1a, 8 bytes at a time
+        for(int i = 0; i < 8; i++)
+        {
+            h ^= (value >> (i * 8)) & 0xff;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    static uint64_t hashBytes(uint64_t h, const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for(size_t i = 0; i < size; i++)
+        {
+            h ^= bytes[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    static uint64_t hashValue(uint64_t h, const GLTraceValue &value)
+    {
+        uint64_t bits = static_cast<uint64_t>(value.i);
+        if(value.type == TRACE_FLOAT)
+            std::memcpy(&bits, &value.d, sizeof(bits));
+        return hash(h, bits);
+    }
+
+    static size_t dataSize(const GLTraceEntry &entry, const GLTraceArg &arg, const GLTraceValue* values)
+    {
+        if(arg.kind == TRACE_IMAGE)
+            return imageSize(static_cast<GLsizei>(values[arg.count].i), static_cast<GLsizei>(values[arg.count + 1].i),
+                             static_cast<GLenum>(values[entry.args.size() - 3].i), static_cast<GLenum>(values[entry.args.size() - 2].i));
+        return arg.count < 0 ? arg.size : static_cast<size_t>(values[arg.count].i) * arg.size;
+    }
+
+    // true when the call sets what is already set; updates the shadow state
+    static bool checkState(const GLTraceEntry &entry, const GLTraceValue* values, size_t count)
+    {
+        State &s = state();
+        const uint64_t seed = hash(14695981039346656037ull, entry.state);
+        switch(entry.state)
+        {
+        case TRACE_STATE_NONE:
+            return false;
+        case TRACE_STATE_PROGRAM:
+            s.program = static_cast<GLuint>(values[0].i);
+            return bind(seed, TRACE_PROGRAMS, s.program);
+        case TRACE_STATE_VERTEX_ARRAY:
+            s.vertexArray = static_cast<GLuint>(values[0].i);
+            return bind(seed, TRACE_VERTEX_ARRAYS, s.vertexArray);
+        case TRACE_STATE_BUFFER:
+        {
+            const GLenum target = static_cast<GLenum>(values[0].i);
+            const uint64_t key = hash(hash(seed, target), target == GL_ELEMENT_ARRAY_BUFFER ? s.vertexArray : 0);
+            return bind(key, TRACE_BUFFERS, static_cast<GLuint>(values[1].i));
+        }
+        case TRACE_STATE_ACTIVE_TEXTURE:
+            s.activeTexture = static_cast<GLuint>(values[0].i);
+            return set(seed, static_cast<uint64_t>(s.activeTexture));
+        case TRACE_STATE_TEXTURE:
+            return bind(hash(hash(seed, s.activeTexture), static_cast<uint64_t>(values[0].i)), TRACE_TEXTURES, static_cast<GLuint>(values[1].i));
+        case TRACE_STATE_FRAMEBUFFER:
+        {
+            const GLenum target = static_cast<GLenum>(values[0].i);
+            const GLuint framebuffer = static_cast<GLuint>(values[1].i);
+            bool redundant = true;
+            if(target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER)
+                redundant = bind(hash(seed, GL_READ_FRAMEBUFFER), TRACE_FRAMEBUFFERS, framebuffer) && redundant;
+            if(target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER)
+                redundant = bind(hash(seed, GL_DRAW_FRAMEBUFFER), TRACE_FRAMEBUFFERS, framebuffer) && redundant;
+            return redundant;
+        }
+        case TRACE_STATE_BIND:
+            return bind(hash(hash(seed, reinterpret_cast<uintptr_t>(entry.name)), static_cast<uint64_t>(values[0].i)),
+                        argument(entry, 1).names, static_cast<GLuint>(values[1].i));
+        case TRACE_STATE_ENABLE:
+        case TRACE_STATE_DISABLE:
+            return set(hash(hash(14695981039346656037ull, TRACE_STATE_ENABLE), static_cast<uint64_t>(values[0].i)),
+                       entry.state == TRACE_STATE_ENABLE ? 1 : 0);
+        case TRACE_STATE_SET:
+        {
+            uint64_t key = hash(seed, reinterpret_cast<uintptr_t>(entry.name)), value = 14695981039346656037ull;
+            for(size_t i = 0; i < count; i++)
+            {
+                if(i < entry.keys)
+                    key = hashValue(key, values[i]);
+                else
+                    value = hashValue(value, values[i]);
+            }
+            if(std::strcmp(entry.name, "glPixelStorei") == 0 && values[0].i == GL_UNPACK_ALIGNMENT)
+                s.unpackAlignment = static_cast<GLint>(values[1].i);
+            return set(key, value);
+        }
+        case TRACE_STATE_UNIFORM:
+        {
+            const uint64_t key = hash(hash(seed, s.program), static_cast<uint64_t>(values[0].i));
+            uint64_t value = hash(14695981039346656037ull, reinterpret_cast<uintptr_t>(entry.name));
+            for(size_t i = 1; i < count; i++)
+            {
+                const GLTraceArg &arg = argument(entry, i);
+                if(arg.kind == TRACE_DATA && values[i].p)
+                    value = hashBytes(value, values[i].p, dataSize(entry, arg, values));
+                else
+                    value = hashValue(value, values[i]);
+            }
+            std::pair<std::unordered_map<uint64_t, Shadow>::iterator, bool> it = s.shadow.insert(std::make_pair(key, Shadow()));
+            const bool redundant = !it.second && it.first->second.value == value;
+            Shadow shadow = { value, TRACE_NAMES_NONE, 0, s.program };
+            it.first->second = shadow;
+            return redundant;
+        }
+        case TRACE_STATE_LINK:
+        {
+            const GLuint program = static_cast<GLuint>(values[0].i);
+            for(std::unordered_map<uint64_t, Shadow>::iterator it = s.shadow.begin(); it != s.shadow.end();)
+                it = it->second.program == program ? s.shadow.erase(it) : ++it;
+            return false;
+        }
+        case TRACE_STATE_DELETE:
+        {
+            const GLTraceNames names = argument(entry, 1).names;
+            const GLuint* deleted = static_cast<const GLuint*>(values[1].p);
+            for(GLsizei i = 0; deleted && i < static_cast<GLsizei>(values[0].i); i++)
+            {
+                for(std::unordered_map<uint64_t, Shadow>::iterator it = s.shadow.begin(); it != s.shadow.end();)
+                    it = it->second.names == names && it->second.name == deleted[i] ? s.shadow.erase(it) : ++it;
+                if(names == TRACE_VERTEX_ARRAYS && s.vertexArray == deleted[i])
+                    s.vertexArray = 0;
+            }
+            return false;
+        }
+        }
+        return false;
+    }
+
+    static bool set(uint64_t key, uint64_t value)
+    {
+        State &s = state();
+        std::pair<std::unordered_map<uint64_t, Shadow>::iterator, bool> it = s.shadow.insert(std::make_pair(key, Shadow()));
+        const bool redundant = !it.second && it.first->second.value == value;
+        Shadow shadow = { value, TRACE_NAMES_NONE, 0, 0 };
+        it.first->second = shadow;
+        return redundant;
+    }
+
+    static bool bind(uint64_t key, GLTraceNames names, GLuint name)
+    {
+        State &s = state();
+        std::pair<std::unordered_map<uint64_t, Shadow>::iterator, bool> it = s.shadow.insert(std::make_pair(key, Shadow()));
+        const bool redundant = !it.second && it.first->second.value == name;
+        Shadow shadow = { name, names, name, 0 };
+        it.first->second = shadow;
+        return redundant;
+    }
+
+    static void writeHex(std::ostream &out, const void* data, size_t size)
+    {
+        static const char digits[] = "0123456789abcdef";
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        out << '<';
+        for(size_t i = 0; i < size; i++)
+            out << digits[bytes[i] >> 4] << digits[bytes[i] & 15];
+        out << '>';
+    }
+
+    static void writeArg(std::ostream &out, const GLTraceEntry &entry, const GLTraceValue* values, size_t i)
+    {
+        const GLTraceArg &arg = argument(entry, i);
+        const GLTraceValue &value = values[i];
+        switch(arg.kind)
+        {
+        case TRACE_SOURCE_COUNT:
+            out << 1;
+            return;
+        case TRACE_SOURCE:
+        {
+            const GLchar* const* strings = static_cast<const GLchar* const*>(value.p);
+            const GLint* lengths = static_cast<const GLint*>(values[i + 1].p);
+            std::string joined;
+            for(GLsizei s = 0; s < static_cast<GLsizei>(values[i - 1].i); s++)
+                joined += lengths && lengths[s] >= 0 ? std::string(strings[s], lengths[s]) : std::string(strings[s]);
+            writeHex(out, joined.c_str(), joined.size() + 1);
+            return;
+        }
+        case TRACE_STRING:
+            if(value.p)
+                writeHex(out, value.p, std::strlen(static_cast<const char*>(value.p)) + 1);
+            else
+                out << "@0";
+            return;
+        case TRACE_DATA:
+        case TRACE_IMAGE:
+            if(value.p)
+                writeHex(out, value.p, dataSize(entry, arg, values));
+            else
+                out << "@0";
+            return;
+        case TRACE_GEN_NAMES:
+        case TRACE_DELETE_NAMES:
+        {
+            const GLuint* names = static_cast<const GLuint*>(value.p);
+            out << '[';
+            for(GLsizei n = 0; names && n < static_cast<GLsizei>(values[arg.count].i); n++)
+                out << (n ? "," : "") << names[n];
+            out << ']';
+            return;
+        }
+        case TRACE_OFFSET:
+        case TRACE_SOURCE_LENGTHS:
+        case TRACE_OUT:
+            out << '@' << (arg.kind == TRACE_OFFSET ? reinterpret_cast<uintptr_t>(value.p) : 0);
+            return;
+        default:
+            break;
+        }
+        if(value.type == TRACE_FLOAT)
+        {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%.9g", value.d);
+            out << text;
+        }
+        else if(value.type == TRACE_POINTER)
+            out << '@' << reinterpret_cast<uintptr_t>(value.p);
+        else
+            out << value.i;
+    }
+};
+
+template <typename F, F* Slot, typename R, typename... A>
+F GLTrace::Hook<F, Slot, R, A...>::real = nullptr;
+
+template <typename F, F* Slot, typename R, typename... A>
+unsigned int GLTrace::Hook<F, Slot, R, A...>::id = 0;
+
+// Plays the frames of a trace written by GLTrace on the current context. The objects it creates get new names,
+// the calls that use them are remapped.
+class GLTraceReplay
+{
+public:
+    bool load(const std::string &path)
+    {
+        std::ifstream file(path.c_str());
+        if(!file)
+        {
+            std::cout << "ERROR::GL_TRACE::REPLAY:: can't read " << path << std::endl;
+            return false;
+        }
+        GLTrace::registerEntries();
+        frames.clear();
+        std::string line;
+        size_t number = 0, unknown = 0;
+        while(std::getline(file, line))
+        {
+            number++;
+            const size_t comment = line.find('#');
+            if(comment != std::string::npos)
+                line.erase(comment);
+            std::istringstream words(line);
+            Call call;
+            std::string word;
+            if(!(words >> word))
+                continue;
+            if(word == "frame")
+            {
+                frames.push_back(std::vector<Call>());
+                continue;
+            }
+            call.entry = GLTrace::find(word);
+            if(!call.entry)
+            {
+                if(unknown++ == 0)
+                    std::cout << "ERROR::GL_TRACE::REPLAY:: line " << number << ": unknown entry point " << word << std::endl;
+                continue;
+            }
+            while(words >> word)
+                call.tokens.push_back(word);
+            if(!call.entry->replayed)
+                continue;
+            if(frames.empty())
+                frames.push_back(std::vector<Call>());
+            frames.back().push_back(call);
+        }
+        return true;
+    }
+
+    // frame 0 is the setup before the first frame
+    size_t frameCount() const
+    {
+        return frames.size();
+    }
+
+    size_t callCount(size_t frame) const
+    {
+        return frames[frame].size();
+    }
+
+    void playFrame(size_t frame)
+    {
+        for(size_t i = 0; i < frames[frame].size(); i++)
+        {
+            const Call &call = frames[frame][i];
+            call.entry->replay(*this, call.tokens);
+        }
+    }
+
+    // argument i of the call being replayed, from its token
+    GLTraceValue parse(const GLTraceEntry &entry, size_t i, GLTraceType type, const std::vector<std::string> &tokens)
+    {
+        GLTraceValue value = { type, 0, 0.0, nullptr };
+        if(i >= tokens.size())
+            return value;
+        const std::string &token = tokens[i];
+        const GLTraceArg &arg = GLTrace::argument(entry, i);
+        if(token[0] == '<')
+        {
+            blobs.push_back(std::vector<unsigned char>());
+            std::vector<unsigned char> &blob = blobs.back();
+            for(size_t c = 1; c + 1 < token.size(); c += 2)
+                blob.push_back(static_cast<unsigned char>(std::strtoul(token.substr(c, 2).c_str(), nullptr, 16)));
+            value.p = blob.empty() ? nullptr : &blob[0];
+            if(arg.kind == TRACE_SOURCE)
+            {
+                // glShaderSource takes an array of strings
+                sources.push_back(reinterpret_cast<const GLchar*>(value.p));
+                value.p = &sources.back();
+            }
+        }
+        else if(token[0] == '[')
+        {
+            names.push_back(std::vector<GLuint>());
+            std::vector<GLuint> &list = names.back();
+            std::istringstream items(token.substr(1, token.size() - 2));
+            std::string item;
+            while(std::getline(items, item, ','))
+            {
+                const GLuint name = static_cast<GLuint>(std::strtoul(item.c_str(), nullptr, 10));
+                list.push_back(arg.kind == TRACE_DELETE_NAMES ? map(arg.names, name) : name);
+            }
+            generated.push_back(list);
+            value.p = list.empty() ? nullptr : &list[0];
+        }
+        else if(token[0] == '@')
+            value.p = reinterpret_cast<const void*>(static_cast<uintptr_t>(std::strtoull(token.c_str() + 1, nullptr, 10)));
+        else if(type == TRACE_FLOAT)
+            value.d = std::strtod(token.c_str(), nullptr);
+        else
+        {
+            value.i = std::strtoll(token.c_str(), nullptr, 10);
+            if(arg.kind == TRACE_NAME)
+                value.i = map(arg.names, static_cast<GLuint>(value.i));
+        }
+        return value;
+    }
+
+    // after the call: the names it created replace the traced ones
+    void finish(const GLTraceEntry &entry, const std::vector<std::string> &tokens, const GLTraceValue* values, const GLTraceValue &result)
+    {
+        size_t list = 0;
+        for(size_t i = 0; i < tokens.size(); i++)
+        {
+            if(tokens[i][0] != '[')
+                continue;
+            const GLTraceArg &arg = GLTrace::argument(entry, i);
+            if(arg.kind == TRACE_GEN_NAMES)
+            {
+                const GLuint* created = static_cast<const GLuint*>(values[i].p);
+                for(size_t n = 0; n < generated[list].size(); n++)
+                    mapping[std::make_pair(arg.names, generated[list][n])] = created[n];
+            }
+            list++;
+        }
+        if(entry.returns != TRACE_NAMES_NONE && result.type == TRACE_INT)
+        {
+            for(size_t i = 0; i + 1 < tokens.size(); i++)
+                if(tokens[i] == "=")
+                    mapping[std::make_pair(entry.returns, static_cast<GLuint>(std::strtoul(tokens[i + 1].c_str(), nullptr, 10)))] = static_cast<GLuint>(result.i);
+        }
+        blobs.clear();
+        names.clear();
+        sources.clear();
+        generated.clear();
+    }
+
+private:
+    struct Call {
+        const GLTraceEntry* entry = nullptr;
+        std::vector<std::string> tokens;
+    };
+
+    std::vector<std::vector<Call> > frames;
+    std::map<std::pair<GLTraceNames, GLuint>, GLuint> mapping;
+    // the arguments of the call being replayed
+    std::vector<std::vector<unsigned char> > blobs;
+    std::vector<std::vector<GLuint> > names;
+    std::vector<const GLchar*> sources;
+    std::vector<std::vector<GLuint> > generated;
+
+    GLuint map(GLTraceNames space, GLuint name) const
+    {
+        std::map<std::pair<GLTraceNames, GLuint>, GLuint>::const_iterator it = mapping.find(std::make_pair(space, name));
+        return it == mapping.end() ? name : it->second;
+    }
+};
+
+template <typename F, F* Slot, typename R, typename... A>
+void GLTrace::Hook<F, Slot, R, A...>::replay(GLTraceReplay &replay, const std::vector<std::string> &tokens)
+{
+    static const GLTraceType types[sizeof...(A) + 1] = { GLTraceTypeOf<A>::value... };
+    const GLTraceEntry &entry = GLTrace::state().entries[id];
+    GLTraceValue values[sizeof...(A) + 1];
+    for(size_t i = 0; i < sizeof...(A); i++)
+        values[i] = replay.parse(entry, i, types[i], tokens);
+    replay.finish(entry, tokens, values, invoke(std::is_void<R>(), values, typename GLTraceMakeIndices<sizeof...(A)>::type()));
+}
+#endif
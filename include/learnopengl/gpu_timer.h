@@ -0,0 +1,253 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <glad/glad.h>
+
+#include <learnopengl/gpu_timestamps.h>
+#include <learnopengl/profiler.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// GPU time of the passes of a frame, measured with timer queries:
+//
+//     GpuTimer::init();                   // once the GL functions are loaded
+//     while (!Headless::shouldClose(window))
+//     {
+//         {
+//             GPU_ZONE("draw");           // the GL commands issued until the end of the scope
+//             ...
+//         }
+//         GpuTimer::frame();              // before swapping
+//     }
+//
+// The queries of a frame are read back when the GPU is done with them, up to FRAMES - 1 frames later, and never
+// waited for: if the GPU is further behind, that frame's timings are dropped (see gpu_timestamps.h). GpuTimer::results() are the zones of
+// the latest frame read back; with the CPU profiler on (see profiler.h) they also go to its "GPU" timeline and
+// summary, as "gpu <zone>".
+//
+// With GL_TIMESTAMP counters zones can nest and are placed on the timeline when the GPU ran them. Contexts whose
+// timestamps have no bits (some software ones) fall back to GL_TIME_ELAPSED for the outermost zones only, placed
+// when the CPU submitted them. Without timer queries (GL < 3.3 and no ARB_timer_query) zones do nothing.
+
+enum GpuTimerMode {
+    GPU_TIMER_OFF,
+    GPU_TIMER_TIMESTAMP,
+    GPU_TIMER_ELAPSED
+};
+
+struct GpuZoneResult {
+    const char* name;
+    double ms;
+};
+
+class GpuTimer
+{
+public:
+    static const unsigned int FRAMES = GPU_QUERY_FRAMES;
+
+    static GpuTimerMode init()
+    {
+        State &s = state();
+        s.mode = GPU_TIMER_OFF;
+        if(timerQueryBits(GL_TIMESTAMP) > 0)
+            s.mode = GPU_TIMER_TIMESTAMP;
+        else if(timerQueryBits(GL_TIME_ELAPSED) > 0)
+            s.mode = GPU_TIMER_ELAPSED;
+        if(s.mode == GPU_TIMER_TIMESTAMP)
+            std::cout << "GPU_TIMER:: timestamp queries" << std::endl;
+        else if(s.mode == GPU_TIMER_ELAPSED)
+            std::cout << "GPU_TIMER:: no timestamps, elapsed time queries (outermost zones only)" << std::endl;
+        else
+            std::cout << "GPU_TIMER:: no timer queries, GPU zones are not measured" << std::endl;
+#ifdef LEARNOPENGL_PROFILER
+        if(s.mode != GPU_TIMER_OFF && !s.track)
+            s.track = &Profiler::trackBuffer("GPU");
+#endif
+        if(s.mode == GPU_TIMER_TIMESTAMP)
+            s.clock.synchronize();
+        return s.mode;
+    }
+
+    static GpuTimerMode mode()
+    {
+        return state().mode;
+    }
+
+    static void begin(const char* name)
+    {
+        State &s = state();
+        if(s.mode == GPU_TIMER_OFF)
+            return;
+        Queries::Frame &f = s.queries.current();
+        Zone zone = { name, NONE, NONE, cpuNow() };
+        if(s.mode == GPU_TIMER_TIMESTAMP)
+        {
+            zone.begin = s.queries.query();
+            glQueryCounter(f.queries[zone.begin], GL_TIMESTAMP);
+        }
+        else if(s.open.empty())
+        {
+            zone.begin = s.queries.query();
+            glBeginQuery(GL_TIME_ELAPSED, f.queries[zone.begin]);
+        }
+        s.open.push_back(f.data.size());
+        f.data.push_back(zone);
+    }
+
+    static void end()
+    {
+        State &s = state();
+        if(s.mode == GPU_TIMER_OFF || s.open.empty())
+            return;
+        Queries::Frame &f = s.queries.current();
+        Zone &zone = f.data[s.open.back()];
+        s.open.pop_back();
+        if(s.mode == GPU_TIMER_TIMESTAMP)
+        {
+            zone.end = s.queries.query();
+            glQueryCounter(f.queries[zone.end], GL_TIMESTAMP);
+        }
+        else if(zone.begin != NONE)
+        {
+            glEndQuery(GL_TIME_ELAPSED);
+            zone.end = zone.begin;
+        }
+    }
+
+    // end of the frame's GPU work: reads back every earlier frame the GPU has finished, never waits
+    static void frame()
+    {
+        State &s = state();
+        if(s.mode == GPU_TIMER_OFF)
+            return;
+        while(!s.open.empty())
+            end();
+        s.queries.endFrame();
+        s.queries.resolve(resolve);
+        s.queries.beginFrame().data.clear();
+        if(s.mode == GPU_TIMER_TIMESTAMP)
+            s.clock.frame();
+    }
+
+    // the zones of the latest frame read back, in the order they began
+    static const std::vector<GpuZoneResult>& results()
+    {
+        return state().results;
+    }
+
+    // frames whose timings were dropped because the GPU was too far behind
+    static unsigned long long droppedFrames()
+    {
+        return state().queries.droppedFrames();
+    }
+
+private:
+    static const size_t NONE = static_cast<size_t>(-1);
+
+    struct Zone {
+        const char* name;
+        size_t begin;           // query indices, NONE when not measured
+        size_t end;
+        int64_t cpuStart;
+    };
+
+    // the zones of a frame, with the queries timing them
+    typedef GpuQueryRing<std::vector<Zone> > Queries;
+
+    struct State {
+        GpuTimerMode mode = GPU_TIMER_OFF;
+        Queries queries;
+        GpuClock clock{&GpuTimer::cpuNow};   // GPU timestamps on the Profiler::now() clock
+        std::vector<size_t> open;           // zones begun and not ended, in queries.current()
+        std::vector<GpuZoneResult> results;
+#ifdef LEARNOPENGL_PROFILER
+        ProfileThreadBuffer* track = nullptr;
+#endif
+        std::map<const char*, std::string> trackNames;
+    };
+
+    static State& state()
+    {
+        static State instance;
+        return instance;
+    }
+
+    static int64_t cpuNow()
+    {
+#ifdef LEARNOPENGL_PROFILER
+        return Profiler::now();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // a frame the GPU is done with
+    static void resolve(Queries::Frame &f)
+    {
+        State &s = state();
+        s.results.clear();
+        for(size_t i = 0; i < f.data.size(); i++)
+        {
+            const Zone &zone = f.data[i];
+            if(zone.begin == NONE || zone.end == NONE)
+                continue;
+            GLuint64 begin = 0, end = 0;
+            int64_t start = zone.cpuStart;
+            if(s.mode == GPU_TIMER_TIMESTAMP)
+            {
+                begin = Queries::result(f, zone.begin);
+                end = Queries::result(f, zone.end);
+                start = s.clock.toCpu(begin);
+            }
+            else
+                end = Queries::result(f, zone.begin);
+            const int64_t ns = static_cast<int64_t>(end - begin);
+            GpuZoneResult result = { zone.name, ns / 1e6 };
+            s.results.push_back(result);
+#ifdef LEARNOPENGL_PROFILER
+            s.track->push(trackName(zone.name), start, start + ns);
+#else
+            (void)start;
+#endif
+        }
+    }
+
+    // zone names are literals, the "gpu " ones live here for the rest of the program
+    static const char* trackName(const char* name)
+    {
+        std::map<const char*, std::string> &names = state().trackNames;
+        std::map<const char*, std::string>::iterator it = names.find(name);
+        if(it == names.end())
+            it = names.insert(std::make_pair(name, std::string("gpu ") + name)).first;
+        return it->second.c_str();
+    }
+};
+
+// times the GL commands from its construction to the end of the scope
+class GpuZone
+{
+public:
+    explicit GpuZone(const char* name)
+    {
+        GpuTimer::begin(name);
+    }
+
+    ~GpuZone()
+    {
+        GpuTimer::end();
+    }
+
+private:
+    GpuZone(const GpuZone&);
+    GpuZone& operator=(const GpuZone&);
+};
+
+#define GPU_ZONE_CONCAT_(a, b) a##b
+#define GPU_ZONE_CONCAT(a, b) GPU_ZONE_CONCAT_(a, b)
+#define GPU_ZONE(name) GpuZone GPU_ZONE_CONCAT(gpuZone, __COUNTER__)(name)
+#endif
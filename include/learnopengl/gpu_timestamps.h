@@ -0,0 +1,168 @@
+#ifndef GPU_TIMESTAMPS_H
+#define GPU_TIMESTAMPS_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The timer query plumbing shared by GpuTimer (gpu_timer.h) and FramePacer (frame_pacing.h):
+//
+//  - GpuQueryRing keeps the queries of the last FRAMES frames. A frame is read back once the GPU is done with
+//    it, never waited for: if it is still pending when its slot comes round again, it is dropped and its
+//    queries are reused.
+//  - GpuClock maps GL_TIMESTAMP values to a CPU clock, resynchronized every RESYNC_FRAMES frames since the two
+//    drift apart.
+
+// bits of the counter of the given timer query target (GL_TIMESTAMP, GL_TIME_ELAPSED), 0 without timer queries
+// (GL < 3.3 and no ARB_timer_query) or when the context has no such counter (some software ones)
+inline GLint timerQueryBits(GLenum target)
+{
+    GLint bits = 0;
+#ifdef GL_VERSION_3_3
+    bool available = GLAD_GL_VERSION_3_3 != 0;
+#ifdef GL_ARB_timer_query
+    available = available || GLAD_GL_ARB_timer_query;
+#endif
+    if(available)
+        glGetQueryiv(target, GL_QUERY_COUNTER_BITS, &bits);
+#else
+    (void)target;
+#endif
+    return bits;
+}
+
+// frames of queries in flight
+const unsigned int GPU_QUERY_FRAMES = 4;
+
+// FrameData: what the owner keeps with the queries of a frame
+template<typename FrameData>
+class GpuQueryRing
+{
+public:
+    static const unsigned int FRAMES = GPU_QUERY_FRAMES;
+
+    struct Frame {
+        std::vector<GLuint> queries;
+        size_t used = 0;
+        bool pending = false;
+        FrameData data = FrameData();
+    };
+
+    // the frame the queries are issued in
+    Frame& current()
+    {
+        return frames[index];
+    }
+
+    // a query of the current frame, by index in Frame::queries; created the first time a frame needs that many
+    size_t query()
+    {
+        Frame &f = frames[index];
+        if(f.used == f.queries.size())
+        {
+            GLuint id = 0;
+            glGenQueries(1, &id);
+            f.queries.push_back(id);
+        }
+        return f.used++;
+    }
+
+    // the current frame is complete: it is read back once the GPU is done with it. The next slot becomes the
+    // oldest frame, until beginFrame() reuses it
+    void endFrame()
+    {
+        frames[index].pending = frames[index].used > 0;
+        index = (index + 1) % FRAMES;
+    }
+
+    // reuses the current slot for a new frame, dropping it if it was never read back; its data is left to the caller
+    Frame& beginFrame()
+    {
+        Frame &f = frames[index];
+        if(f.pending)
+        {
+            dropped++;
+            f.pending = false;
+        }
+        f.used = 0;
+        return f;
+    }
+
+    // calls read(frame) on the frames the GPU is done with, oldest first, never waits: the GPU finishes them in
+    // order, so it stops at the first one still running
+    template<typename Read>
+    void resolve(Read read)
+    {
+        for(unsigned int i = 0; i < FRAMES; i++)
+        {
+            Frame &f = frames[(index + i) % FRAMES];
+            if(!f.pending)
+                continue;
+            GLuint available = 0;
+            glGetQueryObjectuiv(f.queries[f.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+            if(!available)
+                break;
+            read(f);
+            f.pending = false;
+        }
+    }
+
+    // the value of a query of a frame passed to read()
+    static GLuint64 result(const Frame &f, size_t query)
+    {
+        GLuint64 value = 0;
+        glGetQueryObjectui64v(f.queries[query], GL_QUERY_RESULT, &value);
+        return value;
+    }
+
+    // frames dropped because the GPU was FRAMES frames behind
+    unsigned long long droppedFrames() const
+    {
+        return dropped;
+    }
+
+private:
+    Frame frames[FRAMES];
+    unsigned int index = 0;
+    unsigned long long dropped = 0;
+};
+
+class GpuClock
+{
+public:
+    static const unsigned int RESYNC_FRAMES = 300;
+
+    // cpuNow: the CPU clock the timestamps are mapped to, in ns
+    explicit GpuClock(int64_t (*cpuNow)()) : cpuNow(cpuNow)
+    {
+    }
+
+    // the current GPU time, once the commands so far reached the GPU (it doesn't wait for them to finish)
+    void synchronize()
+    {
+        GLint64 gpu = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpu);
+        gpuToCpu = cpuNow() - gpu;
+    }
+
+    // counts a frame, every RESYNC_FRAMES frames synchronizes again
+    void frame()
+    {
+        if(++frames % RESYNC_FRAMES == 0)
+            synchronize();
+    }
+
+    // a GL_TIMESTAMP value on the CPU clock
+    int64_t toCpu(GLuint64 gpu) const
+    {
+        return static_cast<int64_t>(gpu) + gpuToCpu;
+    }
+
+private:
+    int64_t (*cpuNow)();
+    int64_t gpuToCpu = 0;           // ns to add to a GPU timestamp to get cpuNow()
+    unsigned long long frames = 0;
+};
+#endif
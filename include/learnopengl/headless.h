@@ -0,0 +1,253 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <learnopengl/frame_pacing.h>
+#include <learnopengl/gl_state.h>
+#include <learnopengl/gl_trace.h>
+#include <learnopengl/image.h>
+#include <learnopengl/render_stats.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Running an exercise without a display, e.g. in CI or on a render node without a GPU:
+//
+//     ./1.4.6.textures_exercise4 --headless --frames 300 --screenshot out.png
+//
+//  --headless[=osmesa|egl]  no window: GLFW's null platform with an OSMesa (software, the default) or EGL context.
+//                           The frames are drawn into an offscreen framebuffer the size of the window.
+//  --frames N               stop after N frames and print how long they took (with or without a window)
+//  --screenshot FILE        save the last frame as a PNG
+//  --stats FILE             write the render stats of every frame as CSV (see render_stats.h), the first row is
+//                           everything done before the render loop
+//  --gl-trace FILE          trace the GL calls (see gl_trace.h): write them to FILE for benchmarks/gl_replay and
+//                           print the most called entry points and how many calls were redundant
+//  --vsync on|off|adaptive  swap interval of the window (see frame_pacing.h), on by default
+//  --fps-cap N              start at most N frames a second
+//  --latency                measure the time from input to the GPU finishing the frame; like --vsync and
+//                           --fps-cap, prints the frame time percentiles when the window closes
+//
+// The exercises get it through Application (see application.h), which makes these four calls:
+//
+//     int main(int argc, char** argv)
+//     {
+//         Headless::parseArguments(argc, argv);
+//         ...                             // glfwSetup(): Headless::initHints() before glfwInit(),
+//                                         //              Headless::windowHints() before glfwCreateWindow()
+//         Headless::begin(window);        // after the GL functions are loaded
+//         while (!Headless::shouldClose(window))
+class Headless
+{
+public:
+    static void parseArguments(int argc, char** argv)
+    {
+        Options &o = options();
+        for(int i = 1; i < argc; i++)
+        {
+            std::string argument = argv[i];
+            if(argument == "--headless" || argument == "--headless=osmesa")
+                o.enabled = true, o.egl = false;
+            else if(argument == "--headless=egl")
+                o.enabled = true, o.egl = true;
+            else if(argument == "--frames" && i + 1 < argc)
+                o.frames = std::atoi(argv[++i]);
+            else if(argument == "--screenshot" && i + 1 < argc)
+                o.screenshot = argv[++i];
+            else if(argument == "--stats" && i + 1 < argc)
+                RenderStatsCollector::openCsv(argv[++i]);
+            else if(argument == "--gl-trace" && i + 1 < argc)
+                o.glTrace = argv[++i];
+            else if(argument == "--vsync" && i + 1 < argc && FramePacer::parsePacing(argv[i + 1]))
+                i++, o.pacingReport = true;
+            else if(argument == "--fps-cap" && i + 1 < argc)
+                FramePacer::setFrameCap(std::atof(argv[++i])), o.pacingReport = true;
+            else if(argument == "--latency")
+                FramePacer::measureLatency(true), o.pacingReport = true;
+            else
+                std::cout << "HEADLESS:: unknown argument " << argument << std::endl;
+        }
+        if(o.enabled && o.frames <= 0)
+        {
+            // nobody can close the window
+            o.frames = 100;
+            std::cout << "HEADLESS:: no --frames given, rendering " << o.frames << " frames" << std::endl;
+        }
+    }
+
+    static bool enabled()
+    {
+        return options().enabled;
+    }
+
+    // call before glfwInit()
+    static void initHints()
+    {
+        if(!enabled())
+            return;
+#ifdef GLFW_PLATFORM_NULL
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#else
+        std::cout << "HEADLESS:: this GLFW has no null platform (3.4+ needed), a hidden window is used instead" << std::endl;
+#endif
+    }
+
+    // call after glfwInit(), before glfwCreateWindow()
+    static void windowHints()
+    {
+        if(!enabled())
+            return;
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef GLFW_PLATFORM_NULL
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, options().egl ? GLFW_EGL_CONTEXT_API : GLFW_OSMESA_CONTEXT_API);
+#endif
+    }
+
+    // call once the GL functions are loaded, binds the offscreen framebuffer in headless mode
+    static void begin(GLFWwindow* window)
+    {
+        Options &o = options();
+        glfwGetFramebufferSize(window, &o.width, &o.height);
+        if(!o.glTrace.empty())
+        {
+            // from here on, so that the trace creates its own offscreen framebuffer
+            GLTrace::install();
+            GLTrace::open(o.glTrace);
+        }
+        if(o.enabled)
+        {
+            // an EGL context without a surface has no default framebuffer to draw to
+            glGenFramebuffers(1, &o.framebuffer);
+            glGenRenderbuffers(2, o.renderbuffers);
+            glBindRenderbuffer(GL_RENDERBUFFER, o.renderbuffers[0]);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, o.width, o.height);
+            glBindRenderbuffer(GL_RENDERBUFFER, o.renderbuffers[1]);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, o.width, o.height);
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+            glBindFramebuffer(GL_FRAMEBUFFER, o.framebuffer);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, o.renderbuffers[0]);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, o.renderbuffers[1]);
+            if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+                std::cout << "ERROR::HEADLESS::FRAMEBUFFER:: offscreen framebuffer is not complete" << std::endl;
+            glViewport(0, 0, o.width, o.height);
+            std::cout << "HEADLESS:: " << (o.egl ? "EGL" : "OSMesa") << " " << glGetString(GL_RENDERER) << ", "
+                      << o.width << "x" << o.height << ", " << o.frames << " frames" << std::endl;
+        }
+        // no window to swap when headless
+        FramePacer::begin(!o.enabled);
+        o.start = std::chrono::steady_clock::now();
+    }
+
+    // use instead of glfwWindowShouldClose() in the render loop: also true after --frames frames, then the
+    // last frame is saved and the timings are printed. Also where the render stats and GL trace frames end, and
+    // where the next frame waits for the --fps-cap and polls its input; processInput, if any, runs right after
+    // the poll, so e.g. a key closing the window takes effect this frame.
+    static bool shouldClose(GLFWwindow* window, void (*processInput)(GLFWwindow*) = NULL)
+    {
+        Options &o = options();
+        RenderStatsCollector::frame();
+        GLTrace::frame();
+#ifdef LEARNOPENGL_GL_STATE_VERIFY
+        GLState::verify();
+#endif
+        if(o.frames > 0 && o.frame++ == o.frames)
+        {
+            finish();
+            return true;
+        }
+        FramePacer::frame();
+        if(processInput)
+            processInput(window);
+        if(glfwWindowShouldClose(window))
+        {
+            closeTrace();
+            if(o.pacingReport)
+                FramePacer::report(std::cout);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    struct Options {
+        bool enabled = false;
+        bool egl = false;
+        int frames = 0;
+        std::string screenshot;
+        std::string glTrace;
+        bool pacingReport = false;
+        int width = 0;
+        int height = 0;
+        int frame = 0;
+        GLuint framebuffer = 0;
+        GLuint renderbuffers[2] = { 0, 0 };
+        std::chrono::steady_clock::time_point start;
+    };
+
+    static Options& options()
+    {
+        static Options instance;
+        return instance;
+    }
+
+    static void finish()
+    {
+        Options &o = options();
+        closeTrace();
+        // the frames are only done once the GPU is
+        glFinish();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - o.start).count();
+        std::cout << "HEADLESS:: " << o.frames << " frames in " << ms << " ms, " << ms / o.frames << " ms/frame ("
+                  << (ms > 0.0 ? 1000.0 * o.frames / ms : 0.0) << " fps)" << std::endl;
+        FramePacer::report(std::cout);
+        if(!o.screenshot.empty())
+            saveScreenshot(o.screenshot);
+        if(o.framebuffer)
+        {
+            glDeleteFramebuffers(1, &o.framebuffer);
+            glDeleteRenderbuffers(2, o.renderbuffers);
+            o.framebuffer = 0;
+        }
+    }
+
+    // the run is over, however it ended: the trace file is complete, print the most called entry points
+    static void closeTrace()
+    {
+        if(GLTrace::installed())
+        {
+            GLTrace::close();
+            GLTrace::report(std::cout);
+        }
+    }
+
+    static void saveScreenshot(const std::string &path)
+    {
+        Options &o = options();
+        std::vector<unsigned char> pixels(static_cast<size_t>(o.width) * o.height * 4);
+        if(o.framebuffer)
+        {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, o.framebuffer);
+            glReadBuffer(GL_COLOR_ATTACHMENT0);
+        }
+        else
+        {
+            // with a window the last frame was already swapped to the front buffer
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+            glReadBuffer(GL_FRONT);
+        }
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, o.width, o.height, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+        // GL rows go bottom to top
+        if(Image::writePng(path, o.width, o.height, 4, &pixels[0], true))
+            std::cout << "HEADLESS:: saved " << path << std::endl;
+        else
+            std::cout << "ERROR::HEADLESS::SCREENSHOT:: can't write " << path << std::endl;
+    }
+};
+#endif
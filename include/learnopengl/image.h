@@ -0,0 +1,54 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <string>
+
+// Image files decoded with stb_image, which is compiled once in the learnopengl_image library
+// (src/learnopengl/image.cpp) with its SSE2/NEON decoders. Nothing here touches stb's global settings: the
+// flip is a parameter of every call, so loader threads can decode at the same time with different flips.
+//
+//     Image image = Image::load("resources/textures/container.jpg", true);
+//     if (image)
+//         glTexImage2D(GL_TEXTURE_2D, 0, image.format(), image.width(), image.height(), 0, image.format(),
+//                      GL_UNSIGNED_BYTE, image.data());
+//
+// The pixels are freed with the Image; it can be moved (e.g. out of a loader thread) but not copied.
+class Image
+{
+public:
+    Image();
+    ~Image();
+    Image(Image &&other);
+    Image& operator=(Image &&other);
+
+    // decodes a file; flipVertically puts the first row at the bottom, as glTexImage2D expects. channels forces
+    // 1 to 4 channels per pixel, 0 keeps the file's. An empty Image, after printing why, on failure
+    static Image load(const std::string &path, bool flipVertically = false, int channels = 0);
+    // the same, from a file already in memory (e.g. a texture embedded in a model)
+    static Image loadFromMemory(const unsigned char *bytes, int size, bool flipVertically = false, int channels = 0);
+
+    // writes rows of channels bytes per pixel as a PNG, the first row at the bottom with flipVertically
+    // (e.g. what glReadPixels returns)
+    static bool writePng(const std::string &path, int width, int height, int channels, const unsigned char *pixels,
+                         bool flipVertically = false);
+
+    unsigned char* data() const { return pixels; }
+    int width() const { return w; }
+    int height() const { return h; }
+    // channels per pixel in data()
+    int channels() const { return n; }
+    // GL_RED, GL_RG, GL_RGB or GL_RGBA, as a GLenum
+    unsigned int format() const;
+
+    explicit operator bool() const { return pixels != 0; }
+
+private:
+    Image(const Image&);
+    Image& operator=(const Image&);
+
+    static Image decoded(unsigned char *pixels, int width, int height, int channels, bool flipVertically);
+
+    unsigned char *pixels;
+    int w, h, n;
+};
+#endif
@@ -7,12 +7,24 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <learnopengl/shader.h>
+#include <learnopengl/gl_state.h>
+#include <learnopengl/gl_handle.h>
+#include <learnopengl/resource_manager.h>
+#include <learnopengl/vertex_format.h>
+#include <learnopengl/mesh_simplify.h>
+#include <learnopengl/mesh_cluster.h>
+#include <learnopengl/render_stats.h>
 
+#include <algorithm>
+#include <cstring>
+#include <iostream>
 #include <string>
 #include <vector>
 using namespace std;
 
 #define MAX_BONE_INFLUENCE 4
+// largest bone index VERTEX_LAYOUT_SKINNED can store (SkinnedVertex::BoneIDs are 8 bit)
+#define MAX_SKINNED_BONE_ID 255
 
 struct Vertex {
     // position
@@ -35,6 +47,40 @@ struct Texture {
     unsigned int id;
     string type;
     string path;
+    ResourcePool<GLTexture>::Ref texture; // keeps id alive (see resource_manager.h), shared by every model using it
+};
+
+// import-time processing applied by Model to every mesh it loads
+struct ModelImportOptions {
+    // how the vertices are stored on the GPU. Anything but VERTEX_LAYOUT_FULL packs the normal and tangent, so
+    // the vertex shader must decode them with resources/shaders/vertex_layout.glsl, built with
+    // vertexLayoutDefines(vertexLayout)
+    VertexLayout vertexLayout;
+    bool optimizeVertexCache;    // reorder triangles for the post-transform cache and vertices for fetch locality
+    bool optimizeOverdraw;       // also sort triangle clusters to reduce overdraw (only with optimizeVertexCache)
+    unsigned int lodCount;       // levels of detail per mesh, the full mesh included (1 = no simplification)
+    float lodReduction;          // fraction of the triangles kept from one LOD to the next
+    float lodMaxError;           // maximum simplification error, relative to the mesh size
+    bool buildClusters;          // split the full mesh in clusters that can be culled one by one
+    unsigned int clusterMaxTriangles;
+    unsigned int clusterMaxVertices;
+    // upload all the meshes as one MeshBatch (draw_indirect.h) instead of giving each mesh its own buffers, for
+    // models drawn through an IndirectDrawList: the vertices are on the GPU once. Clusters are then not culled
+    bool batched;
+
+    ModelImportOptions(VertexLayout layout = VERTEX_LAYOUT_FULL)
+        : vertexLayout(layout), optimizeVertexCache(false), optimizeOverdraw(false),
+          lodCount(1), lodReduction(0.5f), lodMaxError(0.05f),
+          buildClusters(false), clusterMaxTriangles(124), clusterMaxVertices(64), batched(false)
+    {
+    }
+};
+
+// a level of detail: a range of the element buffer, all the levels share the same vertices
+struct MeshLod {
+    unsigned int firstIndex;
+    unsigned int indexCount;
+    float        error;
 };
 
 class Mesh {
@@ -43,30 +89,92 @@ public:
     vector<Vertex>       vertices;
     vector<unsigned int> indices;
     vector<Texture>      textures;
-    unsigned int VAO;
+    VertexLayout         layout;
+    vector<unsigned int> lodIndices; // indices of the simplified levels, stored after `indices` in the element buffer
+    vector<MeshLod>      lods;       // lods[0] is the full mesh
+    vector<MeshCluster>  clusters;   // ranges of `indices`, empty if the mesh was not clustered
+    GLVertexArray        VAO;        // the mesh owns its GL objects: it can be moved, not copied
 
-    // constructor
-    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures)
+    // constructor. upload = false keeps the mesh on the CPU only (a MeshBatch holds its vertices instead), so it
+    // has no VAO and can't be drawn by itself
+    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures, VertexLayout layout = VERTEX_LAYOUT_FULL,
+         const vector<MeshLodLevel> &lodLevels = vector<MeshLodLevel>(), const vector<MeshCluster> &clusters = vector<MeshCluster>(),
+         bool upload = true)
     {
         this->vertices = vertices;
         this->indices = indices;
         this->textures = textures;
+        this->clusters = clusters;
+
+        MeshLod full = { 0, static_cast<unsigned int>(indices.size()), 0.0f };
+        lods.push_back(full);
+        for(unsigned int i = 0; i < lodLevels.size(); i++)
+        {
+            MeshLod lod = { static_cast<unsigned int>(indices.size() + lodIndices.size()), static_cast<unsigned int>(lodLevels[i].indices.size()), lodLevels[i].error };
+            lods.push_back(lod);
+            lodIndices.insert(lodIndices.end(), lodLevels[i].indices.begin(), lodLevels[i].indices.end());
+        }
+        // COMPACT is only a request, a single mesh always ends up either static or skinned
+        this->layout = layout == VERTEX_LAYOUT_COMPACT ? (HasBones(vertices) ? VERTEX_LAYOUT_SKINNED : VERTEX_LAYOUT_STATIC) : layout;
+        // the skinned layout stores 8 bit bone indices, larger ones would wrap around to the wrong bones
+        if(this->layout == VERTEX_LAYOUT_SKINNED && MaxBoneID(vertices) > MAX_SKINNED_BONE_ID)
+        {
+            cout << "WARNING::MESH::LAYOUT:: bone index " << MaxBoneID(vertices) << " doesn't fit the skinned layout, keeping the full one" << endl;
+            this->layout = VERTEX_LAYOUT_FULL;
+        }
 
         // now that we have all the required data, set the vertex buffers and its attribute pointers.
-        setupMesh();
+        if(upload)
+            setupMesh();
     }
 
-    // render the mesh
-    void Draw(Shader &shader) 
+    // render the mesh, at the given level of detail (clamped to the coarsest available one)
+    void Draw(Shader &shader, unsigned int lod = 0) 
     {
         // bind appropriate textures
+        BindTextures(textures, shader);
+        
+        // draw mesh
+        // the VAO stays bound (see GLState): drawing the same mesh again doesn't rebind it
+        const MeshLod &level = lods[min<size_t>(lod, lods.size() - 1)];
+        if(GLState::bindVertexArray(VAO.get()))
+            RenderStatsCollector::bindVertexArray();
+        glDrawElements(GL_TRIANGLES, level.indexCount, GL_UNSIGNED_INT, (void*)(level.firstIndex * sizeof(unsigned int)));
+        RenderStatsCollector::draw(level.indexCount / 3);
+    }
+
+    // render only the given indices (e.g. the visible clusters picked by cullClusters), streamed to the GPU every call
+    void DrawCompacted(Shader &shader, const vector<unsigned int> &visibleIndices)
+    {
+        if(visibleIndices.empty())
+            return;
+        BindTextures(textures, shader);
+
+        // the element buffer binding is part of the VAO: swap in the streaming one, then restore the static one
+        if(GLState::bindVertexArray(VAO.get()))
+            RenderStatsCollector::bindVertexArray();
+        if(!culledEBO)
+            culledEBO.create();
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, culledEBO.get());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, visibleIndices.size() * sizeof(unsigned int), NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, visibleIndices.size() * sizeof(unsigned int), &visibleIndices[0]);
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(visibleIndices.size()), GL_UNSIGNED_INT, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO.get());
+        RenderStatsCollector::uploadBuffer(visibleIndices.size() * sizeof(unsigned int));
+        RenderStatsCollector::draw(visibleIndices.size() / 3);
+    }
+
+    // binds each texture to its own unit and points the matching sampler (e.g. texture_diffuseN) at it.
+    // shared with the batched draw path, which binds a mesh's textures once for a whole group of draws.
+    static void BindTextures(const vector<Texture> &textures, Shader &shader)
+    {
         unsigned int diffuseNr  = 1;
         unsigned int specularNr = 1;
         unsigned int normalNr   = 1;
         unsigned int heightNr   = 1;
+        size_t bound = 0;
         for(unsigned int i = 0; i < textures.size(); i++)
         {
-            glActiveTexture(GL_TEXTURE0 + i); // active proper texture unit before binding
             // retrieve texture number (the N in diffuse_textureN)
             string number;
             string name = textures[i].type;
@@ -81,66 +189,198 @@ public:
 
             // now set the sampler to the correct texture unit
             glUniform1i(glGetUniformLocation(shader.ID, (name + number).c_str()), i);
-            // and finally bind the texture
-            glBindTexture(GL_TEXTURE_2D, textures[i].id);
+            // and finally bind the texture to its unit, unless it's already there
+            if(GLState::bindTextureUnit(i, GL_TEXTURE_2D, textures[i].id))
+                bound++;
         }
-        
-        // draw mesh
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+        RenderStatsCollector::bindTextures(bound);
+        RenderStatsCollector::uploadUniform(textures.size());
+    }
 
-        // always good practice to set everything back to defaults once configured.
-        glActiveTexture(GL_TEXTURE0);
+    // size in bytes of a single vertex on the GPU
+    static size_t VertexStride(VertexLayout layout)
+    {
+        switch(layout)
+        {
+        case VERTEX_LAYOUT_STATIC:  return sizeof(StaticVertex);
+        case VERTEX_LAYOUT_SKINNED: return sizeof(SkinnedVertex);
+        default:                    return sizeof(Vertex);
+        }
+    }
+
+    // GPU memory taken by the vertex buffer of this mesh
+    size_t VertexBufferSize() const
+    {
+        return vertices.size() * VertexStride(layout);
+    }
+
+    static bool HasBones(const vector<Vertex> &vertices)
+    {
+        for(unsigned int i = 0; i < vertices.size(); i++)
+            for(int j = 0; j < MAX_BONE_INFLUENCE; j++)
+                if(vertices[i].m_BoneIDs[j] >= 0 && vertices[i].m_Weights[j] > 0.0f)
+                    return true;
+        return false;
+    }
+
+    // the largest bone index used by the vertices, -1 if there's none
+    static int MaxBoneID(const vector<Vertex> &vertices)
+    {
+        int maxID = -1;
+        for(unsigned int i = 0; i < vertices.size(); i++)
+            for(int j = 0; j < MAX_BONE_INFLUENCE; j++)
+                maxID = max(maxID, vertices[i].m_BoneIDs[j]);
+        return maxID;
+    }
+
+    // converts the vertices to the byte stream expected by the given layout
+    static vector<unsigned char> PackVertices(const vector<Vertex> &vertices, VertexLayout layout)
+    {
+        size_t stride = VertexStride(layout);
+        vector<unsigned char> data(vertices.size() * stride);
+        if(layout != VERTEX_LAYOUT_STATIC && layout != VERTEX_LAYOUT_SKINNED)
+        {
+            // A great thing about structs is that their memory layout is sequential for all its items.
+            // The effect is that we can simply pass a pointer to the struct and it translates perfectly to a glm::vec3/2 array which
+            // again translates to 3/2 floats which translates to a byte array.
+            if(!vertices.empty())
+                memcpy(&data[0], &vertices[0], data.size());
+            return data;
+        }
+
+        for(unsigned int i = 0; i < vertices.size(); i++)
+        {
+            const Vertex &v = vertices[i];
+            // the skinned layout starts with the static one, so the common part is written through it
+            StaticVertex *out = reinterpret_cast<StaticVertex*>(&data[i * stride]);
+            out->Position[0] = v.Position.x;
+            out->Position[1] = v.Position.y;
+            out->Position[2] = v.Position.z;
+
+            glm::vec2 normal = octEncode(v.Normal);
+            out->Normal[0] = quantizeSnorm16(normal.x);
+            out->Normal[1] = quantizeSnorm16(normal.y);
+
+            // the bitangent is rebuilt in the shader as cross(N, T) * sign
+            glm::vec2 tangent = octEncode(v.Tangent);
+            float handedness = glm::dot(glm::cross(v.Normal, v.Tangent), v.Bitangent) < 0.0f ? -1.0f : 1.0f;
+            out->Tangent[0] = quantizeSnorm16(tangent.x);
+            out->Tangent[1] = quantizeSnorm16(tangent.y);
+            out->Tangent[2] = quantizeSnorm16(handedness);
+            out->Tangent[3] = 0;
+
+            out->TexCoords[0] = glm::packHalf1x16(v.TexCoords.x);
+            out->TexCoords[1] = glm::packHalf1x16(v.TexCoords.y);
+
+            if(layout == VERTEX_LAYOUT_SKINNED)
+            {
+                SkinnedVertex *skinned = reinterpret_cast<SkinnedVertex*>(out);
+                float weights[MAX_BONE_INFLUENCE];
+                for(int j = 0; j < MAX_BONE_INFLUENCE; j++)
+                {
+                    // unused slots (id -1) become bone 0 with no weight
+                    bool used = v.m_BoneIDs[j] >= 0;
+                    skinned->BoneIDs[j] = used ? static_cast<uint8_t>(v.m_BoneIDs[j]) : 0;
+                    weights[j] = used ? v.m_Weights[j] : 0.0f;
+                }
+                quantizeWeights(weights, MAX_BONE_INFLUENCE, skinned->Weights);
+            }
+        }
+        return data;
+    }
+
+    // sets the vertex attribute pointers for the buffer currently bound to GL_ARRAY_BUFFER
+    static void SetupVertexAttributes(VertexLayout layout)
+    {
+        if(layout != VERTEX_LAYOUT_STATIC && layout != VERTEX_LAYOUT_SKINNED)
+        {
+            // vertex Positions
+            glEnableVertexAttribArray(0);	
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+            // vertex normals
+            glEnableVertexAttribArray(1);	
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
+            // vertex texture coords
+            glEnableVertexAttribArray(2);	
+            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+            // vertex tangent
+            glEnableVertexAttribArray(3);
+            glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
+            // vertex bitangent
+            glEnableVertexAttribArray(4);
+            glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
+            // ids
+            glEnableVertexAttribArray(5);
+            glVertexAttribIPointer(5, 4, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, m_BoneIDs));
+            // weights
+            glEnableVertexAttribArray(6);
+            glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, m_Weights));
+            return;
+        }
+
+        GLsizei stride = static_cast<GLsizei>(VertexStride(layout));
+        // vertex Positions
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(StaticVertex, Position));
+        // octahedral normals
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, stride, (void*)offsetof(StaticVertex, Normal));
+        // half float texture coords
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(StaticVertex, TexCoords));
+        // octahedral tangent + bitangent sign
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 4, GL_SHORT, GL_TRUE, stride, (void*)offsetof(StaticVertex, Tangent));
+        // no bitangent, it is rebuilt from the normal and the tangent
+        glDisableVertexAttribArray(4);
+        if(layout == VERTEX_LAYOUT_SKINNED)
+        {
+            // 8 bit ids
+            glEnableVertexAttribArray(5);
+            glVertexAttribIPointer(5, 4, GL_UNSIGNED_BYTE, stride, (void*)offsetof(SkinnedVertex, BoneIDs));
+            // unorm8 weights
+            glEnableVertexAttribArray(6);
+            glVertexAttribPointer(6, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)offsetof(SkinnedVertex, Weights));
+        }
+        else
+        {
+            glDisableVertexAttribArray(5);
+            glDisableVertexAttribArray(6);
+        }
     }
 
 private:
     // render data 
-    unsigned int VBO, EBO;
+    GLBuffer VBO, EBO;
+    GLBuffer culledEBO; // per-frame compacted indices, created on first DrawCompacted
 
     // initializes all the buffer objects/arrays
     void setupMesh()
     {
         // create buffers/arrays
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glGenBuffers(1, &EBO);
+        VAO.create();
+        VBO.create();
+        EBO.create();
 
-        glBindVertexArray(VAO);
-        // load data into vertex buffers
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        // A great thing about structs is that their memory layout is sequential for all its items.
-        // The effect is that we can simply pass a pointer to the struct and it translates perfectly to a glm::vec3/2 array which
-        // again translates to 3/2 floats which translates to a byte array.
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);  
+        GLState::bindVertexArray(VAO.get());
+        // load data into vertex buffers, converted to the layout picked for this mesh
+        glBindBuffer(GL_ARRAY_BUFFER, VBO.get());
+        vector<unsigned char> data = PackVertices(vertices, layout);
+        glBufferData(GL_ARRAY_BUFFER, data.size(), &data[0], GL_STATIC_DRAW);  
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+        // all the levels of detail share one element buffer: full mesh first, then the simplified ones
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO.get());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (indices.size() + lodIndices.size()) * sizeof(unsigned int), NULL, GL_STATIC_DRAW);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(unsigned int), &indices[0]);
+        if(!lodIndices.empty())
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), lodIndices.size() * sizeof(unsigned int), &lodIndices[0]);
+
+        RenderStatsCollector::uploadBuffer(data.size());
+        RenderStatsCollector::uploadBuffer((indices.size() + lodIndices.size()) * sizeof(unsigned int));
 
         // set the vertex attribute pointers
-        // vertex Positions
-        glEnableVertexAttribArray(0);	
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-        // vertex normals
-        glEnableVertexAttribArray(1);	
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
-        // vertex texture coords
-        glEnableVertexAttribArray(2);	
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
-        // vertex tangent
-        glEnableVertexAttribArray(3);
-        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
-        // vertex bitangent
-        glEnableVertexAttribArray(4);
-        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
-		// ids
-		glEnableVertexAttribArray(5);
-		glVertexAttribIPointer(5, 4, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, m_BoneIDs));
-
-		// weights
-		glEnableVertexAttribArray(6);
-		glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, m_Weights));
-        glBindVertexArray(0);
+        SetupVertexAttributes(layout);
+        GLState::bindVertexArray(0);
     }
 };
 #endif
@@ -0,0 +1,247 @@
+#ifndef MESH_CLUSTER_H
+#define MESH_CLUSTER_H
+
+#include <glm/glm.hpp>
+
+#include <learnopengl/render_stats.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+using namespace std;
+
+// Splits a triangle list into small clusters (meshlets) so that big meshes can be culled piece by piece.
+// Each cluster has a bounding sphere for frustum culling and a normal cone for backface culling.
+// Building and culling are CPU only, no OpenGL involved.
+
+// a contiguous range of the (reordered) index buffer
+struct MeshCluster {
+    unsigned int firstIndex;
+    unsigned int indexCount;
+    glm::vec3    center;     // bounding sphere, in object space
+    float        radius;
+    glm::vec3    coneAxis;   // average normal of the triangles
+    float        coneCutoff; // sine of the cone spread, 1 when the cluster can never be backface culled
+};
+
+// Reorders the triangles of `indices` into clusters of at most maxTriangles triangles referencing at most
+// maxVertices distinct vertices. Clusters grow from a seed triangle by picking the neighbour that adds the fewest
+// new vertices, so they are spatially compact; seeds follow the original order, which keeps most of the
+// vertex cache locality of an optimized index buffer.
+template <typename VertexT>
+vector<MeshCluster> buildClusters(const vector<VertexT> &vertices, vector<unsigned int> &indices,
+                                  unsigned int maxTriangles = 124, unsigned int maxVertices = 64)
+{
+    vector<MeshCluster> clusters;
+    const size_t triangleCount = indices.size() / 3;
+    if(triangleCount == 0 || vertices.empty() || maxTriangles == 0 || maxVertices < 3)
+        return clusters;
+
+    // vertex -> triangles adjacency
+    vector<unsigned int> triangleOffset(vertices.size() + 1, 0), triangles(triangleCount * 3);
+    for(size_t i = 0; i < triangleCount * 3; i++)
+        triangleOffset[indices[i] + 1]++;
+    for(size_t v = 0; v < vertices.size(); v++)
+        triangleOffset[v + 1] += triangleOffset[v];
+    {
+        vector<unsigned int> cursor(triangleOffset.begin(), triangleOffset.end() - 1);
+        for(size_t i = 0; i < triangleCount * 3; i++)
+            triangles[cursor[indices[i]]++] = static_cast<unsigned int>(i / 3);
+    }
+
+    // stamps tell whether a vertex / candidate triangle belongs to the cluster being built (cluster index + 1)
+    vector<unsigned int> vertexStamp(vertices.size(), 0), candidateStamp(triangleCount, 0);
+    vector<bool>         emitted(triangleCount, false);
+    vector<unsigned int> result, candidates;
+    result.reserve(triangleCount * 3);
+
+    size_t seed = 0;
+    while(result.size() < triangleCount * 3)
+    {
+        while(emitted[seed])
+            seed++;
+
+        const unsigned int stamp = static_cast<unsigned int>(clusters.size() + 1);
+        MeshCluster cluster = { static_cast<unsigned int>(result.size()), 0, glm::vec3(0.0f), 0.0f, glm::vec3(0.0f), 1.0f };
+        unsigned int clusterVertices = 0;
+        candidates.clear();
+
+        size_t next = seed;
+        while(true)
+        {
+            // emit the triangle and queue the triangles around its new vertices
+            emitted[next] = true;
+            for(int k = 0; k < 3; k++)
+            {
+                unsigned int v = indices[next * 3 + k];
+                result.push_back(v);
+                if(vertexStamp[v] == stamp)
+                    continue;
+                vertexStamp[v] = stamp;
+                clusterVertices++;
+                for(unsigned int j = triangleOffset[v]; j < triangleOffset[v + 1]; j++)
+                {
+                    unsigned int t = triangles[j];
+                    if(!emitted[t] && candidateStamp[t] != stamp)
+                    {
+                        candidateStamp[t] = stamp;
+                        candidates.push_back(t);
+                    }
+                }
+            }
+            cluster.indexCount += 3;
+            if(cluster.indexCount / 3 >= maxTriangles)
+                break;
+
+            // the neighbour adding the fewest vertices that still fits
+            int best = -1;
+            unsigned int bestNew = 4;
+            for(unsigned int c = 0; c < candidates.size(); )
+            {
+                unsigned int t = candidates[c];
+                if(emitted[t])
+                {
+                    candidates[c] = candidates.back();
+                    candidates.pop_back();
+                    continue;
+                }
+                unsigned int added = (vertexStamp[indices[t * 3]] != stamp) + (vertexStamp[indices[t * 3 + 1]] != stamp)
+                                   + (vertexStamp[indices[t * 3 + 2]] != stamp);
+                if(clusterVertices + added <= maxVertices && added < bestNew)
+                {
+                    best = static_cast<int>(c);
+                    bestNew = added;
+                    if(added == 0)
+                        break;
+                }
+                c++;
+            }
+            if(best < 0)
+                break;
+            next = candidates[best];
+        }
+        clusters.push_back(cluster);
+    }
+    indices.swap(result);
+
+    // bounds of every cluster
+    for(unsigned int c = 0; c < clusters.size(); c++)
+    {
+        MeshCluster &cluster = clusters[c];
+        const unsigned int *clusterIndices = &indices[cluster.firstIndex];
+
+        glm::vec3 minPos = vertices[clusterIndices[0]].Position, maxPos = minPos;
+        for(unsigned int i = 1; i < cluster.indexCount; i++)
+        {
+            minPos = glm::min(minPos, vertices[clusterIndices[i]].Position);
+            maxPos = glm::max(maxPos, vertices[clusterIndices[i]].Position);
+        }
+        cluster.center = (minPos + maxPos) * 0.5f;
+        for(unsigned int i = 0; i < cluster.indexCount; i++)
+            cluster.radius = std::max(cluster.radius, glm::length(vertices[clusterIndices[i]].Position - cluster.center));
+
+        // the cone axis is the area weighted average of the face normals, its spread the widest normal around it
+        vector<glm::vec3> normals;
+        glm::vec3 axis(0.0f);
+        for(unsigned int i = 0; i < cluster.indexCount; i += 3)
+        {
+            const glm::vec3 &p0 = vertices[clusterIndices[i]].Position;
+            glm::vec3 n = glm::cross(vertices[clusterIndices[i + 1]].Position - p0, vertices[clusterIndices[i + 2]].Position - p0);
+            axis += n;
+            float area = glm::length(n);
+            if(area > 0.0f)
+                normals.push_back(n / area);
+        }
+        float axisLength = glm::length(axis);
+        if(axisLength <= 0.0f || normals.empty())
+            continue;
+        cluster.coneAxis = axis / axisLength;
+
+        float minDot = 1.0f;
+        for(unsigned int i = 0; i < normals.size(); i++)
+            minDot = std::min(minDot, glm::dot(normals[i], cluster.coneAxis));
+        // past ~85 degrees the cone is too wide to ever be culled
+        cluster.coneCutoff = minDot <= 0.1f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+    }
+    return clusters;
+}
+
+// what the cluster culler did, accumulated over the meshes culled since the last reset
+struct ClusterCullStats {
+    size_t clusters = 0;
+    size_t frustumCulled = 0;
+    size_t backfaceCulled = 0;
+    size_t triangles = 0;        // triangles of all the tested clusters
+    size_t visibleTriangles = 0; // triangles left in the compacted index lists
+
+    size_t visibleClusters() const
+    {
+        return clusters - frustumCulled - backfaceCulled;
+    }
+
+    void reset()
+    {
+        *this = ClusterCullStats();
+    }
+};
+
+// Appends the indices of the clusters visible from cameraPosition to visibleIndices.
+// isVisible(center, radius) tests a world space sphere against the view volume (e.g. the camera frustum).
+// The normal cone test assumes a similarity transform (rotation, translation, uniform scale): with a
+// non-uniform scale the cones are distorted, so only the frustum test is applied.
+template <typename SphereTest>
+void cullClusters(const vector<MeshCluster> &clusters, const vector<unsigned int> &indices, const glm::mat4 &model,
+                  const glm::vec3 &cameraPosition, SphereTest isVisible, vector<unsigned int> &visibleIndices,
+                  ClusterCullStats *stats = nullptr)
+{
+    const glm::mat3 linear(model);
+    const glm::vec3 scale(glm::length(linear[0]), glm::length(linear[1]), glm::length(linear[2]));
+    const float maxScale = std::max(std::max(scale.x, scale.y), scale.z);
+    const float minScale = std::min(std::min(scale.x, scale.y), scale.z);
+    const bool coneCulling = maxScale > 0.0f && (maxScale - minScale) <= maxScale * 1e-3f;
+    // flips the cones of mirrored instances, whose triangles are seen from the other side
+    const float mirror = glm::determinant(linear) < 0.0f ? -1.0f : 1.0f;
+
+    ClusterCullStats local;
+    for(unsigned int c = 0; c < clusters.size(); c++)
+    {
+        const MeshCluster &cluster = clusters[c];
+        local.clusters++;
+        local.triangles += cluster.indexCount / 3;
+
+        const glm::vec3 center(model * glm::vec4(cluster.center, 1.0f));
+        const float radius = cluster.radius * maxScale;
+        if(!isVisible(center, radius))
+        {
+            local.frustumCulled++;
+            continue;
+        }
+
+        // every triangle faces away if the whole sphere lies behind the cone apex as seen from the camera
+        if(coneCulling && cluster.coneCutoff < 1.0f)
+        {
+            const glm::vec3 axis = linear * cluster.coneAxis * (mirror / maxScale);
+            const glm::vec3 view = center - cameraPosition;
+            if(glm::dot(view, axis) >= cluster.coneCutoff * glm::length(view) + radius)
+            {
+                local.backfaceCulled++;
+                continue;
+            }
+        }
+
+        visibleIndices.insert(visibleIndices.end(), indices.begin() + cluster.firstIndex,
+                              indices.begin() + cluster.firstIndex + cluster.indexCount);
+        local.visibleTriangles += cluster.indexCount / 3;
+    }
+
+    RenderStatsCollector::cullClusters(local.clusters, local.visibleClusters());
+    if(stats)
+    {
+        stats->clusters += local.clusters;
+        stats->frustumCulled += local.frustumCulled;
+        stats->backfaceCulled += local.backfaceCulled;
+        stats->triangles += local.triangles;
+        stats->visibleTriangles += local.visibleTriangles;
+    }
+}
+#endif
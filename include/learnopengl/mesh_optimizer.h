@@ -0,0 +1,325 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+using namespace std;
+
+// Import-time reordering of triangle lists so the GPU transforms each vertex as few times as possible.
+// Everything here works on plain index/vertex arrays and never touches OpenGL.
+
+// results of running an index buffer through a simulated FIFO post-transform cache
+struct VertexCacheStats {
+    size_t transformed = 0; // vertices that went through the vertex shader
+    float  acmr = 0.0f;     // average cache miss ratio: transformed vertices per triangle (0.5 is ideal, 3 is worst)
+    float  atvr = 0.0f;     // average transformed to vertex ratio: transformed / unique vertices (1 is ideal)
+};
+
+// simulates a FIFO cache like the ones found on real hardware
+inline VertexCacheStats analyzeVertexCache(const vector<unsigned int> &indices, size_t vertexCount, unsigned int cacheSize = 16)
+{
+    VertexCacheStats stats;
+    if(indices.empty() || vertexCount == 0)
+        return stats;
+
+    // a vertex is in the cache if it was transformed less than cacheSize misses ago
+    vector<size_t> timestamp(vertexCount, 0);
+    size_t time = cacheSize + 1;
+    for(unsigned int i = 0; i < indices.size(); i++)
+    {
+        unsigned int v = indices[i];
+        if(time - timestamp[v] > cacheSize)
+        {
+            timestamp[v] = time++;
+            stats.transformed++;
+        }
+    }
+
+    // fewer than 3 indices make no triangle
+    const size_t triangleCount = indices.size() / 3;
+    stats.acmr = triangleCount ? float(stats.transformed) / float(triangleCount) : 0.0f;
+    stats.atvr = float(stats.transformed) / float(vertexCount);
+    return stats;
+}
+
+// Tom Forsyth's "Linear-Speed Vertex Cache Optimisation": greedily emits the triangle with the highest score,
+// where vertices score higher when they are recently used (in a simulated LRU cache) and when few triangles
+// still need them, so that lonely vertices get finished off instead of being evicted.
+inline void optimizeVertexCache(vector<unsigned int> &indices, size_t vertexCount)
+{
+    const int cacheSize = 32;
+    const size_t triangleCount = indices.size() / 3;
+    if(triangleCount == 0 || vertexCount == 0)
+        return;
+
+    // scores only depend on the cache position and on the remaining valence, so they are tabulated
+    const int maxValence = 32;
+    float cacheScore[cacheSize];
+    float valenceScore[maxValence + 1];
+    for(int i = 0; i < cacheSize; i++)
+    {
+        // the last triangle's vertices get a fixed score, so its own vertices aren't preferred over its neighbours'
+        if(i < 3)
+            cacheScore[i] = 0.75f;
+        else
+            cacheScore[i] = pow(1.0f - float(i - 3) / float(cacheSize - 3), 1.5f);
+    }
+    valenceScore[0] = 0.0f;
+    for(int i = 1; i <= maxValence; i++)
+        valenceScore[i] = 2.0f * pow(float(i), -0.5f);
+
+    // per vertex: list of the triangles still using it
+    vector<unsigned int> valence(vertexCount, 0);
+    for(unsigned int i = 0; i < triangleCount * 3; i++)
+        valence[indices[i]]++;
+    vector<unsigned int> adjacencyOffset(vertexCount + 1, 0);
+    for(unsigned int v = 0; v < vertexCount; v++)
+        adjacencyOffset[v + 1] = adjacencyOffset[v] + valence[v];
+    vector<unsigned int> adjacency(triangleCount * 3);
+    vector<unsigned int> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for(unsigned int t = 0; t < triangleCount; t++)
+        for(int k = 0; k < 3; k++)
+            adjacency[fill[indices[t * 3 + k]]++] = t;
+
+    vector<float> vertexScore(vertexCount);
+    for(unsigned int v = 0; v < vertexCount; v++)
+        vertexScore[v] = valenceScore[min<unsigned int>(valence[v], maxValence)];
+
+    vector<float> triangleScore(triangleCount);
+    for(unsigned int t = 0; t < triangleCount; t++)
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+    vector<bool>         emitted(triangleCount, false);
+    vector<unsigned int> result;
+    result.reserve(triangleCount * 3);
+    // LRU cache, with room for the 3 vertices pushed before trimming
+    vector<unsigned int> cache, newCache;
+    cache.reserve(cacheSize + 3);
+    newCache.reserve(cacheSize + 3);
+
+    unsigned int scanCursor = 0;
+    int best = 0;
+    while(best >= 0)
+    {
+        const unsigned int t = static_cast<unsigned int>(best);
+        emitted[t] = true;
+        triangleScore[t] = -1.0f;
+
+        // emit the triangle and push its vertices on top of the cache
+        newCache.clear();
+        for(int k = 0; k < 3; k++)
+        {
+            unsigned int v = indices[t * 3 + k];
+            result.push_back(v);
+            newCache.push_back(v);
+
+            // remove the triangle from the vertex's adjacency
+            unsigned int *begin = &adjacency[adjacencyOffset[v]];
+            unsigned int *end = begin + valence[v];
+            unsigned int *it = std::find(begin, end, t);
+            if(it != end)
+            {
+                *it = *(end - 1);
+                valence[v]--;
+            }
+        }
+        for(unsigned int i = 0; i < cache.size(); i++)
+        {
+            unsigned int v = cache[i];
+            if(v != newCache[0] && v != newCache[1] && v != newCache[2])
+                newCache.push_back(v);
+        }
+        cache.swap(newCache);
+
+        // refresh the scores of everything that was or still is in the cache
+        for(unsigned int i = 0; i < cache.size(); i++)
+        {
+            unsigned int v = cache[i];
+            int position = i < static_cast<unsigned int>(cacheSize) ? static_cast<int>(i) : -1;
+            float score = valence[v] == 0 ? -1.0f : valenceScore[min<unsigned int>(valence[v], maxValence)];
+            if(valence[v] != 0 && position >= 0)
+                score += cacheScore[position];
+            float delta = score - vertexScore[v];
+            vertexScore[v] = score;
+            for(unsigned int j = 0; j < valence[v]; j++)
+                triangleScore[adjacency[adjacencyOffset[v] + j]] += delta;
+        }
+        if(cache.size() > static_cast<size_t>(cacheSize))
+            cache.resize(cacheSize);
+
+        // the next triangle is the best one touching the cache
+        best = -1;
+        float bestScore = -1.0f;
+        for(unsigned int i = 0; i < cache.size(); i++)
+        {
+            unsigned int v = cache[i];
+            for(unsigned int j = 0; j < valence[v]; j++)
+            {
+                unsigned int candidate = adjacency[adjacencyOffset[v] + j];
+                if(triangleScore[candidate] > bestScore)
+                {
+                    bestScore = triangleScore[candidate];
+                    best = static_cast<int>(candidate);
+                }
+            }
+        }
+
+        // nothing connected to the cache: continue from the first triangle that wasn't emitted yet
+        if(best < 0)
+        {
+            while(scanCursor < triangleCount && emitted[scanCursor])
+                scanCursor++;
+            if(scanCursor < triangleCount)
+                best = static_cast<int>(scanCursor);
+        }
+    }
+
+    indices.swap(result);
+}
+
+// Reorders the vertices in the order they are first referenced by the index buffer, so that vertex fetch
+// walks memory linearly. Unreferenced vertices are kept at the end. Returns the old -> new remap table.
+template <typename VertexT>
+vector<unsigned int> optimizeVertexFetch(vector<VertexT> &vertices, vector<unsigned int> &indices)
+{
+    const unsigned int unassigned = ~0u;
+    vector<unsigned int> remap(vertices.size(), unassigned);
+    unsigned int next = 0;
+    for(unsigned int i = 0; i < indices.size(); i++)
+    {
+        unsigned int &target = remap[indices[i]];
+        if(target == unassigned)
+            target = next++;
+        indices[i] = target;
+    }
+    for(unsigned int v = 0; v < vertices.size(); v++)
+        if(remap[v] == unassigned)
+            remap[v] = next++;
+
+    vector<VertexT> reordered(vertices.size());
+    for(unsigned int v = 0; v < vertices.size(); v++)
+        reordered[remap[v]] = vertices[v];
+    vertices.swap(reordered);
+    return remap;
+}
+
+// Overdraw reduction in the spirit of Tipsify: the cache-optimized triangle list is split into clusters
+// wherever the simulated cache gets fully flushed (so moving clusters around costs almost no cache efficiency),
+// then clusters facing away from the mesh center are drawn first since they are more likely to occlude the rest.
+// The new order is only kept if the ACMR doesn't grow by more than the given threshold (e.g. 1.05 = 5%).
+// Expects indices already processed by optimizeVertexCache.
+template <typename VertexT>
+void optimizeOverdraw(vector<unsigned int> &indices, const vector<VertexT> &vertices, float threshold = 1.05f, unsigned int cacheSize = 16)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if(triangleCount < 2 || vertices.empty())
+        return;
+
+    // cluster boundaries: triangles whose three vertices all miss the cache
+    vector<unsigned int> clusterStart;
+    vector<size_t> timestamp(vertices.size(), 0);
+    size_t time = cacheSize + 1;
+    for(unsigned int t = 0; t < triangleCount; t++)
+    {
+        int misses = 0;
+        for(int k = 0; k < 3; k++)
+        {
+            unsigned int v = indices[t * 3 + k];
+            if(time - timestamp[v] > cacheSize)
+            {
+                timestamp[v] = time++;
+                misses++;
+            }
+        }
+        if(t == 0 || misses == 3)
+            clusterStart.push_back(t);
+    }
+    if(clusterStart.size() < 2)
+        return;
+    clusterStart.push_back(static_cast<unsigned int>(triangleCount));
+
+    glm::vec3 meshCenter(0.0f);
+    for(unsigned int v = 0; v < vertices.size(); v++)
+        meshCenter += vertices[v].Position;
+    meshCenter /= float(vertices.size());
+
+    // sort key: how much the cluster faces away from the center of the mesh
+    const size_t clusterCount = clusterStart.size() - 1;
+    vector<float> sortKey(clusterCount);
+    vector<unsigned int> order(clusterCount);
+    for(unsigned int c = 0; c < clusterCount; c++)
+    {
+        glm::vec3 centroid(0.0f), normal(0.0f);
+        float area = 0.0f;
+        for(unsigned int t = clusterStart[c]; t < clusterStart[c + 1]; t++)
+        {
+            const glm::vec3 &p0 = vertices[indices[t * 3 + 0]].Position;
+            const glm::vec3 &p1 = vertices[indices[t * 3 + 1]].Position;
+            const glm::vec3 &p2 = vertices[indices[t * 3 + 2]].Position;
+            // area weighted normal and centroid
+            glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+            float a = glm::length(n);
+            centroid += (p0 + p1 + p2) * (a / 3.0f);
+            normal += n;
+            area += a;
+        }
+        if(area > 0.0f)
+            centroid /= area;
+        float length = glm::length(normal);
+        sortKey[c] = length > 0.0f ? glm::dot(centroid - meshCenter, normal / length) : 0.0f;
+        order[c] = c;
+    }
+    stable_sort(order.begin(), order.end(), [&sortKey](unsigned int a, unsigned int b) { return sortKey[a] > sortKey[b]; });
+
+    vector<unsigned int> result;
+    result.reserve(indices.size());
+    for(unsigned int i = 0; i < clusterCount; i++)
+    {
+        unsigned int c = order[i];
+        result.insert(result.end(), indices.begin() + clusterStart[c] * 3, indices.begin() + clusterStart[c + 1] * 3);
+    }
+
+    VertexCacheStats before = analyzeVertexCache(indices, vertices.size(), cacheSize);
+    VertexCacheStats after = analyzeVertexCache(result, vertices.size(), cacheSize);
+    if(after.acmr <= before.acmr * threshold)
+        indices.swap(result);
+}
+
+// before/after totals of the optimization of several meshes (e.g. all the meshes of a model)
+struct MeshOptimizationReport {
+    size_t triangles = 0;
+    size_t vertices = 0;
+    size_t transformedBefore = 0;
+    size_t transformedAfter = 0;
+
+    void add(const VertexCacheStats &before, const VertexCacheStats &after, size_t triangleCount, size_t vertexCount)
+    {
+        transformedBefore += before.transformed;
+        transformedAfter += after.transformed;
+        triangles += triangleCount;
+        vertices += vertexCount;
+    }
+
+    float acmrBefore() const { return triangles ? float(transformedBefore) / float(triangles) : 0.0f; }
+    float acmrAfter() const { return triangles ? float(transformedAfter) / float(triangles) : 0.0f; }
+    float atvrBefore() const { return vertices ? float(transformedBefore) / float(vertices) : 0.0f; }
+    float atvrAfter() const { return vertices ? float(transformedAfter) / float(vertices) : 0.0f; }
+};
+
+// the whole import-time pipeline: vertex cache order, optional overdraw sorting, then vertex fetch order
+// (which has to come last, as it follows the final index order)
+template <typename VertexT>
+void optimizeMesh(vector<VertexT> &vertices, vector<unsigned int> &indices, bool overdraw, MeshOptimizationReport *report = nullptr)
+{
+    VertexCacheStats before = analyzeVertexCache(indices, vertices.size());
+    optimizeVertexCache(indices, vertices.size());
+    if(overdraw)
+        optimizeOverdraw(indices, vertices);
+    optimizeVertexFetch(vertices, indices);
+    if(report)
+        report->add(before, analyzeVertexCache(indices, vertices.size()), indices.size() / 3, vertices.size());
+}
+#endif
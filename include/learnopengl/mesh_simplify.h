@@ -0,0 +1,277 @@
+#ifndef MESH_SIMPLIFY_H
+#define MESH_SIMPLIFY_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+// Quadric error metrics (Garland & Heckbert) simplification used to build the LODs of a mesh at import time.
+// Edges are collapsed onto one of their endpoints, so every LOD reuses the vertex buffer of the full mesh and
+// only needs its own index buffer. CPU only, no OpenGL involved.
+
+// symmetric 4x4 matrix accumulating the squared distance to a set of planes
+struct Quadric {
+    double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+    double a11 = 0, a12 = 0, a13 = 0;
+    double a22 = 0, a23 = 0;
+    double a33 = 0;
+    double weight = 0;
+
+    Quadric() = default;
+
+    // plane n.p + d = 0, weighted (typically by the triangle area)
+    Quadric(const glm::vec3 &n, double d, double w) : weight(w)
+    {
+        a00 = w * n.x * n.x; a01 = w * n.x * n.y; a02 = w * n.x * n.z; a03 = w * n.x * d;
+        a11 = w * n.y * n.y; a12 = w * n.y * n.z; a13 = w * n.y * d;
+        a22 = w * n.z * n.z; a23 = w * n.z * d;
+        a33 = w * d * d;
+    }
+
+    Quadric &operator+=(const Quadric &q)
+    {
+        a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+        a11 += q.a11; a12 += q.a12; a13 += q.a13;
+        a22 += q.a22; a23 += q.a23;
+        a33 += q.a33;
+        weight += q.weight;
+        return *this;
+    }
+
+    // weighted average of the squared distances of p to the planes
+    double evaluate(const glm::vec3 &p) const
+    {
+        if(weight <= 0)
+            return 0;
+        double x = p.x, y = p.y, z = p.z;
+        double error = a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + 2 * a03 * x
+                     + a11 * y * y + 2 * a12 * y * z + 2 * a13 * y
+                     + a22 * z * z + 2 * a23 * z
+                     + a33;
+        return error > 0 ? error / weight : 0;
+    }
+};
+
+// Simplifies a triangle list until it has at most targetIndexCount indices, or until the next collapse would
+// move the surface by more than targetError (relative to the mesh extent, e.g. 0.01 = 1% of its size).
+// Vertices on open borders and UV/normal seams are never moved, so the silhouette of the mesh is preserved.
+// If resultError is given it receives the relative error of the returned LOD.
+template <typename VertexT>
+vector<unsigned int> simplifyMesh(const vector<VertexT> &vertices, const vector<unsigned int> &indices,
+                                  size_t targetIndexCount, float targetError = 0.01f, float *resultError = nullptr)
+{
+    vector<unsigned int> result(indices);
+    if(resultError)
+        *resultError = 0.0f;
+    if(vertices.empty() || indices.size() <= targetIndexCount)
+        return result;
+
+    // work in coordinates normalized by the mesh extent, so errors are relative
+    glm::vec3 minPos = vertices[0].Position, maxPos = vertices[0].Position;
+    for(unsigned int v = 1; v < vertices.size(); v++)
+    {
+        minPos = glm::min(minPos, vertices[v].Position);
+        maxPos = glm::max(maxPos, vertices[v].Position);
+    }
+    glm::vec3 size = maxPos - minPos;
+    float extent = std::max(std::max(size.x, size.y), size.z);
+    float invExtent = extent > 0.0f ? 1.0f / extent : 1.0f;
+    vector<glm::vec3> positions(vertices.size());
+    for(unsigned int v = 0; v < vertices.size(); v++)
+        positions[v] = (vertices[v].Position - minPos) * invExtent;
+
+    // every vertex starts with the planes of the triangles around it
+    vector<Quadric> quadrics(vertices.size());
+    for(unsigned int i = 0; i + 2 < result.size(); i += 3)
+    {
+        const glm::vec3 &p0 = positions[result[i]], &p1 = positions[result[i + 1]], &p2 = positions[result[i + 2]];
+        glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+        float area = glm::length(n);
+        if(area <= 0.0f)
+            continue;
+        n /= area;
+        Quadric q(n, -glm::dot(n, p0), area);
+        quadrics[result[i]] += q;
+        quadrics[result[i + 1]] += q;
+        quadrics[result[i + 2]] += q;
+    }
+
+    // edges used by a single triangle are borders (or seams, where vertices are split): lock their vertices
+    vector<bool> locked(vertices.size(), false);
+    {
+        unordered_map<uint64_t, unsigned int> edgeUse;
+        for(unsigned int i = 0; i + 2 < result.size(); i += 3)
+            for(int k = 0; k < 3; k++)
+            {
+                uint64_t a = result[i + k], b = result[i + (k + 1) % 3];
+                edgeUse[a < b ? (a << 32 | b) : (b << 32 | a)]++;
+            }
+        for(unordered_map<uint64_t, unsigned int>::const_iterator it = edgeUse.begin(); it != edgeUse.end(); ++it)
+            if(it->second == 1)
+            {
+                locked[it->first >> 32] = true;
+                locked[it->first & 0xffffffffu] = true;
+            }
+    }
+
+    struct Collapse {
+        unsigned int from, to;
+        double       cost;
+    };
+
+    const double maxCost = double(targetError) * double(targetError);
+    double       reachedCost = 0.0;
+    vector<unsigned int> remap(vertices.size());
+    vector<bool>         touched(vertices.size());
+    vector<unsigned int> triangleOffset(vertices.size() + 1), triangles;
+    vector<Collapse>     collapses;
+
+    // collapse in passes: each pass picks the cheapest collapses that don't interfere with each other
+    while(result.size() > targetIndexCount)
+    {
+        // vertex -> triangles adjacency of the current result
+        fill(triangleOffset.begin(), triangleOffset.end(), 0);
+        for(unsigned int i = 0; i < result.size(); i++)
+            triangleOffset[result[i] + 1]++;
+        for(unsigned int v = 0; v < vertices.size(); v++)
+            triangleOffset[v + 1] += triangleOffset[v];
+        triangles.resize(result.size());
+        {
+            vector<unsigned int> cursor(triangleOffset.begin(), triangleOffset.end() - 1);
+            for(unsigned int i = 0; i < result.size(); i++)
+                triangles[cursor[result[i]]++] = i / 3;
+        }
+
+        // best direction for every edge (each interior edge is seen twice, which is harmless)
+        collapses.clear();
+        for(unsigned int i = 0; i < result.size(); i += 3)
+            for(int k = 0; k < 3; k++)
+            {
+                unsigned int a = result[i + k], b = result[i + (k + 1) % 3];
+                if(a > b)
+                    continue;
+                Quadric q = quadrics[a];
+                q += quadrics[b];
+                Collapse best = { a, b, -1.0 };
+                if(!locked[a])
+                    best.cost = q.evaluate(positions[b]);
+                if(!locked[b])
+                {
+                    double cost = q.evaluate(positions[a]);
+                    if(best.cost < 0.0 || cost < best.cost)
+                    {
+                        best.from = b;
+                        best.to = a;
+                        best.cost = cost;
+                    }
+                }
+                if(best.cost >= 0.0 && best.cost <= maxCost)
+                    collapses.push_back(best);
+            }
+        if(collapses.empty())
+            break;
+        sort(collapses.begin(), collapses.end(), [](const Collapse &x, const Collapse &y) { return x.cost < y.cost; });
+
+        for(unsigned int v = 0; v < vertices.size(); v++)
+            remap[v] = v;
+        fill(touched.begin(), touched.end(), false);
+
+        size_t removedIndices = 0, wantedIndices = result.size() - targetIndexCount;
+        for(unsigned int c = 0; c < collapses.size() && removedIndices < wantedIndices; c++)
+        {
+            const Collapse &collapse = collapses[c];
+            unsigned int from = collapse.from, to = collapse.to;
+            if(touched[from] || touched[to])
+                continue;
+
+            // reject collapses that would flip (or squash) a triangle around the moving vertex
+            bool valid = true;
+            unsigned int sharedTriangles = 0;
+            for(unsigned int j = triangleOffset[from]; j < triangleOffset[from + 1] && valid; j++)
+            {
+                const unsigned int *tri = &result[triangles[j] * 3];
+                if(tri[0] == to || tri[1] == to || tri[2] == to)
+                {
+                    sharedTriangles++;
+                    continue;
+                }
+                glm::vec3 p[3], q[3];
+                for(int k = 0; k < 3; k++)
+                {
+                    p[k] = positions[tri[k]];
+                    q[k] = tri[k] == from ? positions[to] : p[k];
+                }
+                glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+                float lengths = glm::length(before) * glm::length(after);
+                valid = lengths > 0.0f && glm::dot(before, after) > 0.25f * lengths;
+            }
+            if(!valid)
+                continue;
+
+            // the triangles around the moved vertex changed: keep their vertices out of this pass
+            for(unsigned int j = triangleOffset[from]; j < triangleOffset[from + 1]; j++)
+            {
+                const unsigned int *tri = &result[triangles[j] * 3];
+                touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = true;
+            }
+            remap[from] = to;
+            quadrics[to] += quadrics[from];
+            reachedCost = std::max(reachedCost, collapse.cost);
+            removedIndices += sharedTriangles * 3;
+        }
+        if(removedIndices == 0)
+            break;
+
+        // apply the collapses and drop the triangles that became degenerate
+        size_t write = 0;
+        for(unsigned int i = 0; i < result.size(); i += 3)
+        {
+            unsigned int a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+            if(a == b || b == c || a == c)
+                continue;
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    if(resultError)
+        *resultError = static_cast<float>(sqrt(reachedCost));
+    return result;
+}
+
+// the index buffer of a simplified version of a mesh, with the error it was built with
+struct MeshLodLevel {
+    vector<unsigned int> indices;
+    float                error;
+};
+
+// builds up to lodCount - 1 levels on top of the full mesh, each keeping about `reduction` of the triangles of
+// the previous one. Stops early when the error budget doesn't allow any further simplification.
+template <typename VertexT>
+vector<MeshLodLevel> generateLods(const vector<VertexT> &vertices, const vector<unsigned int> &indices,
+                                  unsigned int lodCount, float reduction = 0.5f, float maxError = 0.05f)
+{
+    vector<MeshLodLevel> levels;
+    const vector<unsigned int> *previous = &indices;
+    for(unsigned int lod = 1; lod < lodCount; lod++)
+    {
+        size_t target = static_cast<size_t>(previous->size() / 3 * reduction) * 3;
+        MeshLodLevel level;
+        level.indices = simplifyMesh(vertices, *previous, target, maxError, &level.error);
+        // not simplified enough to be worth a level of its own
+        if(level.indices.empty() || level.indices.size() > previous->size() * (1.0f + reduction) / 2.0f)
+            break;
+        levels.push_back(level);
+        previous = &levels.back().indices;
+    }
+    return levels;
+}
+#endif
@@ -5,19 +5,22 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <stb_image.h>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
 #include <learnopengl/mesh.h>
 #include <learnopengl/shader.h>
+#include <learnopengl/draw_indirect.h>
+#include <learnopengl/image.h>
+#include <learnopengl/mesh_optimizer.h>
 
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <vector>
 using namespace std;
 
@@ -31,21 +34,144 @@ public:
     vector<Mesh>    meshes;
     string directory;
     bool gammaCorrection;
+    ModelImportOptions importOptions; // vertex layout and optimizations applied to every mesh
 
     // constructor, expects a filepath to a 3D model.
-    Model(string const &path, bool gamma = false) : gammaCorrection(gamma)
+    Model(string const &path, bool gamma = false, ModelImportOptions options = ModelImportOptions()) : gammaCorrection(gamma), importOptions(options)
     {
         loadModel(path);
+        // the meshes kept their vertices on the CPU, the batch uploads them all at once
+        if(importOptions.batched)
+            batch.reset(new MeshBatch(meshes));
+        if(importOptions.vertexLayout != VERTEX_LAYOUT_FULL)
+            PrintVertexMemoryReport(path);
+        CountLodTriangles();
+        if(importOptions.lodCount > 1)
+        {
+            cout << "MODEL::LOD:: " << path << ":";
+            for(unsigned int i = 0; i < lodTriangleCounts.size(); i++)
+                cout << (i ? " / " : " ") << lodTriangleCounts[i];
+            cout << " triangles" << endl;
+        }
+        if(importOptions.buildClusters)
+        {
+            size_t clusterCount = 0;
+            for(unsigned int i = 0; i < meshes.size(); i++)
+                clusterCount += meshes[i].clusters.size();
+            cout << "MODEL::CLUSTERS:: " << path << ": " << clusterCount << " clusters" << endl;
+        }
+        if(importOptions.optimizeVertexCache)
+            cout << "MODEL::OPTIMIZE:: " << path << ": ACMR " << optimizationReport.acmrBefore() << " -> " << optimizationReport.acmrAfter()
+                 << ", ATVR " << optimizationReport.atvrBefore() << " -> " << optimizationReport.atvrAfter() << endl;
     }
 
-    // draws the model, and thus all its meshes
-    void Draw(Shader &shader)
+    // draws the model, and thus all its meshes, at the given level of detail
+    void Draw(Shader &shader, unsigned int lod = 0)
     {
         for(unsigned int i = 0; i < meshes.size(); i++)
-            meshes[i].Draw(shader);
+            DrawMesh(i, shader, lod);
+    }
+
+    // culls the clusters of every mesh and draws the visible ones, the sphere test is applied in world space.
+    // Meshes without clusters are drawn whole, and so are the meshes of a batched model: they have no buffers of
+    // their own to stream the visible clusters through. Returns the number of draw calls issued.
+    template <typename SphereTest>
+    unsigned int DrawCulled(Shader &shader, const glm::mat4 &model, const glm::vec3 &cameraPosition, SphereTest isVisible,
+                            ClusterCullStats *stats = nullptr)
+    {
+        unsigned int drawCalls = 0;
+        for(unsigned int i = 0; i < meshes.size(); i++)
+        {
+            if(meshes[i].clusters.empty() || importOptions.batched)
+            {
+                DrawMesh(i, shader);
+                drawCalls++;
+                continue;
+            }
+            visibleIndices.clear();
+            cullClusters(meshes[i].clusters, meshes[i].indices, model, cameraPosition, isVisible, visibleIndices, stats);
+            if(!visibleIndices.empty())
+            {
+                meshes[i].DrawCompacted(shader, visibleIndices);
+                drawCalls++;
+            }
+        }
+        return drawCalls;
+    }
+
+    // number of levels of detail of the most detailed mesh (meshes with fewer levels reuse their coarsest one)
+    unsigned int GetLodCount() const
+    {
+        return static_cast<unsigned int>(lodTriangleCounts.size());
+    }
+
+    // triangles drawn by Draw(shader, lod), for each level of detail
+    const vector<size_t>& GetLodTriangleCounts() const
+    {
+        return lodTriangleCounts;
+    }
+
+    // GPU memory taken by the vertices of all the meshes, with the chosen layout and with the full one
+    VertexMemoryStats GetVertexMemoryStats() const
+    {
+        VertexMemoryStats stats;
+        for(unsigned int i = 0; i < meshes.size(); i++)
+        {
+            stats.vertexCount += meshes[i].vertices.size();
+            stats.fullBytes   += meshes[i].vertices.size() * sizeof(Vertex);
+            stats.layoutBytes += meshes[i].VertexBufferSize();
+        }
+        return stats;
+    }
+
+    void PrintVertexMemoryReport(string const &name) const
+    {
+        VertexMemoryStats stats = GetVertexMemoryStats();
+        cout << "MODEL::VERTEX_LAYOUT:: " << name << " (" << vertexLayoutName(importOptions.vertexLayout) << "): "
+             << stats.vertexCount << " vertices, " << stats.layoutBytes << " bytes instead of "
+             << stats.fullBytes << ", " << stats.savedBytes() << " bytes saved" << endl;
+    }
+
+    // post-transform cache efficiency of the meshes before and after the import-time optimization
+    const MeshOptimizationReport& GetOptimizationReport() const
+    {
+        return optimizationReport;
+    }
+
+    // all the meshes packed in a single set of buffers, for the multi-draw-indirect path. Unless the model was
+    // imported with ModelImportOptions::batched it is built on first use, as a second copy of the meshes' buffers
+    MeshBatch& GetBatch()
+    {
+        if(!batch)
+            batch.reset(new MeshBatch(meshes));
+        return *batch;
     }
     
 private:
+    unique_ptr<MeshBatch> batch;
+    MeshOptimizationReport optimizationReport;
+    vector<size_t> lodTriangleCounts;
+    vector<unsigned int> visibleIndices; // scratch list reused by DrawCulled
+
+    // a batched model draws its meshes from the batch, the others have their own buffers
+    void DrawMesh(unsigned int i, Shader &shader, unsigned int lod = 0)
+    {
+        if(importOptions.batched)
+            batch->Draw(i, shader, lod);
+        else
+            meshes[i].Draw(shader, lod);
+    }
+
+    void CountLodTriangles()
+    {
+        lodTriangleCounts.clear();
+        for(unsigned int i = 0; i < meshes.size(); i++)
+            lodTriangleCounts.resize(max(lodTriangleCounts.size(), meshes[i].lods.size()), 0);
+        for(unsigned int lod = 0; lod < lodTriangleCounts.size(); lod++)
+            for(unsigned int i = 0; i < meshes.size(); i++)
+                lodTriangleCounts[lod] += meshes[i].lods[min<size_t>(lod, meshes[i].lods.size() - 1)].indexCount / 3;
+    }
+
     // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
     void loadModel(string const &path)
     {
@@ -164,8 +290,29 @@ private:
         std::vector<Texture> heightMaps = loadMaterialTextures(material, aiTextureType_AMBIENT, "texture_height");
         textures.insert(textures.end(), heightMaps.begin(), heightMaps.end());
         
-        // return a mesh object created from the extracted mesh data
-        return Mesh(vertices, indices, textures);
+        // reorder triangles and vertices for the GPU caches
+        if(importOptions.optimizeVertexCache)
+            optimizeMesh(vertices, indices, importOptions.optimizeOverdraw, &optimizationReport);
+
+        // simplified versions of the mesh for distant entities, sharing the same vertices
+        vector<MeshLodLevel> lodLevels;
+        if(importOptions.lodCount > 1)
+        {
+            lodLevels = generateLods(vertices, indices, importOptions.lodCount, importOptions.lodReduction, importOptions.lodMaxError);
+            if(importOptions.optimizeVertexCache)
+                for(unsigned int i = 0; i < lodLevels.size(); i++)
+                    optimizeVertexCache(lodLevels[i].indices, vertices.size());
+        }
+
+        // clusters reorder the triangles of the full mesh, so they are built last
+        vector<MeshCluster> clusters;
+        if(importOptions.buildClusters)
+            clusters = buildClusters(vertices, indices, importOptions.clusterMaxTriangles, importOptions.clusterMaxVertices);
+
+        // return a mesh object created from the extracted mesh data (no bones are loaded here, so COMPACT means STATIC)
+        VertexLayout layout = importOptions.vertexLayout;
+        return Mesh(vertices, indices, textures, layout == VERTEX_LAYOUT_COMPACT ? VERTEX_LAYOUT_STATIC : layout, lodLevels, clusters,
+                    !importOptions.batched);
     }
 
     // checks all material textures of a given type and loads the textures if they're not loaded yet.
@@ -191,7 +338,12 @@ private:
             if(!skip)
             {   // if texture hasn't been loaded already, load it
                 Texture texture;
-                texture.id = TextureFromFile(str.C_Str(), this->directory);
+                // shared with the other models using the same file, and deleted after the last one (see resource_manager.h)
+                const string key = this->directory + '/' + str.C_Str();
+                texture.texture = ResourceManager::textures().find(key);
+                if(!texture.texture)
+                    texture.texture = ResourceManager::textures().add(new GLTexture(TextureFromFile(str.C_Str(), this->directory)), key);
+                texture.id = texture.texture->get();
                 texture.type = typeName;
                 texture.path = str.C_Str();
                 textures.push_back(texture);
@@ -211,33 +363,23 @@ unsigned int TextureFromFile(const char *path, const string &directory, bool gam
     unsigned int textureID;
     glGenTextures(1, &textureID);
 
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-    if (data)
+    Image image = Image::load(filename);
+    if (image)
     {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
+        GLenum format = image.format();
 
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        GLState::bindTexture(GL_TEXTURE_2D, textureID);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, image.width(), image.height(), 0, format, GL_UNSIGNED_BYTE, image.data());
         glGenerateMipmap(GL_TEXTURE_2D);
 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data);
     }
     else
     {
         std::cout << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
     }
 
     return textureID;
@@ -0,0 +1,334 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// CPU frame profiler: scoped zones recorded per thread, a per-frame summary printed every few frames and a
+// Chrome trace (chrome://tracing or https://ui.perfetto.dev) written on demand.
+//
+//     PROFILE_THREAD("main");
+//     while (!Headless::shouldClose(window))
+//     {
+//         {
+//             PROFILE_ZONE("input");         // from here to the end of the scope
+//             processInput(window);
+//         }
+//         ...
+//         PROFILE_FRAME();                   // end of the frame: "frame" zone and summary
+//     }
+//     PROFILE_WRITE_TRACE("trace.json");
+//
+// The macros only do something when LEARNOPENGL_PROFILER is defined (cmake -DENABLE_PROFILER=ON), otherwise they
+// expand to nothing and this header declares nothing. Zone names are kept by pointer: use string literals.
+//
+// Each thread writes its zones to its own buffer, without locks: the buffers are chunks that never move and the
+// event count is published after the event, so the summary and the trace can read them while the thread runs.
+// A mutex is only taken the first time a thread records something.
+
+#ifdef LEARNOPENGL_PROFILER
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct ProfileEvent {
+    const char* name;
+    int64_t start;          // ns since the profiler started
+    int64_t end;
+};
+
+// the zones of one thread, only written by that thread
+class ProfileThreadBuffer
+{
+public:
+    static const size_t CHUNK_SIZE = 4096;
+    static const size_t MAX_CHUNKS = 256;   // 1M events per thread, later ones are dropped (and counted)
+
+    const unsigned int id;
+    std::string name;
+
+    ProfileThreadBuffer(unsigned int id, const std::string &name) : id(id), name(name), count(0), dropped(0)
+    {
+        for(size_t i = 0; i < MAX_CHUNKS; i++)
+            chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~ProfileThreadBuffer()
+    {
+        for(size_t i = 0; i < MAX_CHUNKS; i++)
+            delete[] chunks[i].load(std::memory_order_relaxed);
+    }
+
+    void push(const char* zone, int64_t start, int64_t end)
+    {
+        const size_t n = count.load(std::memory_order_relaxed);
+        if(n >= CHUNK_SIZE * MAX_CHUNKS)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        ProfileEvent* chunk = chunks[n / CHUNK_SIZE].load(std::memory_order_relaxed);
+        if(!chunk)
+        {
+            chunk = new ProfileEvent[CHUNK_SIZE];
+            chunks[n / CHUNK_SIZE].store(chunk, std::memory_order_release);
+        }
+        ProfileEvent &event = chunk[n % CHUNK_SIZE];
+        event.name = zone;
+        event.start = start;
+        event.end = end;
+        count.store(n + 1, std::memory_order_release);
+    }
+
+    // events [0, size()) can be read from any thread
+    size_t size() const
+    {
+        return count.load(std::memory_order_acquire);
+    }
+
+    const ProfileEvent& operator[](size_t i) const
+    {
+        return chunks[i / CHUNK_SIZE].load(std::memory_order_acquire)[i % CHUNK_SIZE];
+    }
+
+    size_t droppedEvents() const
+    {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<ProfileEvent*> chunks[MAX_CHUNKS];
+    std::atomic<size_t> count;
+    std::atomic<size_t> dropped;
+};
+
+class Profiler
+{
+public:
+    // ns since the first call, steady clock
+    static int64_t now()
+    {
+        static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    static ProfileThreadBuffer& threadBuffer()
+    {
+        static thread_local ProfileThreadBuffer* buffer = nullptr;
+        if(!buffer)
+        {
+            State &s = state();
+            std::lock_guard<std::mutex> lock(s.mutex);
+            const unsigned int id = static_cast<unsigned int>(s.threads.size());
+            s.threads.push_back(std::unique_ptr<ProfileThreadBuffer>(new ProfileThreadBuffer(id, "thread " + std::to_string(id))));
+            buffer = s.threads.back().get();
+        }
+        return *buffer;
+    }
+
+    // a timeline that belongs to no thread (e.g. the GPU's, see gpu_timer.h): one thread at a time writes to it
+    static ProfileThreadBuffer& trackBuffer(const char* name)
+    {
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        const unsigned int id = static_cast<unsigned int>(s.threads.size());
+        s.threads.push_back(std::unique_ptr<ProfileThreadBuffer>(new ProfileThreadBuffer(id, name)));
+        return *s.threads.back();
+    }
+
+    // the name of the calling thread in the trace
+    static void setThreadName(const char* name)
+    {
+        ProfileThreadBuffer &buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock(state().mutex);
+        buffer.name = name;
+    }
+
+    // print the average zone times every `frames` frames, 0 never prints
+    static void setSummaryInterval(unsigned int frames)
+    {
+        state().summaryInterval = frames;
+    }
+
+    // end of a frame, always from the same thread: records a "frame" zone since the previous call and adds the
+    // zones of every thread that ended since then to the summary
+    static void frame()
+    {
+        State &s = state();
+        const int64_t end = now();
+        // the first frame starts with the first zone
+        threadBuffer().push("frame", s.frameStart, end);
+        s.frameStart = end;
+        s.frames++;
+
+        std::vector<ProfileThreadBuffer*> threads;
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            for(size_t i = 0; i < s.threads.size(); i++)
+                threads.push_back(s.threads[i].get());
+        }
+        s.cursors.resize(threads.size(), 0);
+        for(size_t t = 0; t < threads.size(); t++)
+        {
+            const size_t size = threads[t]->size();
+            for(size_t i = s.cursors[t]; i < size; i++)
+            {
+                const ProfileEvent &event = (*threads[t])[i];
+                findTotal(event.name).ns += event.end - event.start;
+            }
+            s.cursors[t] = size;
+        }
+
+        if(s.summaryInterval > 0 && ++s.summaryFrames >= s.summaryInterval)
+            printSummary();
+    }
+
+    // all the zones recorded so far, as Chrome trace JSON
+    static bool writeChromeTrace(const std::string &path)
+    {
+        std::ofstream file(path.c_str());
+        if(!file)
+        {
+            std::cout << "ERROR::PROFILER::TRACE:: can't write " << path << std::endl;
+            return false;
+        }
+        State &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        size_t events = 0, dropped = 0;
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"LearnOpenGL\"}}";
+        file.setf(std::ios::fixed);
+        file.precision(3);
+        for(size_t t = 0; t < s.threads.size(); t++)
+        {
+            const ProfileThreadBuffer &buffer = *s.threads[t];
+            file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.id
+                 << ",\"args\":{\"name\":\"" << escape(buffer.name.c_str()) << "\"}}";
+            const size_t size = buffer.size();
+            for(size_t i = 0; i < size; i++)
+            {
+                const ProfileEvent &event = buffer[i];
+                // microseconds
+                file << ",\n{\"name\":\"" << escape(event.name) << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                     << buffer.id << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+            }
+            events += size;
+            dropped += buffer.droppedEvents();
+        }
+        file << "\n]}\n";
+        std::cout << "PROFILER:: " << events << " zones written to " << path << std::endl;
+        if(dropped > 0)
+            std::cout << "PROFILER:: " << dropped << " zones were dropped, the thread buffers were full" << std::endl;
+        return static_cast<bool>(file);
+    }
+
+private:
+    struct ZoneTotal {
+        const char* name;
+        int64_t ns;
+    };
+
+    struct State {
+        std::mutex mutex;                                           // guards threads (not their events)
+        std::vector<std::unique_ptr<ProfileThreadBuffer> > threads;
+        // only used by the thread calling frame()
+        std::vector<size_t> cursors;
+        std::vector<ZoneTotal> totals;
+        unsigned int summaryInterval = 300;
+        unsigned int summaryFrames = 0;
+        unsigned long long frames = 0;
+        int64_t frameStart = 0;
+    };
+
+    static State& state()
+    {
+        static State instance;
+        return instance;
+    }
+
+    // a handful of zones: a linear search beats a map, the pointer compare usually hits
+    static ZoneTotal& findTotal(const char* name)
+    {
+        std::vector<ZoneTotal> &totals = state().totals;
+        for(size_t i = 0; i < totals.size(); i++)
+            if(totals[i].name == name || std::strcmp(totals[i].name, name) == 0)
+                return totals[i];
+        ZoneTotal total = { name, 0 };
+        totals.push_back(total);
+        return totals.back();
+    }
+
+    static void printSummary()
+    {
+        State &s = state();
+        std::ostringstream line;
+        line.setf(std::ios::fixed);
+        line.precision(3);
+        line << "PROFILER:: frames " << s.frames - s.summaryFrames << "-" << s.frames - 1 << ", ms/frame:";
+        for(size_t i = 0; i < s.totals.size(); i++)
+        {
+            line << " " << s.totals[i].name << " " << s.totals[i].ns / 1e6 / s.summaryFrames;
+            s.totals[i].ns = 0;
+        }
+        std::cout << line.str() << std::endl;
+        s.summaryFrames = 0;
+    }
+
+    static std::string escape(const char* text)
+    {
+        std::string escaped;
+        for(; *text; text++)
+        {
+            if(*text == '"' || *text == '\\')
+                escaped += '\\';
+            escaped += *text;
+        }
+        return escaped;
+    }
+};
+
+// records the time from its construction to the end of the scope
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char* name) : name(name), start(Profiler::now())
+    {
+    }
+
+    ~ProfileZone()
+    {
+        Profiler::threadBuffer().push(name, start, Profiler::now());
+    }
+
+private:
+    const char* name;
+    int64_t start;
+
+    ProfileZone(const ProfileZone&);
+    ProfileZone& operator=(const ProfileZone&);
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __COUNTER__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+#define PROFILE_FRAME() Profiler::frame()
+#define PROFILE_THREAD(name) Profiler::setThreadName(name)
+#define PROFILE_WRITE_TRACE(path) Profiler::writeChromeTrace(path)
+
+#else
+
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#define PROFILE_WRITE_TRACE(path) ((void)0)
+
+#endif
+#endif
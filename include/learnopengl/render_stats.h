@@ -0,0 +1,166 @@
+#ifndef RENDER_STATS_H
+#define RENDER_STATS_H
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// What the renderer did during one frame. The helpers (Mesh, MeshBatch, IndirectDrawList, the Shader classes,
+// Entity and the cluster culler) count into RenderStatsCollector::current(); raw gl* calls made by an exercise
+// itself are not seen.
+struct RenderStats {
+    unsigned long long frame = 0;
+    double frameMs = 0.0;           // CPU time from the previous frame() to this one
+    size_t drawCalls = 0;
+    size_t instances = 0;           // an instanced or multi-draw call counts each of its instances
+    size_t triangles = 0;
+    size_t programBinds = 0;
+    size_t vertexArrayBinds = 0;
+    size_t textureBinds = 0;
+    size_t uniformUploads = 0;
+    size_t bufferUploads = 0;
+    size_t bufferBytes = 0;         // bytes given to glBufferData / glBufferSubData
+    size_t objectsTested = 0;       // entities tested against the frustum
+    size_t objectsVisible = 0;
+    size_t clustersTested = 0;
+    size_t clustersVisible = 0;
+
+    void reset()
+    {
+        *this = RenderStats();
+    }
+
+    static const char* csvHeader()
+    {
+        return "frame,frame_ms,draw_calls,instances,triangles,program_binds,vertex_array_binds,texture_binds,"
+               "uniform_uploads,buffer_uploads,buffer_bytes,objects_tested,objects_visible,clusters_tested,clusters_visible";
+    }
+
+    void writeCsv(std::ostream &out) const
+    {
+        out << frame << "," << frameMs << "," << drawCalls << "," << instances << "," << triangles << ","
+            << programBinds << "," << vertexArrayBinds << "," << textureBinds << "," << uniformUploads << ","
+            << bufferUploads << "," << bufferBytes << "," << objectsTested << "," << objectsVisible << ","
+            << clustersTested << "," << clustersVisible << "\n";
+    }
+};
+
+// Per-frame counters of the GL thread: the helpers add to current(), frame() closes the frame (once per frame,
+// Headless::shouldClose does it) and optionally appends it to a CSV file.
+class RenderStatsCollector
+{
+public:
+    // the frame being drawn
+    static RenderStats& current()
+    {
+        return state().current;
+    }
+
+    // the last complete frame
+    static const RenderStats& lastFrame()
+    {
+        return state().last;
+    }
+
+    static void frame()
+    {
+        State &s = state();
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        s.current.frameMs = s.frames > 0 ? std::chrono::duration<double, std::milli>(now - s.frameStart).count() : 0.0;
+        s.current.frame = s.frames++;
+        s.frameStart = now;
+        if(s.csv.is_open())
+            s.current.writeCsv(s.csv);
+        s.last = s.current;
+        s.current.reset();
+    }
+
+    // every following frame becomes a row of path
+    static bool openCsv(const std::string &path)
+    {
+        State &s = state();
+        s.csv.close();
+        s.csv.clear();
+        s.csv.open(path.c_str());
+        if(!s.csv)
+        {
+            std::cout << "ERROR::RENDER_STATS::CSV:: can't write " << path << std::endl;
+            return false;
+        }
+        s.csv << RenderStats::csvHeader() << "\n";
+        return true;
+    }
+
+    static void closeCsv()
+    {
+        state().csv.close();
+    }
+
+    // one draw call, triangles of all its instances
+    static void draw(size_t triangles, size_t instances = 1)
+    {
+        RenderStats &stats = current();
+        stats.drawCalls++;
+        stats.instances += instances;
+        stats.triangles += triangles;
+    }
+
+    static void bindProgram()
+    {
+        current().programBinds++;
+    }
+
+    static void bindVertexArray()
+    {
+        current().vertexArrayBinds++;
+    }
+
+    static void bindTextures(size_t count)
+    {
+        current().textureBinds += count;
+    }
+
+    static void uploadUniform(size_t count = 1)
+    {
+        current().uniformUploads += count;
+    }
+
+    static void uploadBuffer(size_t bytes)
+    {
+        RenderStats &stats = current();
+        stats.bufferUploads++;
+        stats.bufferBytes += bytes;
+    }
+
+    static void cullObject(bool visible)
+    {
+        RenderStats &stats = current();
+        stats.objectsTested++;
+        stats.objectsVisible += visible ? 1 : 0;
+    }
+
+    static void cullClusters(size_t tested, size_t visible)
+    {
+        RenderStats &stats = current();
+        stats.clustersTested += tested;
+        stats.clustersVisible += visible;
+    }
+
+private:
+    struct State {
+        RenderStats current;
+        RenderStats last;
+        unsigned long long frames = 0;
+        std::chrono::steady_clock::time_point frameStart;
+        std::ofstream csv;
+    };
+
+    static State& state()
+    {
+        static State instance;
+        return instance;
+    }
+};
+#endif
@@ -0,0 +1,314 @@
+#ifndef RESOURCE_MANAGER_H
+#define RESOURCE_MANAGER_H
+
+#include <learnopengl/gl_handle.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Shared resources (textures, models, ...) addressed by generational handles and kept alive by reference counts.
+// A resource nobody references is not destroyed right away but at a frame boundary a few frames later: names
+// recorded into command buffers (see command_buffer.h) stay valid until they are submitted, and a model streamed
+// out and back in within those frames gets its resources back instead of loading them again.
+//
+//     ResourcePool<Model> models;                       // collected by ResourceManager::endFrame()
+//     ResourcePool<Model>::Ref tree = models.find(path);
+//     if (!tree)
+//         tree = models.add(new Model(path), path);
+//     tree->Draw(shader);
+//     tree = ResourcePool<Model>::Ref();                // destroyed 2 frames later, unless found again
+//
+// Pools are used from the GL thread only. Application::endFrame() advances them and Application::terminate()
+// destroys what is left while the context still exists.
+
+// a slot and the generation of the resource in it: a handle to a destroyed resource resolves to NULL, even if the
+// slot has been reused since
+struct ResourceHandle {
+    uint32_t index;
+    uint32_t generation; // 0: no resource
+};
+
+class ResourcePoolBase;
+template<typename T> class ResourcePool;
+
+class ResourceManager
+{
+public:
+    // frames an unreferenced resource survives before it is destroyed
+    static const unsigned int DEFERRED_FRAMES = 2;
+
+    // the textures of the models, by path (see Model::loadMaterialTextures)
+    static ResourcePool<GLTexture>& textures();
+
+    // a frame boundary: every pool destroys its resources unreferenced for DEFERRED_FRAMES frames
+    static void endFrame();
+
+    // destroys the resources of every pool, referenced or not; to be called before the context goes away
+    static void clear();
+
+private:
+    friend class ResourcePoolBase;
+
+    static std::vector<ResourcePoolBase*>& pools()
+    {
+        static std::vector<ResourcePoolBase*> instance;
+        return instance;
+    }
+};
+
+// what ResourceManager needs to know of a pool
+class ResourcePoolBase
+{
+public:
+    ResourcePoolBase()
+    {
+        ResourceManager::pools().push_back(this);
+    }
+
+    virtual ~ResourcePoolBase()
+    {
+        std::vector<ResourcePoolBase*> &pools = ResourceManager::pools();
+        pools.erase(std::remove(pools.begin(), pools.end(), this), pools.end());
+    }
+
+    virtual void endFrame() = 0;
+    virtual void clear() = 0;
+
+    // a pool owns its resources, so it must not be copied around
+    ResourcePoolBase(const ResourcePoolBase &) = delete;
+    ResourcePoolBase& operator=(const ResourcePoolBase &) = delete;
+};
+
+template<typename T>
+class ResourcePool : public ResourcePoolBase
+{
+public:
+    // a counted reference: the resource lives at least as long as one of its Refs. The pool must outlive them
+    class Ref
+    {
+    public:
+        Ref() : pool(NULL)
+        {
+            handle.index = 0, handle.generation = 0;
+        }
+
+        Ref(const Ref &other) : pool(other.pool), handle(other.handle)
+        {
+            if(pool)
+                pool->acquire(handle);
+        }
+
+        Ref& operator=(const Ref &other)
+        {
+            if(other.pool)
+                other.pool->acquire(other.handle);
+            if(pool)
+                pool->release(handle);
+            pool = other.pool, handle = other.handle;
+            return *this;
+        }
+
+        ~Ref()
+        {
+            if(pool)
+                pool->release(handle);
+        }
+
+        // NULL for an empty Ref, or once the pool has been cleared
+        T* get() const { return pool ? pool->get(handle) : NULL; }
+        T* operator->() const { return get(); }
+        T& operator*() const { return *get(); }
+        explicit operator bool() const { return get() != NULL; }
+
+        ResourceHandle id() const { return handle; }
+
+    private:
+        friend class ResourcePool;
+
+        Ref(ResourcePool *pool, ResourceHandle handle) : pool(pool), handle(handle)
+        {
+            pool->acquire(handle);
+        }
+
+        ResourcePool *pool;
+        ResourceHandle handle;
+    };
+
+    explicit ResourcePool(unsigned int deferredFrames = ResourceManager::DEFERRED_FRAMES)
+        : deferredFrames(deferredFrames), frame(0)
+    {
+    }
+
+    ~ResourcePool()
+    {
+        clear();
+    }
+
+    // takes ownership of the resource; with a key, find() returns it until it is destroyed
+    Ref add(T *resource, const std::string &key = std::string())
+    {
+        uint32_t index;
+        if(!freeSlots.empty())
+        {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            index = static_cast<uint32_t>(slots.size());
+            slots.push_back(Slot());
+        }
+        Slot &slot = slots[index];
+        slot.resource.reset(resource);
+        slot.references = 0;
+        slot.key = key;
+        if(!key.empty())
+            keys[key] = index;
+        ResourceHandle handle = { index, slot.generation };
+        return Ref(this, handle);
+    }
+
+    // the resource added with this key, brought back if it was waiting to be destroyed; an empty Ref if there's none
+    Ref find(const std::string &key)
+    {
+        std::map<std::string, uint32_t>::const_iterator it = keys.find(key);
+        if(it == keys.end())
+            return Ref();
+        ResourceHandle handle = { it->second, slots[it->second].generation };
+        return Ref(this, handle);
+    }
+
+    // NULL if the handle is stale
+    T* get(ResourceHandle handle) const
+    {
+        return valid(handle) ? slots[handle.index].resource.get() : NULL;
+    }
+
+    unsigned int referenceCount(ResourceHandle handle) const
+    {
+        return valid(handle) ? slots[handle.index].references : 0;
+    }
+
+    // resources alive, referenced or waiting to be destroyed
+    size_t size() const
+    {
+        return slots.size() - freeSlots.size();
+    }
+
+    // resources waiting to be destroyed
+    size_t pendingCount() const
+    {
+        size_t count = 0;
+        for(size_t i = 0; i < pending.size(); i++)
+            count += slots[pending[i]].references == 0;
+        return count;
+    }
+
+    void endFrame()
+    {
+        frame++;
+        size_t kept = 0;
+        for(size_t i = 0; i < pending.size(); i++)
+        {
+            Slot &slot = slots[pending[i]];
+            if(slot.references > 0)
+                continue;                           // found again: not pending anymore
+            if(frame - slot.releasedFrame < deferredFrames)
+                pending[kept++] = pending[i];
+            else
+                destroy(pending[i]);
+        }
+        pending.resize(kept);
+    }
+
+    void clear()
+    {
+        for(uint32_t i = 0; i < slots.size(); i++)
+            if(slots[i].resource)
+                destroy(i);
+        pending.clear();
+    }
+
+private:
+    struct Slot {
+        std::unique_ptr<T> resource;
+        uint32_t generation;
+        unsigned int references;
+        unsigned long long releasedFrame;
+        std::string key;
+
+        Slot() : generation(1), references(0), releasedFrame(0)
+        {
+        }
+    };
+
+    bool valid(ResourceHandle handle) const
+    {
+        return handle.index < slots.size() && handle.generation != 0 && slots[handle.index].generation == handle.generation;
+    }
+
+    void acquire(ResourceHandle handle)
+    {
+        if(valid(handle))
+            slots[handle.index].references++;
+    }
+
+    // releases of stale handles (e.g. Refs outliving clear()) are ignored
+    void release(ResourceHandle handle)
+    {
+        if(!valid(handle))
+            return;
+        Slot &slot = slots[handle.index];
+        if(--slot.references == 0)
+        {
+            slot.releasedFrame = frame;
+            if(std::find(pending.begin(), pending.end(), handle.index) == pending.end())
+                pending.push_back(handle.index);
+        }
+    }
+
+    void destroy(uint32_t index)
+    {
+        Slot &slot = slots[index];
+        std::map<std::string, uint32_t>::iterator key = keys.find(slot.key);
+        if(key != keys.end() && key->second == index)
+            keys.erase(key);
+        slot.key.clear();
+        slot.resource.reset();
+        slot.references = 0;
+        slot.generation = slot.generation + 1 == 0 ? 1 : slot.generation + 1;
+        freeSlots.push_back(index);
+    }
+
+    unsigned int deferredFrames;
+    unsigned long long frame;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::vector<uint32_t> pending;
+    std::map<std::string, uint32_t> keys;
+};
+
+inline ResourcePool<GLTexture>& ResourceManager::textures()
+{
+    static ResourcePool<GLTexture> instance;
+    return instance;
+}
+
+inline void ResourceManager::endFrame()
+{
+    std::vector<ResourcePoolBase*> &all = pools();
+    for(size_t i = 0; i < all.size(); i++)
+        all[i]->endFrame();
+}
+
+inline void ResourceManager::clear()
+{
+    std::vector<ResourcePoolBase*> &all = pools();
+    for(size_t i = 0; i < all.size(); i++)
+        all[i]->clear();
+}
+#endif
@@ -0,0 +1,294 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// On-disk cache of linked programs (glGetProgramBinary / glProgramBinary), so that the second launch of an
+// exercise skips compiling and linking its shaders.
+//
+// A program is stored under a hash of its stages (type + source text) and of the driver strings: editing a
+// shader or updating the driver changes the key, so stale binaries are simply never looked up again. A binary
+// the driver refuses anyway is deleted and the program is rebuilt from source.
+//
+// The cache lives in ./shader_cache (next to the copied shaders when run from build/bin). The LOGL_SHADER_CACHE
+// environment variable picks another directory, or disables the cache when set to "off".
+
+struct ShaderCacheStats {
+    unsigned int programs = 0;   // programs built through the cache
+    unsigned int hits = 0;       // loaded from a binary
+    unsigned int rejected = 0;   // binaries found but refused by the driver
+    double compileMs = 0.0;      // time spent compiling and linking from source
+    double loadMs = 0.0;         // time spent loading binaries
+    double savedMs = 0.0;        // compile time of the cached programs when they were built, minus their load time
+};
+
+class ProgramBinaryCache
+{
+public:
+    // one program being built: load() it, or compile and link it and then store() it
+    class Entry
+    {
+    public:
+        Entry(GLuint program, const std::vector<std::pair<GLenum, std::string> > &stages, const std::string &name)
+            : program(program), name(name), start(std::chrono::steady_clock::now())
+        {
+            key = ProgramBinaryCache::key(stages);
+            ProgramBinaryCache::stats().programs++;
+        }
+
+        // true if the program was linked from the cached binary
+        bool load()
+        {
+            float compileMs = 0.0f;
+            if(!ProgramBinaryCache::load(program, key, compileMs))
+                return false;
+
+            double loadMs = elapsedMs();
+            ShaderCacheStats &stats = ProgramBinaryCache::stats();
+            stats.hits++;
+            stats.loadMs += loadMs;
+            stats.savedMs += compileMs - loadMs;
+            std::cout << "SHADER::CACHE:: " << name << " loaded in " << loadMs << " ms (compiled in " << compileMs << " ms)" << std::endl;
+            return true;
+        }
+
+        // call before glLinkProgram, so the driver keeps the binary around
+        void prepareLink()
+        {
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+            if(ProgramBinaryCache::supported())
+                glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+        }
+
+        // call after a source build, saves the binary if the program linked
+        void store()
+        {
+            double compileMs = elapsedMs();
+            ProgramBinaryCache::stats().compileMs += compileMs;
+            GLint linked = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            if(linked && ProgramBinaryCache::store(program, key, static_cast<float>(compileMs)))
+                std::cout << "SHADER::CACHE:: " << name << " compiled in " << compileMs << " ms, binary cached" << std::endl;
+        }
+
+    private:
+        GLuint program;
+        std::string name;
+        std::string key;
+        std::chrono::steady_clock::time_point start;
+
+        double elapsedMs() const
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+
+    static ShaderCacheStats& stats()
+    {
+        static ShaderCacheStats instance;
+        return instance;
+    }
+
+    // one line summary of the whole startup, printed by Application::endFrame() after the first frame
+    static void printSummary()
+    {
+        const ShaderCacheStats &s = stats();
+        std::cout << "SHADER::CACHE:: " << s.hits << "/" << s.programs << " programs from cache";
+        if(s.rejected)
+            std::cout << " (" << s.rejected << " rejected by the driver)";
+        std::cout << ", " << s.compileMs << " ms compiling, " << s.loadMs << " ms loading, ~" << s.savedMs << " ms saved" << std::endl;
+    }
+
+    static const std::string& directory()
+    {
+        static std::string dir = initialDirectory();
+        return dir;
+    }
+
+    // the driver must support program binaries and offer at least one format
+    static bool supported()
+    {
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+        if(directory().empty())
+            return false;
+        bool available = false;
+#ifdef GL_VERSION_4_1
+        available = available || GLAD_GL_VERSION_4_1;
+#endif
+#ifdef GL_ARB_get_program_binary
+        available = available || GLAD_GL_ARB_get_program_binary;
+#endif
+        if(!available)
+            return false;
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+#else
+        return false;
+#endif
+    }
+
+    // 64 bit FNV-1a of the driver strings and of every stage, as 16 hex digits
+    static std::string key(const std::vector<std::pair<GLenum, std::string> > &stages)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        const GLenum driverStrings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION };
+        for(unsigned int i = 0; i < sizeof(driverStrings) / sizeof(driverStrings[0]); i++)
+        {
+            const char *value = reinterpret_cast<const char*>(glGetString(driverStrings[i]));
+            hashBytes(hash, value, value ? std::strlen(value) + 1 : 0);
+        }
+        for(unsigned int i = 0; i < stages.size(); i++)
+        {
+            uint64_t header[2] = { stages[i].first, stages[i].second.size() };
+            hashBytes(hash, header, sizeof(header));
+            hashBytes(hash, stages[i].second.data(), stages[i].second.size());
+        }
+
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+        return hex;
+    }
+
+private:
+    // file layout: header, then `length` bytes of binary in `format`
+    struct FileHeader {
+        char     magic[8];
+        uint32_t version;
+        uint32_t format;
+        uint32_t length;
+        float    compileMs;
+    };
+
+    static void hashBytes(uint64_t &hash, const void *data, size_t size)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char*>(data);
+        for(size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+
+    static std::string initialDirectory()
+    {
+        const char *env = std::getenv("LOGL_SHADER_CACHE");
+        if(env && (std::strcmp(env, "off") == 0 || std::strcmp(env, "0") == 0))
+            return "";
+        return env && *env ? env : "shader_cache";
+    }
+
+    static std::string path(const std::string &key)
+    {
+        return directory() + "/" + key + ".bin";
+    }
+
+    static bool load(GLuint program, const std::string &key, float &compileMs)
+    {
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+        if(!supported())
+            return false;
+        std::ifstream file(path(key).c_str(), std::ios::binary);
+        if(!file)
+            return false;
+
+        FileHeader header;
+        std::vector<char> binary;
+        bool valid = file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+                     std::memcmp(header.magic, "LOGLPBIN", 8) == 0 && header.version == 1 && header.length > 0;
+        if(valid)
+        {
+            binary.resize(header.length);
+            valid = static_cast<bool>(file.read(&binary[0], header.length));
+        }
+        file.close();
+
+        GLint linked = GL_FALSE;
+        if(valid)
+        {
+            glProgramBinary(program, header.format, &binary[0], header.length);
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        }
+        if(!linked)
+        {
+            // truncated file, or the driver doesn't accept this binary anymore: rebuild it from source
+            std::remove(path(key).c_str());
+            stats().rejected++;
+            return false;
+        }
+        compileMs = header.compileMs;
+        return true;
+#else
+        (void)program; (void)key; (void)compileMs;
+        return false;
+#endif
+    }
+
+    static bool store(GLuint program, const std::string &key, float compileMs)
+    {
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+        if(!supported())
+            return false;
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if(length <= 0)
+            return false;
+
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(program, length, &length, &format, &binary[0]);
+
+        FileHeader header;
+        std::memcpy(header.magic, "LOGLPBIN", 8);
+        header.version = 1;
+        header.format = format;
+        header.length = static_cast<uint32_t>(length);
+        header.compileMs = compileMs;
+
+        makeDirectory(directory());
+        // written aside and renamed, so a concurrent launch never reads half a file
+        std::string finalPath = path(key), tempPath = finalPath + ".tmp";
+        {
+            std::ofstream file(tempPath.c_str(), std::ios::binary | std::ios::trunc);
+            if(!file || !file.write(reinterpret_cast<const char*>(&header), sizeof(header)) || !file.write(&binary[0], length))
+            {
+                std::cout << "ERROR::SHADER::CACHE:: can't write " << tempPath << std::endl;
+                return false;
+            }
+        }
+        std::remove(finalPath.c_str());
+        return std::rename(tempPath.c_str(), finalPath.c_str()) == 0;
+#else
+        (void)program; (void)key; (void)compileMs;
+        return false;
+#endif
+    }
+
+    static void makeDirectory(const std::string &dir)
+    {
+#ifdef _WIN32
+        _mkdir(dir.c_str());
+#else
+        mkdir(dir.c_str(), 0755);
+#endif
+    }
+};
+#endif
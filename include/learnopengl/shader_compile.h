@@ -0,0 +1,153 @@
+#ifndef SHADER_COMPILE_H
+#define SHADER_COMPILE_H
+
+#include <glad/glad.h>
+#include <learnopengl/shader_cache.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Batched shader compilation. Checking a compile or link status makes the driver finish that work right away,
+// so creating programs one after the other serializes all of them. Between begin() and end() the Shader
+// constructors only submit their stages and link, and every status check is postponed to the first use():
+//
+//     ShaderCompileQueue::begin();
+//     Shader lighting("lighting.vs", "lighting.fs");
+//     Shader shadows("shadows.vs", "shadows.fs");
+//     ShaderCompileQueue::end();
+//     ...
+//     lighting.use(); // errors of lighting.vs/fs are reported here
+//
+// With GL_KHR_parallel_shader_compile (or the ARB version) the driver also compiles on its own threads, and
+// isComplete() tells whether a program can be used without stalling.
+class ShaderCompileQueue
+{
+public:
+    static void begin()
+    {
+        State &s = state();
+        s.deferring = true;
+        s.submitted = 0;
+        s.start = std::chrono::steady_clock::now();
+        if(parallel())
+        {
+            // let the driver pick the number of threads
+#ifdef GL_KHR_parallel_shader_compile
+            if(GLAD_GL_KHR_parallel_shader_compile)
+                glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+#endif
+#ifdef GL_ARB_parallel_shader_compile
+            if(!khrParallel() && GLAD_GL_ARB_parallel_shader_compile)
+                glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+#endif
+        }
+    }
+
+    // programs created after end() check their status in the constructor again
+    static void end()
+    {
+        State &s = state();
+        s.deferring = false;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s.start).count();
+        std::cout << "SHADER::COMPILE:: submitted " << s.submitted << " programs in " << ms << " ms ("
+                  << (parallel() ? "parallel" : "serial") << " driver compile)" << std::endl;
+    }
+
+    static bool deferring()
+    {
+        return state().deferring;
+    }
+
+    static bool parallel()
+    {
+        return khrParallel() || arbParallel();
+    }
+
+    // true when the program finished compiling and linking, never blocks with the parallel extensions
+    // (without them there is no way to ask, so the program is assumed ready and use() may stall)
+    static bool isComplete(GLuint program)
+    {
+#if defined(GL_KHR_parallel_shader_compile) || defined(GL_ARB_parallel_shader_compile)
+        if(parallel())
+        {
+            GLint complete = GL_TRUE;
+            glGetProgramiv(program, 0x91B1 /* GL_COMPLETION_STATUS_KHR == GL_COMPLETION_STATUS_ARB */, &complete);
+            return complete == GL_TRUE;
+        }
+#endif
+        (void)program;
+        return true;
+    }
+
+    static void programSubmitted()
+    {
+        state().submitted++;
+    }
+
+private:
+    struct State {
+        bool deferring = false;
+        unsigned int submitted = 0;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    static State& state()
+    {
+        static State instance;
+        return instance;
+    }
+
+    static bool khrParallel()
+    {
+#ifdef GL_KHR_parallel_shader_compile
+        return GLAD_GL_KHR_parallel_shader_compile != 0;
+#else
+        return false;
+#endif
+    }
+
+    static bool arbParallel()
+    {
+#ifdef GL_ARB_parallel_shader_compile
+        return GLAD_GL_ARB_parallel_shader_compile != 0;
+#else
+        return false;
+#endif
+    }
+};
+
+// the status checks a Shader postponed while the queue was open, run on its first use()
+struct PendingShaderChecks {
+    std::vector<std::pair<GLuint, std::string> > checks; // shaders and program, with their checkCompileErrors type
+    // stored once the program is known to be linked (its reported compile time then runs until the first use)
+    std::shared_ptr<ProgramBinaryCache::Entry> cache;
+
+    bool pending() const
+    {
+        return !checks.empty();
+    }
+
+    void defer(GLuint object, const std::string &type)
+    {
+        if(type == "PROGRAM")
+            ShaderCompileQueue::programSubmitted();
+        checks.push_back(std::make_pair(object, type));
+    }
+
+    // the shader objects are flagged for deletion but stay alive while attached, so their logs can still be read
+    template <typename CheckFunction>
+    void finish(CheckFunction check)
+    {
+        for(unsigned int i = 0; i < checks.size(); i++)
+            check(checks[i].first, checks[i].second);
+        checks.clear();
+        if(cache)
+            cache->store();
+        cache.reset();
+    }
+};
+#endif
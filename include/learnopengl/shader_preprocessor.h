@@ -0,0 +1,323 @@
+#ifndef SHADER_PREPROCESSOR_H
+#define SHADER_PREPROCESSOR_H
+
+#include <sys/stat.h>
+
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Source-level processing done before a stage is handed to the driver.
+
+// true if the line is a #version directive: "#version" is its first token once whitespace and comments are
+// skipped. inComment carries the state of /* */ comments from one line to the next
+inline bool isVersionDirective(const std::string &line, bool &inComment)
+{
+    bool directive = false, firstToken = true;
+    size_t i = 0;
+    while(i < line.size())
+    {
+        if(inComment)
+        {
+            size_t end = line.find("*/", i);
+            if(end == std::string::npos)
+                break;
+            inComment = false;
+            i = end + 2;
+            continue;
+        }
+        if(line[i] == ' ' || line[i] == '\t' || line[i] == '\r')
+        {
+            i++;
+            continue;
+        }
+        if(line.compare(i, 2, "//") == 0)
+            break;
+        if(line.compare(i, 2, "/*") == 0)
+        {
+            inComment = true;
+            i += 2;
+            continue;
+        }
+        if(firstToken && line[i] == '#')
+        {
+            // "# version" is a directive too
+            size_t name = line.find_first_not_of(" \t", i + 1);
+            directive = name != std::string::npos && line.compare(name, 7, "version") == 0 &&
+                        (name + 7 == line.size() || line[name + 7] == ' ' || line[name + 7] == '\t' || line[name + 7] == '\r');
+        }
+        firstToken = false;
+        i++;
+    }
+    return directive;
+}
+
+// inserts a "#define NAME" line for every define right after the #version directive (GLSL requires #version
+// to come first), or at the top when there is none. "NAME VALUE" entries define a value.
+inline std::string addShaderDefines(const std::string &code, const std::vector<std::string> &defines)
+{
+    if(defines.empty())
+        return code;
+
+    std::string block;
+    for(unsigned int i = 0; i < defines.size(); i++)
+        block += "#define " + defines[i] + "\n";
+
+    bool inComment = false;
+    size_t lineStart = 0;
+    while(lineStart < code.size())
+    {
+        size_t lineEnd = code.find('\n', lineStart);
+        std::string line = code.substr(lineStart, lineEnd == std::string::npos ? std::string::npos : lineEnd - lineStart);
+        if(isVersionDirective(line, inComment))
+        {
+            if(lineEnd == std::string::npos)
+                return code + "\n" + block;
+            return code.substr(0, lineEnd + 1) + block + code.substr(lineEnd + 1);
+        }
+        if(lineEnd == std::string::npos)
+            break;
+        lineStart = lineEnd + 1;
+    }
+    return block + code;
+}
+
+// name used in logs for a program built with defines, e.g. "shader.vs [UPSIDE_DOWN MOVEMENT]"
+inline std::string shaderVariantName(const std::string &path, const std::vector<std::string> &defines)
+{
+    if(defines.empty())
+        return path;
+    std::string name = path + " [";
+    for(unsigned int i = 0; i < defines.size(); i++)
+        name += (i ? " " : "") + defines[i];
+    return name + "]";
+}
+
+// a file a program was built from, with its modification time when it was read
+struct ShaderDependency {
+    std::string path;
+    std::time_t modified;
+    long long   size;
+};
+
+// Contents of the shader files read so far, re-read only when their modification time or size changes.
+// Shared by all the programs, so a common include is read once no matter how many shaders use it.
+class ShaderSourceCache
+{
+public:
+    // false if the file can't be read
+    static bool read(const std::string &path, std::string &code, ShaderDependency &dependency)
+    {
+        struct stat info;
+        if(stat(path.c_str(), &info) != 0)
+            return false;
+
+        dependency.path = path;
+        dependency.modified = info.st_mtime;
+        dependency.size = static_cast<long long>(info.st_size);
+
+        Entry &entry = files()[path];
+        if(!entry.valid || entry.modified != dependency.modified || entry.size != dependency.size)
+        {
+            std::ifstream file(path.c_str(), std::ios::binary);
+            if(!file)
+                return false;
+            std::stringstream stream;
+            stream << file.rdbuf();
+            entry.code = stream.str();
+            entry.modified = dependency.modified;
+            entry.size = dependency.size;
+            entry.valid = true;
+        }
+        code = entry.code;
+        return true;
+    }
+
+    // true if any of the files changed (or disappeared) since the program was built from them
+    static bool changed(const std::vector<ShaderDependency> &dependencies)
+    {
+        for(unsigned int i = 0; i < dependencies.size(); i++)
+        {
+            struct stat info;
+            if(stat(dependencies[i].path.c_str(), &info) != 0 || info.st_mtime != dependencies[i].modified ||
+               static_cast<long long>(info.st_size) != dependencies[i].size)
+                return true;
+        }
+        return false;
+    }
+
+private:
+    struct Entry {
+        bool        valid = false;
+        std::time_t modified = 0;
+        long long   size = 0;
+        std::string code;
+    };
+
+    static std::map<std::string, Entry>& files()
+    {
+        static std::map<std::string, Entry> instance;
+        return instance;
+    }
+};
+
+// printed after a compile error: which file each source string number of the log refers to
+inline void printShaderSources(const std::vector<ShaderDependency> &dependencies)
+{
+    for(unsigned int i = 0; i < dependencies.size(); i++)
+        std::cout << "  source " << i << ": " << dependencies[i].path << std::endl;
+}
+
+// Builds the sources of the stages of one program:
+//  - #include "file" (or <file>) is replaced by the file, looked up relative to the including file. A file is
+//    included once per stage (like #pragma once); including a file from itself is an error.
+//  - the defines are added after #version (see addShaderDefines)
+//  - #line directives keep error messages pointing at the right file and line: the "N(line)" or "N:line"
+//    prefix of a driver error is the index N of the file in dependencies()
+class ShaderPreprocessor
+{
+public:
+    explicit ShaderPreprocessor(const std::vector<std::string> &defines = std::vector<std::string>())
+        : defines(defines)
+    {
+    }
+
+    // the processed source of a stage, empty (with an error printed) if a file can't be read
+    std::string load(const char* path)
+    {
+        std::string code;
+        std::vector<std::string> stack, included;
+        if(!expand(path, stack, included, code, true))
+            return "";
+        return code;
+    }
+
+    // every file read by load(), in source string number order
+    const std::vector<ShaderDependency>& dependencies() const
+    {
+        return files;
+    }
+
+private:
+    std::vector<std::string> defines;
+    std::vector<ShaderDependency> files;
+
+    static std::string directoryOf(const std::string &path)
+    {
+        size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? "" : path.substr(0, slash + 1);
+    }
+
+    static bool isAbsolute(const std::string &path)
+    {
+        return !path.empty() && (path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':'));
+    }
+
+    // the file name of an #include line, empty if the line is not an #include
+    static std::string includedFile(const std::string &line)
+    {
+        size_t i = line.find_first_not_of(" \t");
+        if(i == std::string::npos || line.compare(i, 1, "#") != 0)
+            return "";
+        i = line.find_first_not_of(" \t", i + 1);
+        if(i == std::string::npos || line.compare(i, 7, "include") != 0)
+            return "";
+        i = line.find_first_of("\"<", i + 7);
+        if(i == std::string::npos)
+            return "";
+        size_t end = line.find(line[i] == '"' ? '"' : '>', i + 1);
+        return end == std::string::npos ? "" : line.substr(i + 1, end - i - 1);
+    }
+
+    unsigned int sourceNumber(const std::string &path)
+    {
+        for(unsigned int i = 0; i < files.size(); i++)
+            if(files[i].path == path)
+                return i;
+        return static_cast<unsigned int>(files.size());
+    }
+
+    bool expand(const std::string &path, std::vector<std::string> &stack, std::vector<std::string> &included,
+                std::string &out, bool root)
+    {
+        for(unsigned int i = 0; i < stack.size(); i++)
+            if(stack[i] == path)
+            {
+                std::cout << "ERROR::SHADER::RECURSIVE_INCLUDE: " << path << " includes itself" << std::endl;
+                return false;
+            }
+        for(unsigned int i = 0; i < included.size(); i++)
+            if(included[i] == path)
+                return true;
+
+        std::string code;
+        ShaderDependency dependency;
+        if(!ShaderSourceCache::read(path, code, dependency))
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+            return false;
+        }
+        unsigned int number = sourceNumber(path);
+        if(number == files.size())
+            files.push_back(dependency);
+        stack.push_back(path);
+        included.push_back(path);
+
+        std::istringstream lines(code);
+        std::string line;
+        unsigned int lineNumber = 0;
+        bool hasVersion = false, inComment = false;
+        // included files are numbered from their first line, the root file right after its #version
+        if(!root)
+            out += lineDirective(1, number);
+        while(std::getline(lines, line))
+        {
+            lineNumber++;
+            bool version = isVersionDirective(line, inComment);
+            if(version && !root)
+            {
+                // only the first directive of a stage may be #version
+                out += "\n";
+                continue;
+            }
+
+            std::string include = includedFile(line);
+            if(!include.empty())
+            {
+                std::string includePath = isAbsolute(include) ? include : directoryOf(path) + include;
+                if(!expand(includePath, stack, included, out, false))
+                    return false;
+                out += lineDirective(lineNumber + 1, number);
+                continue;
+            }
+
+            out += line + "\n";
+            if(version && !hasVersion)
+            {
+                hasVersion = true;
+                for(unsigned int i = 0; i < defines.size(); i++)
+                    out += "#define " + defines[i] + "\n";
+                out += lineDirective(lineNumber + 1, number);
+            }
+        }
+        // sources without #version get their defines on top
+        if(root && !hasVersion && !defines.empty())
+            out = addShaderDefines("", defines) + lineDirective(1, number) + out;
+
+        stack.pop_back();
+        return true;
+    }
+
+    // GLSL 3.30+ numbers the line after "#line N" as N
+    static std::string lineDirective(unsigned int line, unsigned int source)
+    {
+        std::ostringstream directive;
+        directive << "#line " << line << " " << source << "\n";
+        return directive.str();
+    }
+};
+#endif
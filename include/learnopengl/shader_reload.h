@@ -0,0 +1,241 @@
+#ifndef SHADER_RELOAD_H
+#define SHADER_RELOAD_H
+
+#include <glad/glad.h>
+#include <learnopengl/gl_state.h>
+#include <learnopengl/shader_cache.h>
+#include <learnopengl/shader_compile.h>
+#include <learnopengl/shader_preprocessor.h>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+enum ShaderReloadStatus {
+    SHADER_RELOAD_PENDING, // the driver is still compiling, call reload() again next frame
+    SHADER_RELOAD_DONE,    // the new program replaced the old one
+    SHADER_RELOAD_FAILED   // the new program didn't build, the old one is still in use
+};
+
+// Rebuilds a program from the files it was created from, for Shader::reload(). The new program is compiled
+// next to the old one and swapped in only if it links, so a broken edit never leaves a shader without a
+// program. With parallel shader compile the build runs over several frames instead of stalling one. The
+// values of the uniforms the two programs share are carried over, so settings made once (like the texture
+// unit of a sampler) survive the swap.
+class ShaderReload
+{
+public:
+    ShaderReload()
+        : program(0)
+    {
+    }
+
+    void addStage(GLenum type, const char* path)
+    {
+        stagePaths.push_back(std::make_pair(type, std::string(path)));
+    }
+
+    void setDefines(const std::vector<std::string> &shaderDefines)
+    {
+        defines = shaderDefines;
+    }
+
+    // starts a build when none is running, then swaps the program into id once the driver is done.
+    // dependencies is updated on every attempt, so a broken file is retried only after it changes again
+    ShaderReloadStatus update(unsigned int &id, std::vector<ShaderDependency> &dependencies)
+    {
+        if(program == 0)
+        {
+            ShaderReloadStatus status = submit(id, dependencies);
+            if(status != SHADER_RELOAD_PENDING)
+                return status;
+        }
+        if(!ShaderCompileQueue::isComplete(program))
+            return SHADER_RELOAD_PENDING;
+
+        bool success = true;
+        for(unsigned int i = 0; i < shaders.size(); i++)
+            success = checkShader(shaders[i], dependencies) && success;
+        success = success && checkProgram();
+        if(success)
+        {
+            cache->store();
+            swap(id);
+        }
+        else
+        {
+            glDeleteProgram(program);
+            std::cout << "SHADER::RELOAD:: " << name() << " failed, keeping the previous program" << std::endl;
+        }
+        program = 0;
+        shaders.clear();
+        cache.reset();
+        return success ? SHADER_RELOAD_DONE : SHADER_RELOAD_FAILED;
+    }
+
+private:
+    std::vector<std::pair<GLenum, std::string> > stagePaths;
+    std::vector<std::string> defines;
+    // the build in flight: program, its (deletion flagged) shaders and its cache entry
+    GLuint program;
+    std::vector<GLuint> shaders;
+    std::shared_ptr<ProgramBinaryCache::Entry> cache;
+
+    std::string name() const
+    {
+        return shaderVariantName(stagePaths.empty() ? "" : stagePaths[0].second, defines);
+    }
+
+    // PENDING once the stages are submitted, DONE if the program came from the binary cache
+    ShaderReloadStatus submit(unsigned int &id, std::vector<ShaderDependency> &dependencies)
+    {
+        ShaderPreprocessor preprocessor(defines);
+        std::vector<std::pair<GLenum, std::string> > stages;
+        bool read = true;
+        for(unsigned int i = 0; i < stagePaths.size(); i++)
+        {
+            std::string code = preprocessor.load(stagePaths[i].second.c_str());
+            read = read && !code.empty();
+            stages.push_back(std::make_pair(stagePaths[i].first, code));
+        }
+        dependencies = preprocessor.dependencies();
+        if(!read)
+        {
+            std::cout << "SHADER::RELOAD:: " << name() << " failed, keeping the previous program" << std::endl;
+            return SHADER_RELOAD_FAILED;
+        }
+
+        program = glCreateProgram();
+        ProgramBinaryCache::Entry entry(program, stages, name());
+        // an edit that was undone links from the binary it left behind
+        if(entry.load())
+        {
+            swap(id);
+            program = 0;
+            return SHADER_RELOAD_DONE;
+        }
+        for(unsigned int i = 0; i < stages.size(); i++)
+        {
+            const char* code = stages[i].second.c_str();
+            GLuint shader = glCreateShader(stages[i].first);
+            glShaderSource(shader, 1, &code, NULL);
+            glCompileShader(shader);
+            glAttachShader(program, shader);
+            // stays alive while attached, its log is read once the build is done
+            glDeleteShader(shader);
+            shaders.push_back(shader);
+        }
+        entry.prepareLink();
+        glLinkProgram(program);
+        cache = std::make_shared<ProgramBinaryCache::Entry>(entry);
+        return SHADER_RELOAD_PENDING;
+    }
+
+    bool checkShader(GLuint shader, const std::vector<ShaderDependency> &dependencies) const
+    {
+        GLint success;
+        GLchar infoLog[1024];
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if(!success)
+        {
+            glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+            std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: RELOAD\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+            printShaderSources(dependencies);
+        }
+        return success != 0;
+    }
+
+    bool checkProgram() const
+    {
+        GLint success;
+        GLchar infoLog[1024];
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if(!success)
+        {
+            glGetProgramInfoLog(program, 1024, NULL, infoLog);
+            std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: RELOAD\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+        }
+        return success != 0;
+    }
+
+    // the old program is deleted only now, draws until here used it
+    void swap(unsigned int &id)
+    {
+        GLint current = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+        copyUniforms(id, program);
+        glDeleteProgram(id);
+        if(static_cast<GLuint>(current) == id)
+            GLState::useProgram(program);
+        id = program;
+        std::cout << "SHADER::RELOAD:: " << name() << " reloaded" << std::endl;
+    }
+
+    // copies the default block uniforms both programs have, element by element for arrays
+    static void copyUniforms(GLuint from, GLuint to)
+    {
+        if(from == 0 || !glIsProgram(from))
+            return;
+        GLint current = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+        GLState::useProgram(to);
+
+        GLint count = 0;
+        glGetProgramiv(from, GL_ACTIVE_UNIFORMS, &count);
+        for(GLint i = 0; i < count; i++)
+        {
+            GLchar nameBuffer[256];
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(from, static_cast<GLuint>(i), sizeof(nameBuffer), &length, &size, &type, nameBuffer);
+            std::string uniform(nameBuffer, length);
+            // arrays are reported as "name[0]"
+            std::string base = uniform;
+            if(size > 1 && base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0)
+                base.erase(base.size() - 3);
+            for(GLint element = 0; element < size; element++)
+            {
+                std::string elementName = size > 1 ? base + "[" + std::to_string(element) + "]" : uniform;
+                GLint fromLocation = glGetUniformLocation(from, elementName.c_str());
+                GLint toLocation = glGetUniformLocation(to, elementName.c_str());
+                // uniform block members have no location
+                if(fromLocation >= 0 && toLocation >= 0)
+                    copyUniform(from, fromLocation, toLocation, type);
+            }
+        }
+        GLState::useProgram(static_cast<GLuint>(current));
+    }
+
+    static void copyUniform(GLuint from, GLint fromLocation, GLint toLocation, GLenum type)
+    {
+        GLfloat f[16];
+        GLint i[4];
+        GLuint u[4];
+        switch(type)
+        {
+        case GL_FLOAT:        glGetUniformfv(from, fromLocation, f); glUniform1fv(toLocation, 1, f); break;
+        case GL_FLOAT_VEC2:   glGetUniformfv(from, fromLocation, f); glUniform2fv(toLocation, 1, f); break;
+        case GL_FLOAT_VEC3:   glGetUniformfv(from, fromLocation, f); glUniform3fv(toLocation, 1, f); break;
+        case GL_FLOAT_VEC4:   glGetUniformfv(from, fromLocation, f); glUniform4fv(toLocation, 1, f); break;
+        case GL_FLOAT_MAT2:   glGetUniformfv(from, fromLocation, f); glUniformMatrix2fv(toLocation, 1, GL_FALSE, f); break;
+        case GL_FLOAT_MAT3:   glGetUniformfv(from, fromLocation, f); glUniformMatrix3fv(toLocation, 1, GL_FALSE, f); break;
+        case GL_FLOAT_MAT4:   glGetUniformfv(from, fromLocation, f); glUniformMatrix4fv(toLocation, 1, GL_FALSE, f); break;
+        case GL_INT_VEC2:
+        case GL_BOOL_VEC2:    glGetUniformiv(from, fromLocation, i); glUniform2iv(toLocation, 1, i); break;
+        case GL_INT_VEC3:
+        case GL_BOOL_VEC3:    glGetUniformiv(from, fromLocation, i); glUniform3iv(toLocation, 1, i); break;
+        case GL_INT_VEC4:
+        case GL_BOOL_VEC4:    glGetUniformiv(from, fromLocation, i); glUniform4iv(toLocation, 1, i); break;
+        case GL_UNSIGNED_INT: glGetUniformuiv(from, fromLocation, u); glUniform1uiv(toLocation, 1, u); break;
+        case GL_UNSIGNED_INT_VEC2: glGetUniformuiv(from, fromLocation, u); glUniform2uiv(toLocation, 1, u); break;
+        case GL_UNSIGNED_INT_VEC3: glGetUniformuiv(from, fromLocation, u); glUniform3uiv(toLocation, 1, u); break;
+        case GL_UNSIGNED_INT_VEC4: glGetUniformuiv(from, fromLocation, u); glUniform4uiv(toLocation, 1, u); break;
+        // int, bool and every sampler/image type hold a single int
+        default:              glGetUniformiv(from, fromLocation, i); glUniform1iv(toLocation, 1, i); break;
+        }
+    }
+};
+#endif
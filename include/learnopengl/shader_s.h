@@ -4,51 +4,50 @@
 #define SHADER_H
 
 #include <glad/glad.h>
+#include <learnopengl/shader_cache.h>
+#include <learnopengl/shader_compile.h>
+#include <learnopengl/shader_preprocessor.h>
+#include <learnopengl/shader_reload.h>
+#include <learnopengl/gl_state.h>
+#include <learnopengl/render_stats.h>
 
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
 
 class Shader
 {
 public:
     unsigned int ID;
-    // constructor generates the shader on the fly
+    // the files the program was built from, includes too (see ShaderSourceCache::changed)
+    std::vector<ShaderDependency> dependencies;
+    // constructor generates the shader on the fly, with a "#define" added to every stage for each entry of
+    // defines (see ShaderVariants)
     // ------------------------------------------------------------------------
-    Shader(const char* vertexPath, const char* fragmentPath)
+    Shader(const char* vertexPath, const char* fragmentPath, const std::vector<std::string> &defines = std::vector<std::string>())
     {
-        // 1. retrieve the vertex/fragment source code from filePath
-        std::string vertexCode;
-        std::string fragmentCode;
-        std::ifstream vShaderFile;
-        std::ifstream fShaderFile;
-        // ensure ifstream objects can throw exceptions:
-        vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        try 
-        {
-            // open files
-            vShaderFile.open(vertexPath);
-            fShaderFile.open(fragmentPath);
-            std::stringstream vShaderStream, fShaderStream;
-            // read file's buffer contents into streams
-            vShaderStream << vShaderFile.rdbuf();
-            fShaderStream << fShaderFile.rdbuf();
-            // close file handlers
-            vShaderFile.close();
-            fShaderFile.close();
-            // convert stream into string
-            vertexCode   = vShaderStream.str();
-            fragmentCode = fShaderStream.str();
-        }
-        catch (std::ifstream::failure& e)
-        {
-            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
-        }
+        // 1. retrieve the source code from filePath, with its #includes expanded
+        ShaderPreprocessor preprocessor(defines);
+        std::string vertexCode = preprocessor.load(vertexPath);
+        std::string fragmentCode = preprocessor.load(fragmentPath);
+        dependencies = preprocessor.dependencies();
+        // remember where the program came from, for reload()
+        reloader.setDefines(defines);
+        reloader.addStage(GL_VERTEX_SHADER, vertexPath);
+        reloader.addStage(GL_FRAGMENT_SHADER, fragmentPath);
         const char* vShaderCode = vertexCode.c_str();
         const char * fShaderCode = fragmentCode.c_str();
-        // 2. compile shaders
+        // 2. link from the program binary cache when this exact program was built before
+        std::vector<std::pair<GLenum, std::string> > stages;
+        stages.push_back(std::make_pair(GLenum(GL_VERTEX_SHADER), vertexCode));
+        stages.push_back(std::make_pair(GLenum(GL_FRAGMENT_SHADER), fragmentCode));
+        ID = glCreateProgram();
+        ProgramBinaryCache::Entry cache(ID, stages, shaderVariantName(vertexPath, defines));
+        if(cache.load())
+            return;
+        // 3. compile shaders
         unsigned int vertex, fragment;
         // vertex shader
         vertex = glCreateShader(GL_VERTEX_SHADER);
@@ -61,43 +60,77 @@ public:
         glCompileShader(fragment);
         checkCompileErrors(fragment, "FRAGMENT");
         // shader Program
-        ID = glCreateProgram();
         glAttachShader(ID, vertex);
         glAttachShader(ID, fragment);
+        cache.prepareLink();
         glLinkProgram(ID);
         checkCompileErrors(ID, "PROGRAM");
         // delete the shaders as they're linked into our program now and no longer necessary
         glDeleteShader(vertex);
         glDeleteShader(fragment);
+        if(pending.pending())
+            pending.cache = std::make_shared<ProgramBinaryCache::Entry>(cache);
+        else
+            cache.store();
     }
     // activate the shader
     // ------------------------------------------------------------------------
-    void use() 
-    { 
-        glUseProgram(ID); 
+    void use()
+    {
+        // first use of a program built by a ShaderCompileQueue: report its errors now
+        if(pending.pending())
+            finishBuild();
+        if(GLState::useProgram(ID))
+            RenderStatsCollector::bindProgram();
+    }
+    // rebuilds the program from its files and swaps it into ID if it links, see ShaderWatcher
+    // ------------------------------------------------------------------------
+    ShaderReloadStatus reload()
+    {
+        if(pending.pending())
+            finishBuild();
+        return reloader.update(ID, dependencies);
     }
     // utility uniform functions
     // ------------------------------------------------------------------------
     void setBool(const std::string &name, bool value) const
     {         
         glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value); 
+        RenderStatsCollector::uploadUniform();
     }
     // ------------------------------------------------------------------------
     void setInt(const std::string &name, int value) const
     { 
         glUniform1i(glGetUniformLocation(ID, name.c_str()), value); 
+        RenderStatsCollector::uploadUniform();
     }
     // ------------------------------------------------------------------------
     void setFloat(const std::string &name, float value) const
     { 
         glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+        RenderStatsCollector::uploadUniform();
     }
 
 private:
+    mutable PendingShaderChecks pending;
+    ShaderReload reloader;
+
+    // runs the checks postponed by a ShaderCompileQueue
+    void finishBuild() const
+    {
+        pending.finish([this](GLuint object, const std::string &type) { checkCompileErrors(object, type, true); });
+    }
+
     // utility function for checking shader compilation/linking errors.
     // ------------------------------------------------------------------------
-    void checkCompileErrors(unsigned int shader, std::string type)
+    void checkCompileErrors(unsigned int shader, std::string type, bool now = false) const
     {
+        // while a ShaderCompileQueue is open the check waits for the first use(), so the driver isn't forced to finish
+        if(!now && ShaderCompileQueue::deferring())
+        {
+            pending.defer(shader, type);
+            return;
+        }
         int success;
         char infoLog[1024];
         if (type != "PROGRAM")
@@ -107,6 +140,7 @@ private:
             {
                 glGetShaderInfoLog(shader, 1024, NULL, infoLog);
                 std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+                printShaderSources(dependencies);
             }
         }
         else
@@ -0,0 +1,95 @@
+#ifndef SHADER_VARIANTS_H
+#define SHADER_VARIANTS_H
+
+#include <learnopengl/shader_s.h> // skipped if shader.h or shader_m.h came first, they take defines too
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// All the variants of one vertex/fragment pair, selected by #define at compile time instead of branching on
+// uniforms at run time. Each feature is a bit of the variant key; a variant is compiled the first time its
+// key is requested and then reused:
+//
+//     ShaderVariants variants("shader.vs", "shader.fs", {"UPSIDE_DOWN", "MOVEMENT"});
+//     Shader &shader = variants.get(variants.bit("MOVEMENT"));
+//     shader.use();
+//
+// The sources see "#define UPSIDE_DOWN" etc. right after their #version line.
+class ShaderVariants
+{
+public:
+    ShaderVariants(const char* vertexPath, const char* fragmentPath, const std::vector<std::string> &features)
+        : vertexPath(vertexPath), fragmentPath(fragmentPath), features(features), lookups(0), compileMs(0.0)
+    {
+        if(features.size() > 32)
+            std::cout << "ERROR::SHADER::VARIANTS:: at most 32 features, the others are ignored" << std::endl;
+    }
+
+    // the key bit of a feature, 0 (with an error) if the feature is unknown
+    unsigned int bit(const std::string &feature) const
+    {
+        for(unsigned int i = 0; i < features.size() && i < 32; i++)
+            if(features[i] == feature)
+                return 1u << i;
+        std::cout << "ERROR::SHADER::VARIANTS:: unknown feature " << feature << std::endl;
+        return 0;
+    }
+
+    // the program for the given combination of features, compiled on first use
+    Shader& get(unsigned int key)
+    {
+        lookups++;
+        std::map<unsigned int, std::unique_ptr<Shader> >::iterator it = variants.find(key);
+        if(it != variants.end())
+            return *it->second;
+
+        std::vector<std::string> defines;
+        for(unsigned int i = 0; i < features.size() && i < 32; i++)
+            if(key & (1u << i))
+                defines.push_back(features[i]);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::unique_ptr<Shader> &shader = variants[key];
+        shader.reset(new Shader(vertexPath.c_str(), fragmentPath.c_str(), defines));
+        compileMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return *shader;
+    }
+
+    // builds a set of variants up front, e.g. inside a ShaderCompileQueue to compile them in parallel
+    void warmUp(const std::vector<unsigned int> &keys)
+    {
+        for(unsigned int i = 0; i < keys.size(); i++)
+            get(keys[i]);
+    }
+
+    size_t variantCount() const
+    {
+        return variants.size();
+    }
+
+    // time spent in the Shader constructors of all the variants built so far (binary cache loads included)
+    double compileTime() const
+    {
+        return compileMs;
+    }
+
+    void printStats() const
+    {
+        std::cout << "SHADER::VARIANTS:: " << vertexPath << ": " << variants.size() << " of " << (1ull << std::min<size_t>(features.size(), 32))
+                  << " variants built in " << compileMs << " ms, " << lookups << " lookups" << std::endl;
+    }
+
+private:
+    std::string vertexPath;
+    std::string fragmentPath;
+    std::vector<std::string> features;
+    std::map<unsigned int, std::unique_ptr<Shader> > variants;
+    unsigned long long lookups;
+    double compileMs;
+};
+#endif
@@ -0,0 +1,230 @@
+#ifndef SHADER_WATCHER_H
+#define SHADER_WATCHER_H
+
+#include <learnopengl/shader_s.h> // skipped if another shader header came first, they all have reload()
+#include <learnopengl/shader_preprocessor.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Reloads shaders while the program runs, when one of their files (includes too) is saved:
+//
+//     ShaderWatcher watcher(TARGET_SOURCE_DIR);
+//     watcher.watch(ourShader);
+//     while(...)
+//     {
+//         watcher.poll(); // between frames, never in the middle of one
+//         ...
+//     }
+//
+// On Linux the files are watched with inotify, elsewhere their modification times are checked a few times
+// per second. The CMake build copies the shaders next to the executable, so edits in the source directory
+// (TARGET_SOURCE_DIR, defined for every exercise) are copied over the build copies first.
+class ShaderWatcher
+{
+public:
+    explicit ShaderWatcher(const std::string &sourceDirectory = "")
+        : sourceDirectory(sourceDirectory), fd(-1), lastScan(std::chrono::steady_clock::now())
+    {
+#ifdef __linux__
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if(fd < 0)
+            std::cout << "SHADER::WATCHER:: inotify not available, checking modification times instead" << std::endl;
+        if(!sourceDirectory.empty())
+            addDirectory(sourceDirectory);
+#endif
+    }
+
+    ~ShaderWatcher()
+    {
+#ifdef __linux__
+        if(fd >= 0)
+            close(fd);
+#endif
+    }
+
+    ShaderWatcher(const ShaderWatcher&) = delete;
+    ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+
+    // the shader must outlive the watcher, or be removed with unwatch()
+    void watch(Shader &shader)
+    {
+        Watched watched = { &shader, false, false, std::chrono::steady_clock::now() };
+        shaders.push_back(watched);
+        addDirectories(shader);
+    }
+
+    void unwatch(Shader &shader)
+    {
+        for(unsigned int i = 0; i < shaders.size(); i++)
+            if(shaders[i].shader == &shader)
+            {
+                shaders.erase(shaders.begin() + i);
+                return;
+            }
+    }
+
+    // call once per frame: reloads the shaders whose files changed, returns how many were swapped in
+    unsigned int poll()
+    {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if(fd >= 0)
+            readEvents(now);
+        else if(now - lastScan >= std::chrono::milliseconds(250))
+        {
+            lastScan = now;
+            for(unsigned int i = 0; i < shaders.size(); i++)
+                if(!shaders[i].dirty && ShaderSourceCache::changed(shaders[i].shader->dependencies))
+                    markDirty(shaders[i], now);
+        }
+
+        unsigned int reloaded = 0;
+        for(unsigned int i = 0; i < shaders.size(); i++)
+        {
+            Watched &watched = shaders[i];
+            // editors often save in several writes, wait for them to settle
+            if(!watched.reloading && (!watched.dirty || now - watched.changed < std::chrono::milliseconds(50)))
+                continue;
+            // a save during a build in flight starts another one once it's done
+            if(!watched.reloading)
+                watched.dirty = false;
+            ShaderReloadStatus status = watched.shader->reload();
+            watched.reloading = status == SHADER_RELOAD_PENDING;
+            if(status == SHADER_RELOAD_DONE)
+                reloaded++;
+            // a new #include may live in a directory not watched yet
+            if(status != SHADER_RELOAD_PENDING)
+                addDirectories(*watched.shader);
+        }
+        return reloaded;
+    }
+
+private:
+    struct Watched {
+        Shader* shader;
+        bool dirty;
+        bool reloading; // waiting for the driver to finish the new program
+        std::chrono::steady_clock::time_point changed;
+    };
+
+    std::vector<Watched> shaders;
+    std::string sourceDirectory;
+    int fd;
+    std::map<int, std::string> directories; // inotify watch descriptor -> directory, with a trailing '/'
+    std::chrono::steady_clock::time_point lastScan;
+
+    static std::string directoryOf(const std::string &path)
+    {
+        size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? "" : path.substr(0, slash + 1);
+    }
+
+    static std::string fileName(const std::string &path)
+    {
+        size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+
+    void markDirty(Watched &watched, std::chrono::steady_clock::time_point now)
+    {
+        watched.dirty = true;
+        watched.changed = now;
+    }
+
+    void addDirectories(const Shader &shader)
+    {
+        for(unsigned int i = 0; i < shader.dependencies.size(); i++)
+            addDirectory(directoryOf(shader.dependencies[i].path));
+    }
+
+    void addDirectory(std::string directory)
+    {
+#ifdef __linux__
+        if(fd < 0)
+            return;
+        if(!directory.empty() && directory[directory.size() - 1] != '/')
+            directory += '/';
+        for(std::map<int, std::string>::const_iterator it = directories.begin(); it != directories.end(); ++it)
+            if(it->second == directory)
+                return;
+        // the directory, not the file: editors that save to a temporary file and rename it replace the file
+        int wd = inotify_add_watch(fd, directory.empty() ? "." : directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if(wd < 0)
+            std::cout << "SHADER::WATCHER:: can't watch " << (directory.empty() ? "." : directory) << std::endl;
+        else
+            directories[wd] = directory;
+#else
+        (void)directory;
+#endif
+    }
+
+    void readEvents(std::chrono::steady_clock::time_point now)
+    {
+#ifdef __linux__
+        alignas(inotify_event) char buffer[4096];
+        for(;;)
+        {
+            ssize_t length = read(fd, buffer, sizeof(buffer));
+            if(length <= 0)
+                break;
+            for(char* p = buffer; p < buffer + length; p += sizeof(inotify_event) + reinterpret_cast<inotify_event*>(p)->len)
+            {
+                const inotify_event* event = reinterpret_cast<inotify_event*>(p);
+                std::map<int, std::string>::const_iterator directory = directories.find(event->wd);
+                if(event->len == 0 || directory == directories.end())
+                    continue;
+                fileChanged(directory->second, event->name, now);
+            }
+        }
+#else
+        (void)now;
+#endif
+    }
+
+    void fileChanged(const std::string &directory, const std::string &name, std::chrono::steady_clock::time_point now)
+    {
+        std::string path = directory + name;
+        std::string source = sourceDirectory;
+        if(!source.empty() && source[source.size() - 1] != '/')
+            source += '/';
+        std::vector<std::string> copied;
+        for(unsigned int i = 0; i < shaders.size(); i++)
+        {
+            const std::vector<ShaderDependency> &dependencies = shaders[i].shader->dependencies;
+            for(unsigned int j = 0; j < dependencies.size(); j++)
+            {
+                if(dependencies[j].path == path)
+                    markDirty(shaders[i], now);
+                // the source of a copied file: update the copy, its own event triggers the reload
+                else if(directory == source && directoryOf(dependencies[j].path) != source &&
+                        fileName(dependencies[j].path) == name &&
+                        std::find(copied.begin(), copied.end(), dependencies[j].path) == copied.end())
+                {
+                    copyFile(path, dependencies[j].path);
+                    copied.push_back(dependencies[j].path);
+                }
+            }
+        }
+    }
+
+    static void copyFile(const std::string &from, const std::string &to)
+    {
+        std::ifstream input(from.c_str(), std::ios::binary);
+        std::ofstream output(to.c_str(), std::ios::binary | std::ios::trunc);
+        if(!input || !(output << input.rdbuf()))
+            std::cout << "SHADER::WATCHER:: can't copy " << from << " to " << to << std::endl;
+        else
+            std::cout << "SHADER::WATCHER:: " << from << " changed, copied to " << to << std::endl;
+    }
+};
+#endif
@@ -0,0 +1,211 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <learnopengl/profiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed-timestep simulation on its own thread, so that transforms, animations and the camera advance by the
+// same amount every step whatever the frame rate, and a slow frame doesn't slow the simulation down:
+//
+//     struct Scene { float angle; };
+//     Simulation<Scene> simulation(Scene{0.0f}, 60.0, [](Scene &scene, double dt) { scene.angle += dt; });
+//     simulation.start();
+//     while (...)
+//     {
+//         simulation.post([](Scene &scene) { ... });         // input, applied before the next step
+//         Scene scene = simulation.interpolate([](const Scene &a, const Scene &b, float t) {
+//             return Scene{a.angle + (b.angle - a.angle) * t};
+//         });
+//         ...draw scene...
+//     }
+//
+// The state is only touched by the simulation thread: after each step a copy of it is published as a snapshot.
+// The render thread reads the last two snapshots and draws the present between them, one step behind, so the
+// motion stays smooth when the frame rate and the step rate differ. The State must be cheap to copy: keep the
+// results (model matrices, bone matrices from Animator::GetFinalBoneMatrices, camera position) in it, not the
+// objects producing them.
+//
+// Without start() nothing runs in the background: step() advances one step on the calling thread, e.g. once a
+// frame in headless runs so that --screenshot gives the same image every time.
+template<typename State>
+class Simulation
+{
+public:
+    typedef std::function<void(State&, double)> Step;
+    typedef std::function<void(State&)> Command;
+    typedef std::function<State(const State&, const State&, float)> Interpolate;
+
+    // step(state, seconds) is called `rate` times a second
+    Simulation(const State &initial, double rate, const Step &step)
+        : state(initial), previous(initial), current(initial), stepFunction(step),
+          stepSeconds(1.0 / rate), steps(0), previousTime(), currentTime(), running(false), stopping(false)
+    {
+    }
+
+    ~Simulation()
+    {
+        stop();
+    }
+
+    Simulation(const Simulation &) = delete;
+    Simulation &operator=(const Simulation &) = delete;
+
+    void start()
+    {
+        if(running)
+            return;
+        stopping = false;
+        running = true;
+        currentTime = previousTime = std::chrono::steady_clock::now();
+        thread = std::thread(&Simulation::run, this);
+    }
+
+    void stop()
+    {
+        if(!running)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        thread.join();
+        running = false;
+    }
+
+    // one step on the calling thread, only when the simulation is not started
+    void step()
+    {
+        if(running)
+            return;
+        applyCommands();
+        stepFunction(state, stepSeconds);
+        publish(std::chrono::steady_clock::now());
+    }
+
+    // runs on the simulation thread before the next step, in the order posted
+    void post(const Command &command)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        commands.push_back(command);
+    }
+
+    // the last published state
+    State latest() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return current;
+    }
+
+    // the state as it was one step ago from now, between the last two snapshots
+    State interpolate(const Interpolate &function) const
+    {
+        State a, b;
+        const float t = snapshots(a, b);
+        return function(a, b, t);
+    }
+
+    // copies the last two snapshots and returns where the present falls between them, in [0, 1]
+    float snapshots(State &a, State &b) const
+    {
+        std::chrono::steady_clock::time_point from, to;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            a = previous;
+            b = current;
+            from = previousTime;
+            to = currentTime;
+        }
+        if(!running || to <= from)
+            return 1.0f;
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - to).count();
+        return static_cast<float>(std::min(1.0, std::max(0.0, elapsed / stepSeconds)));
+    }
+
+    unsigned long long stepCount() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return steps;
+    }
+
+    double stepDuration() const
+    {
+        return stepSeconds;
+    }
+
+private:
+    // at most this many steps to catch up after a stall (e.g. the window being dragged), then time is dropped
+    static const int MAX_CATCH_UP = 5;
+
+    State state;                // only used by the thread stepping
+    State previous;
+    State current;
+    Step stepFunction;
+    double stepSeconds;
+    unsigned long long steps;
+    std::chrono::steady_clock::time_point previousTime;
+    std::chrono::steady_clock::time_point currentTime;
+    std::vector<Command> commands;
+    std::vector<Command> pending;
+    mutable std::mutex mutex;
+    std::thread thread;
+    bool running;
+    bool stopping;
+
+    void applyCommands()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.swap(commands);
+        }
+        for(size_t i = 0; i < pending.size(); i++)
+            pending[i](state);
+        pending.clear();
+    }
+
+    void publish(std::chrono::steady_clock::time_point time)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::swap(previous, current);
+        current = state;
+        previousTime = currentTime;
+        currentTime = time;
+        steps++;
+    }
+
+    void run()
+    {
+        PROFILE_THREAD("simulation");
+        const std::chrono::steady_clock::duration interval =
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(stepSeconds));
+        std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now() + interval;
+        for(;;)
+        {
+            std::this_thread::sleep_until(next);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if(stopping)
+                    return;
+            }
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            int behind = 0;
+            while(next <= now && behind < MAX_CATCH_UP)
+            {
+                PROFILE_ZONE("step");
+                applyCommands();
+                stepFunction(state, stepSeconds);
+                publish(next);
+                next += interval;
+                behind++;
+            }
+            if(next <= now)
+                next = now + interval;
+        }
+    }
+};
+#endif
@@ -0,0 +1,158 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// How a mesh stores its vertices on the GPU. The CPU side always keeps the full Vertex (see mesh.h);
+// the layout only decides what gets uploaded and how the attribute pointers are set up.
+//
+// The compact layouts keep the same attribute locations as the full one, but:
+//  - location 1 (normal) is an octahedral-encoded vec2 instead of a vec3
+//  - location 3 (tangent) is a vec4: octahedral-encoded tangent in xy, bitangent sign in z
+//  - location 4 (bitangent) is not provided anymore, rebuild it as cross(N, T) * sign
+//  - location 2 (texCoords) is half-float, location 5/6 (bone ids/weights) are 8 bit
+// so the vertex shader has to decode them: resources/shaders/vertex_layout.glsl does it, e.g.
+//
+//     #version 330 core
+//     #include "vertex_layout.glsl"
+//     ...
+//     vec3 N = vertexNormal(), T = vertexTangent(), B = vertexBitangent();
+//
+// built with the defines vertexLayoutDefines() returns (see resources/shaders/model.vs):
+//
+//     Shader shader("resources/shaders/model.vs", "resources/shaders/model.fs", vertexLayoutDefines(layout));
+enum VertexLayout {
+    VERTEX_LAYOUT_FULL,    // the plain Vertex struct, 88 bytes
+    VERTEX_LAYOUT_STATIC,  // StaticVertex, 28 bytes, no bone data
+    VERTEX_LAYOUT_SKINNED, // SkinnedVertex, 36 bytes, 8 bit bone indices and unorm8 weights
+    VERTEX_LAYOUT_COMPACT  // STATIC or SKINNED, picked per mesh depending on whether it has bones
+};
+
+struct StaticVertex {
+    // position
+    float    Position[3];
+    // octahedral normal (snorm16)
+    int16_t  Normal[2];
+    // octahedral tangent (snorm16), bitangent sign, padding
+    int16_t  Tangent[4];
+    // texCoords (half float)
+    uint16_t TexCoords[2];
+};
+
+struct SkinnedVertex {
+    float    Position[3];
+    int16_t  Normal[2];
+    int16_t  Tangent[4];
+    uint16_t TexCoords[2];
+    // bone indexes which will influence this vertex
+    uint8_t  BoneIDs[4];
+    // weights from each bone (unorm8, summing up to 255)
+    uint8_t  Weights[4];
+};
+
+static_assert(sizeof(StaticVertex) == 28, "StaticVertex must be tightly packed");
+static_assert(sizeof(SkinnedVertex) == 36, "SkinnedVertex must be tightly packed");
+
+inline const char* vertexLayoutName(VertexLayout layout)
+{
+    switch (layout)
+    {
+    case VERTEX_LAYOUT_FULL:    return "full";
+    case VERTEX_LAYOUT_STATIC:  return "static";
+    case VERTEX_LAYOUT_SKINNED: return "skinned";
+    case VERTEX_LAYOUT_COMPACT: return "compact";
+    }
+    return "unknown";
+}
+
+// the shader defines vertex_layout.glsl needs to decode meshes stored with the given layout
+inline std::vector<std::string> vertexLayoutDefines(VertexLayout layout)
+{
+    std::vector<std::string> defines;
+    if (layout != VERTEX_LAYOUT_FULL)
+        defines.push_back("VERTEX_LAYOUT_COMPACT");
+    return defines;
+}
+
+// maps a unit vector on the octahedron and unfolds it onto the [-1, 1] square
+inline glm::vec2 octEncode(const glm::vec3& v)
+{
+    float l1 = std::fabs(v.x) + std::fabs(v.y) + std::fabs(v.z);
+    // degenerate vectors (e.g. missing tangents) decode to +Z
+    if (l1 <= 1e-12f || !std::isfinite(l1))
+        return glm::vec2(0.0f, 0.0f);
+
+    glm::vec3 n = v / l1;
+    glm::vec2 e(n.x, n.y);
+    if (n.z < 0.0f)
+    {
+        e.x = (1.0f - std::fabs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+        e.y = (1.0f - std::fabs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    return e;
+}
+
+// inverse of octEncode, mirrors the GLSL octDecode above
+inline glm::vec3 octDecode(const glm::vec2& e)
+{
+    glm::vec3 n(e.x, e.y, 1.0f - std::fabs(e.x) - std::fabs(e.y));
+    if (n.z < 0.0f)
+    {
+        float x = n.x;
+        n.x = (1.0f - std::fabs(n.y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        n.y = (1.0f - std::fabs(x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    return glm::normalize(n);
+}
+
+inline int16_t quantizeSnorm16(float v)
+{
+    return static_cast<int16_t>(glm::packSnorm1x16(v));
+}
+
+// quantizes the weights to unorm8 making sure they still sum up to exactly 255,
+// the rounding error is given to the heaviest influence
+inline void quantizeWeights(const float* weights, int count, uint8_t* out)
+{
+    float total = 0.0f;
+    for (int i = 0; i < count; i++)
+        total += weights[i] > 0.0f ? weights[i] : 0.0f;
+
+    if (total <= 0.0f)
+    {
+        for (int i = 0; i < count; i++)
+            out[i] = 0;
+        return;
+    }
+
+    int sum = 0, heaviest = 0;
+    for (int i = 0; i < count; i++)
+    {
+        float w = weights[i] > 0.0f ? weights[i] / total : 0.0f;
+        out[i] = static_cast<uint8_t>(std::floor(w * 255.0f + 0.5f));
+        sum += out[i];
+        if (out[i] > out[heaviest])
+            heaviest = i;
+    }
+    out[heaviest] = static_cast<uint8_t>(out[heaviest] + (255 - sum));
+}
+
+// how much GPU memory a model's vertices take with the chosen layout compared to the full one
+struct VertexMemoryStats {
+    size_t vertexCount = 0;
+    size_t fullBytes   = 0;
+    size_t layoutBytes = 0;
+
+    size_t savedBytes() const
+    {
+        return fullBytes > layoutBytes ? fullBytes - layoutBytes : 0;
+    }
+};
+#endif
@@ -0,0 +1,28 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+in vec3 Normal;
+in vec3 Tangent;
+in vec3 Bitangent;
+
+// samplers set by Mesh::Draw
+uniform sampler2D texture_diffuse1;
+#ifdef NORMAL_MAP
+uniform sampler2D texture_normal1;
+#endif
+
+uniform vec3 lightDirection = vec3(-0.3, -1.0, -0.5);
+
+void main()
+{
+	vec3 N = normalize(Normal);
+#ifdef NORMAL_MAP
+	// tangent space normal from the map, through the TBN basis of the vertex
+	mat3 TBN = mat3(normalize(Tangent), normalize(Bitangent), N);
+	N = normalize(TBN * (texture(texture_normal1, TexCoords).rgb * 2.0 - 1.0));
+#endif
+	float diffuse = max(dot(N, -normalize(lightDirection)), 0.0);
+	vec3 color = texture(texture_diffuse1, TexCoords).rgb;
+	FragColor = vec4(color * (0.1 + 0.9 * diffuse), 1.0);
+}
@@ -0,0 +1,33 @@
+#version 330 core
+// the meshes of a Model, with any vertex layout (see vertex_layout.glsl). With the INSTANCED define the model
+// matrix comes from the per-instance attribute IndirectDrawList::submit feeds (draw_indirect.h) instead
+#include "vertex_layout.glsl"
+
+layout (location = 0) in vec3 aPos;
+layout (location = 2) in vec2 aTexCoords;
+
+out vec2 TexCoords;
+out vec3 Normal;
+out vec3 Tangent;
+out vec3 Bitangent;
+
+#ifdef INSTANCED
+layout (location = 7) in mat4 aInstanceModel;
+#else
+uniform mat4 model;
+#endif
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+#ifdef INSTANCED
+	mat4 model = aInstanceModel;
+#endif
+	mat3 normalMatrix = transpose(inverse(mat3(model)));
+	TexCoords = aTexCoords;
+	Normal = normalMatrix * vertexNormal();
+	Tangent = mat3(model) * vertexTangent();
+	Bitangent = mat3(model) * vertexBitangent();
+	gl_Position = projection * view * model * vec4(aPos, 1.0);
+}
@@ -0,0 +1,26 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aColor;
+
+out vec3 ourColor;
+
+#ifdef MOVEMENT
+uniform float xOffset;
+#endif
+
+void main()
+{
+    vec3 position = aPos;
+#ifdef UPSIDE_DOWN
+    position.y = -position.y;
+#endif
+#ifdef MOVEMENT
+    position.x += xOffset;
+#endif
+    gl_Position = vec4(position, 1.0);
+#ifdef FRAGMENT_POSITION
+    ourColor = aPos;
+#else
+    ourColor = aColor;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+// The normal, tangent and bitangent of a vertex, whatever the VertexLayout its mesh is stored with (see
+// learnopengl/vertex_format.h). Include it after #version; meshes stored with the STATIC, SKINNED or COMPACT
+// layout need the VERTEX_LAYOUT_COMPACT define (vertexLayoutDefines() gives it), then:
+//  - location 1 (normal) is an octahedral-encoded vec2
+//  - location 3 (tangent) is a vec4: octahedral-encoded tangent in xy, bitangent sign in z
+//  - location 4 (bitangent) is not provided, it is rebuilt as cross(N, T) * sign
+
+#ifdef VERTEX_LAYOUT_COMPACT
+layout (location = 1) in vec2 aNormal;
+layout (location = 3) in vec4 aTangent;
+#else
+layout (location = 1) in vec3 aNormal;
+layout (location = 3) in vec3 aTangent;
+layout (location = 4) in vec3 aBitangent;
+#endif
+
+// inverse of octEncode (vertex_format.h): folds the [-1, 1] square back onto the octahedron
+vec3 octDecode(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	if (n.z < 0.0)
+		n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	return normalize(n);
+}
+
+vec3 vertexNormal()
+{
+#ifdef VERTEX_LAYOUT_COMPACT
+	return octDecode(aNormal);
+#else
+	return aNormal;
+#endif
+}
+
+vec3 vertexTangent()
+{
+#ifdef VERTEX_LAYOUT_COMPACT
+	return octDecode(aTangent.xy);
+#else
+	return aTangent;
+#endif
+}
+
+vec3 vertexBitangent()
+{
+#ifdef VERTEX_LAYOUT_COMPACT
+	return cross(octDecode(aNormal), octDecode(aTangent.xy)) * aTangent.z;
+#else
+	return aBitangent;
+#endif
+}
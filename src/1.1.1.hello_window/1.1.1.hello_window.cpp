@@ -7,8 +7,8 @@
 
 #include <GLFW/glfw3.h>
 #include <glad/glad.h>
+#include <learnopengl/application.h>
 
-#include <exception>
 #include <iostream>
 
 /* --------- Global vars and constants --------- */
@@ -31,107 +31,28 @@ const struct WINDOW_PROPS
     } CLEAR_COLOR;
 } WINDOW_PROPS;
 
-/* --------- Additional functions declaration --------- */
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow* window);
-GLFWwindow* glfwSetup();
-void clearResources();
-
 /* --------- Main --------- */
-int main()
+int main(int argc, char** argv)
 {
-    // Initialize GLFW and create window
-    GLFWwindow* window;
-    try
-    {
-        window = glfwSetup();
-    }
-    catch (const std::exception& e)
-    {
-        glfwTerminate();
-        std::cerr << e.what() << std::endl;
-        return -1;
-    }
-
-    // Load OpenGL function pointers (GLAD init)
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    // Window, OpenGL context and headless mode (see learnopengl/application.h)
+    if (!Application::init(argc, argv, WINDOW_PROPS.TITLE, WINDOW_PROPS.SCR_WIDTH, WINDOW_PROPS.SCR_HEIGHT))
     {
-        std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
 
     // Render loop
-    while (!glfwWindowShouldClose(window))
+    while (Application::beginFrame())
     {
-        // Input handling
-        processInput(window);
-
         // Render
         glClearColor(WINDOW_PROPS.CLEAR_COLOR.r, WINDOW_PROPS.CLEAR_COLOR.g,
                      WINDOW_PROPS.CLEAR_COLOR.b, WINDOW_PROPS.CLEAR_COLOR.a);
         glClear(GL_COLOR_BUFFER_BIT);
 
         // (GLFW) Swap buffers and poll IO events
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
-
-    // Once the render loop is finished, terminate GLFW and clear/free resources
-    clearResources();
-    return 0;
-}
-
-/* --------- Additional functions definition  --------- */
-
-// Setup and init GLFW
-// -----------------------------------------------------------------------------
-GLFWwindow* glfwSetup()
-{
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-// MacOS compatibility code
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-    GLFWwindow* window = glfwCreateWindow(WINDOW_PROPS.SCR_WIDTH, WINDOW_PROPS.SCR_HEIGHT,
-                                          WINDOW_PROPS.TITLE, NULL, NULL);
-
-    if (window == NULL)
-    {
-        throw std::runtime_error("Failed to create GLFW window");
+        Application::endFrame();
     }
 
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    return window;
-}
-
-// Clear resources at the end of render loop
-// -----------------------------------------------------------------------------
-void clearResources()
-{
-    glfwTerminate();
+    // Once the render loop is finished, terminate GLFW
+    return Application::terminate();
 }
 
-// User input handling
-// -----------------------------------------------------------------------------
-void processInput(GLFWwindow* window)
-{
-    // Close the window on ESC
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-    {
-        glfwSetWindowShouldClose(window, true);
-    }
-}
-
-// Resize the viewport when the window is resized
-// -----------------------------------------------------------------------------
-void framebuffer_size_callback(GLFWwindow* /*window*/, int width, int height)
-{
-    glViewport(0, 0, width, height);
-}
\ No newline at end of file
@@ -7,6 +7,8 @@
 
 #include <GLFW/glfw3.h>
 #include <glad/glad.h>
+#include <learnopengl/gl_state.h>
+#include <learnopengl/application.h>
 
 #include <exception>
 #include <iostream>
@@ -50,9 +52,6 @@ const char* FRAGMENT_SHADER_SRC =
     "}\n\0";
 
 /* --------- Additional functions declaration --------- */
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow* window);
-GLFWwindow* glfwSetup();
 std::vector<unsigned int> createShaders();
 unsigned int linkShaders(const unsigned int& vertexShader,
                          const unsigned int& fragmentShader);
@@ -60,25 +59,11 @@ std::vector<unsigned int*> getVObjects();
 void clearResources(unsigned int VBOs[], unsigned int VAOs[], unsigned int shaderProgram);
 
 /* --------- Main --------- */
-int main()
+int main(int argc, char** argv)
 {
-    // Initialize GLFW and create window
-    GLFWwindow* window;
-    try
-    {
-        window = glfwSetup();
-    }
-    catch (const std::exception& e)
+    // Window, OpenGL context and headless mode (see learnopengl/application.h)
+    if (!Application::init(argc, argv, WINDOW_PROPS.TITLE, WINDOW_PROPS.SCR_WIDTH, WINDOW_PROPS.SCR_HEIGHT))
     {
-        glfwTerminate();
-        std::cerr << e.what() << std::endl;
-        return -1;
-    }
-
-    // Load OpenGL function pointers (GLAD init)
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cerr << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
 
@@ -136,67 +121,35 @@ int main()
     // glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
     // Render loop
-    while (!glfwWindowShouldClose(window))
+    while (Application::beginFrame())
     {
-        // Input handling
-        processInput(window);
-
         // Render
         glClearColor(WINDOW_PROPS.CLEAR_COLOR.r, WINDOW_PROPS.CLEAR_COLOR.g,
                      WINDOW_PROPS.CLEAR_COLOR.b, WINDOW_PROPS.CLEAR_COLOR.a);
         glClear(GL_COLOR_BUFFER_BIT);
 
         // Draw the two triangles
-        glUseProgram(shaderProgram);
+        GLState::useProgram(shaderProgram);
 
         // First triangle
-        glBindVertexArray(VAOs[0]);
+        GLState::bindVertexArray(VAOs[0]);
         glDrawArrays(GL_TRIANGLES, 0, 3);  // Start drawing from index 0 and size 3
 
         // Second triangle
-        glBindVertexArray(VAOs[1]);
+        GLState::bindVertexArray(VAOs[1]);
         glDrawArrays(GL_TRIANGLES, 0, 3);  // Start drawing from index 0 and size 3
 
         // (GLFW) Swap buffers and poll IO events
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        Application::endFrame();
     }
 
     // Once the render loop is finished, terminate GLFW and clear/free resources
     clearResources(VBOs, VAOs, shaderProgram);
-    return 0;
+    return Application::terminate();
 }
 
 /* --------- Additional functions definition  --------- */
 
-// Setup and init GLFW
-// -----------------------------------------------------------------------------
-GLFWwindow* glfwSetup()
-{
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-// MacOS compatibility code
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-    GLFWwindow* window = glfwCreateWindow(WINDOW_PROPS.SCR_WIDTH, WINDOW_PROPS.SCR_HEIGHT,
-                                          WINDOW_PROPS.TITLE, NULL, NULL);
-
-    if (window == NULL)
-    {
-        throw std::runtime_error("Failed to create GLFW window");
-    }
-
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    return window;
-}
-
 // Create and compile vertex shader and fragment shader
 // -----------------------------------------------------------------------------
 std::vector<unsigned int> createShaders()
@@ -326,23 +279,4 @@ void clearResources(unsigned int VBOs[], unsigned int VAOs[], unsigned int shade
     glDeleteVertexArrays(2, VAOs);
     glDeleteBuffers(2, VBOs);
     glDeleteProgram(shaderProgram);
-    glfwTerminate();
 }
-
-// User input handling
-// -----------------------------------------------------------------------------
-void processInput(GLFWwindow* window)
-{
-    // Close the window on ESC
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-    {
-        glfwSetWindowShouldClose(window, true);
-    }
-}
-
-// Resize the viewport when the window is resized
-// -----------------------------------------------------------------------------
-void framebuffer_size_callback(GLFWwindow* /*window*/, int width, int height)
-{
-    glViewport(0, 0, width, height);
-}
\ No newline at end of file
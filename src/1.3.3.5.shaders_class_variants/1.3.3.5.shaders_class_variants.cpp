@@ -0,0 +1,196 @@
+/******************************************************************************
+ * File:        1.3.3.5.shaders_class_variants.cpp
+ * Author:      Davide Tarpini (https://github.com/Sparkhand)
+ * Description: This example combines the upside-down, movement and fragment
+ *              position homeworks, which all load the shared
+ *              resources/shaders/shaders_class source with one define each,
+ *              and turns their #define variants on and off at runtime. Press
+ *              1, 2 and 3 to toggle them. All the combinations are submitted
+ *              to the driver together at startup, so toggling never waits
+ *              for a compile.
+ *****************************************************************************/
+
+#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+
+#include <learnopengl/shader_variants.h>
+#include <learnopengl/shader_compile.h>
+#include <learnopengl/application.h>
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/* --------- Global vars and constants --------- */
+
+// Window/Screen properties
+const struct WINDOW_PROPS
+{
+    // Screen
+    const unsigned int SCR_WIDTH = 800;
+    const unsigned int SCR_HEIGHT = 600;
+    // Window title
+    const char* TITLE = "LearnOpenGL - 1.3.3 - Shaders Class";
+    // Clear color
+    const struct CLEAR_COLOR
+    {
+        float r = 0.2f;
+        float g = 0.3f;
+        float b = 0.3f;
+        float a = 1.0f;
+    } CLEAR_COLOR;
+} WINDOW_PROPS;
+
+// Shader features, in key bit order, and the keys that toggle them
+const std::vector<std::string> FEATURES = {"UPSIDE_DOWN", "MOVEMENT", "FRAGMENT_POSITION"};
+const int FEATURE_KEYS[] = {GLFW_KEY_1, GLFW_KEY_2, GLFW_KEY_3};
+
+/* --------- Additional functions declaration --------- */
+void processInput(GLFWwindow* window, unsigned int& variantKey);
+std::vector<unsigned int> getVObjects();
+void clearResources(unsigned int VBO, unsigned int VAO);
+
+/* --------- Main --------- */
+int main(int argc, char** argv)
+{
+    // Window, OpenGL context and headless mode (see learnopengl/application.h)
+    GLFWwindow* window = Application::init(argc, argv, WINDOW_PROPS.TITLE, WINDOW_PROPS.SCR_WIDTH,
+                                           WINDOW_PROPS.SCR_HEIGHT);
+    if (!window)
+    {
+        return -1;
+    }
+
+    // Shader variants: start with all the features off
+    ShaderVariants variants("resources/shaders/shaders_class.vs",
+                            "resources/shaders/shaders_class.fs", FEATURES);
+    unsigned int variantKey = 0;
+
+    // Build every combination up front. Inside the queue the compile status
+    // is only checked on the first use() of each variant, so the driver
+    // compiles them all together (in parallel when it can)
+    std::vector<unsigned int> allKeys;
+    for (unsigned int key = 0; key < (1u << FEATURES.size()); key++)
+    {
+        allKeys.push_back(key);
+    }
+    ShaderCompileQueue::begin();
+    variants.warmUp(allKeys);
+    ShaderCompileQueue::end();
+
+    // Vertex data and buffer
+    std::vector<unsigned int> vObjects = getVObjects();
+
+    if (vObjects.size() != 2)
+    {
+        std::cerr << "ERROR! VertexObjects vector doesn't have 2 elements" << std::endl;
+        return -1;
+    }
+
+    unsigned int VBO = vObjects[0];
+    unsigned int VAO = vObjects[1];
+
+    // OPTIONAL: Wireframe mode (unc/comment to toggle)
+    // glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+    // Render loop
+    while (Application::beginFrame())
+    {
+        // Input handling
+        processInput(window, variantKey);
+
+        // Render
+        glClearColor(WINDOW_PROPS.CLEAR_COLOR.r, WINDOW_PROPS.CLEAR_COLOR.g,
+                     WINDOW_PROPS.CLEAR_COLOR.b, WINDOW_PROPS.CLEAR_COLOR.a);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        // Draw the triangle with the variant of the enabled features
+        Shader& ourShader = variants.get(variantKey);
+        ourShader.use();
+        if (variantKey & variants.bit("MOVEMENT"))
+        {
+            double timeValue = glfwGetTime();
+            float xOffset = static_cast<float>(sin(timeValue) / 2.0);
+            ourShader.setFloat("xOffset", xOffset);
+        }
+        GLState::bindVertexArray(VAO);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+
+        // (GLFW) Swap buffers and poll IO events
+        Application::endFrame();
+    }
+
+    // Once the render loop is finished, terminate GLFW and clear/free resources
+    variants.printStats();
+    clearResources(VBO, VAO);
+    return Application::terminate();
+}
+
+/* --------- Additional functions definition  --------- */
+
+// Creation of vertex data and buffer objects, and binding
+// -----------------------------------------------------------------------------
+std::vector<unsigned int> getVObjects()
+{
+    // Vertices
+    const float VERTICES[] = {
+        // positions         // colors
+        0.5f,  -0.5f, 0.0f, 1.0f, 0.0f, 0.0f,  // bottom right
+        -0.5f, -0.5f, 0.0f, 0.0f, 1.0f, 0.0f,  // bottom left
+        0.0f,  0.5f,  0.0f, 0.0f, 0.0f, 1.0f   // top
+    };
+
+    std::vector<unsigned int> vObjects;
+
+    // Vertex buffer object (VBO) and vertex array object (VAO) creation
+    unsigned int VBO, VAO;
+    glGenBuffers(1, &VBO);
+    glGenVertexArrays(1, &VAO);
+
+    // Bind VAO first, then bind and set vertex buffer(s), and then configure
+    // vertex attributes(s)
+    glBindVertexArray(VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(VERTICES), VERTICES, GL_STATIC_DRAW);
+
+    // Position attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    // Color attribute
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float),
+                          (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // Unbind VAO
+    glBindVertexArray(0);
+
+    return {VBO, VAO};
+}
+
+// Clear resources at the end of render loop
+// -----------------------------------------------------------------------------
+void clearResources(unsigned int VBO, unsigned int VAO)
+{
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+}
+
+// User input handling
+// -----------------------------------------------------------------------------
+void processInput(GLFWwindow* window, unsigned int& variantKey)
+{
+    // Toggle a feature when its key is pressed (not while it is held down)
+    static bool wasPressed[3] = {false, false, false};
+    for (unsigned int i = 0; i < FEATURES.size(); i++)
+    {
+        bool pressed = glfwGetKey(window, FEATURE_KEYS[i]) == GLFW_PRESS;
+        if (pressed && !wasPressed[i])
+        {
+            variantKey ^= 1u << i;
+        }
+        wasPressed[i] = pressed;
+    }
+}
@@ -3,15 +3,16 @@
  * Author:      Davide Tarpini (https://github.com/Sparkhand)
  * Description: Starting from 1.4.2.textures_combined, this exercise requires
  *              to change the interpolation coefficient over time or by
- *              pressing a key.
+ *              pressing a key. The shaders are reloaded when they're
+ *              saved, so the blending can be tweaked while it runs.
  *****************************************************************************/
 
 #include <GLFW/glfw3.h>
 #include <glad/glad.h>
 #include <learnopengl/shader.h>
-
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
+#include <learnopengl/shader_watcher.h>
+#include <learnopengl/application.h>
+#include <learnopengl/image.h>
 
 #include <iostream>
 #include <string>
@@ -42,39 +43,29 @@ bool isInterpCoeffTimeBased = true;
 float textureInterpCoeff = 0.5f;
 
 /* --------- Additional functions declaration --------- */
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow* window);
-GLFWwindow* glfwSetup();
 std::vector<unsigned int> getVObjects();
 unsigned int loadTexture(std::string path, bool transparency = false, bool flip = false);
 void clearResources(unsigned int VBO, unsigned int VAO, unsigned int EBO);
 
 /* --------- Main --------- */
-int main()
+int main(int argc, char** argv)
 {
-    // Initialize GLFW and create window
-    GLFWwindow* window;
-    try
-    {
-        window = glfwSetup();
-    }
-    catch (const std::exception& e)
-    {
-        glfwTerminate();
-        std::cerr << e.what() << std::endl;
-        return -1;
-    }
-
-    // Load OpenGL function pointers (GLAD init)
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    // Window, OpenGL context and headless mode (see learnopengl/application.h)
+    GLFWwindow* window = Application::init(argc, argv, WINDOW_PROPS.TITLE, WINDOW_PROPS.SCR_WIDTH,
+                                           WINDOW_PROPS.SCR_HEIGHT);
+    if (!window)
     {
-        std::cerr << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
 
     // Compile and link shaders
     Shader ourShader("1.4.6.textures_exercise4.vs", "1.4.6.textures_exercise4.fs");
 
+    // Reload the shaders when they're edited in the source directory
+    ShaderWatcher shaderWatcher(TARGET_SOURCE_DIR);
+    shaderWatcher.watch(ourShader);
+
     // Vertex data and buffer
     std::vector<unsigned int> vObjects = getVObjects();
 
@@ -119,8 +110,11 @@ int main()
     ourShader.setInt("textureFace", 1);
 
     // Render loop
-    while (!glfwWindowShouldClose(window))
+    while (Application::beginFrame())
     {
+        // Swap in the shaders saved since the last frame (a broken one keeps the old program)
+        shaderWatcher.poll();
+
         // Input handling
         processInput(window);
 
@@ -130,10 +124,8 @@ int main()
         glClear(GL_COLOR_BUFFER_BIT);
 
         // Bind texture
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, textureContainer);
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, textureFace);
+        GLState::bindTextureUnit(0, GL_TEXTURE_2D, textureContainer);
+        GLState::bindTextureUnit(1, GL_TEXTURE_2D, textureFace);
 
         // Change interpolation coefficient
         if (isInterpCoeffTimeBased)
@@ -145,49 +137,20 @@ int main()
 
         // Draw container
         ourShader.use();
-        glBindVertexArray(VAO);
+        GLState::bindVertexArray(VAO);
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 
         // (GLFW) Swap buffers and poll IO events
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        Application::endFrame();
     }
 
     // Once the render loop is finished, terminate GLFW and clear/free resources
     clearResources(VBO, VAO, EBO);
-    return 0;
+    return Application::terminate();
 }
 
 /* --------- Additional functions definition  --------- */
 
-// Setup and init GLFW
-// -----------------------------------------------------------------------------
-GLFWwindow* glfwSetup()
-{
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-// MacOS compatibility code
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-    GLFWwindow* window = glfwCreateWindow(WINDOW_PROPS.SCR_WIDTH, WINDOW_PROPS.SCR_HEIGHT,
-                                          WINDOW_PROPS.TITLE, NULL, NULL);
-
-    if (window == NULL)
-    {
-        throw std::runtime_error("Failed to create GLFW window");
-    }
-
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    return window;
-}
-
 // Creation of vertex data and buffer objects, and binding
 // -----------------------------------------------------------------------------
 std::vector<unsigned int> getVObjects()
@@ -262,18 +225,14 @@ unsigned int loadTexture(std::string path, bool transparency, bool flip)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    // Load image, create texture and generate mipmaps
-    int width, height, nrChannels;
-
-    stbi_set_flip_vertically_on_load(flip);
+    // Load image (flipped for this call only), create texture and generate mipmaps
+    Image image = Image::load(path, flip);
 
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
-
-    if (data)
+    if (image)
     {
         int transparencyMode = transparency ? GL_RGBA : GL_RGB;
-        glTexImage2D(GL_TEXTURE_2D, 0, transparencyMode, width, height, 0,
-                     transparencyMode, GL_UNSIGNED_BYTE, data);
+        glTexImage2D(GL_TEXTURE_2D, 0, transparencyMode, image.width(), image.height(), 0,
+                     transparencyMode, GL_UNSIGNED_BYTE, image.data());
         glGenerateMipmap(GL_TEXTURE_2D);
     }
     else
@@ -281,8 +240,6 @@ unsigned int loadTexture(std::string path, bool transparency, bool flip)
         throw std::runtime_error("Failed to load texture");
     }
 
-    stbi_image_free(data);
-
     return texture;
 }
 
@@ -293,19 +250,12 @@ void clearResources(unsigned int VBO, unsigned int VAO, unsigned int EBO)
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
-    glfwTerminate();
 }
 
 // User input handling
 // -----------------------------------------------------------------------------
 void processInput(GLFWwindow* window)
 {
-    // Close the window on ESC
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-    {
-        glfwSetWindowShouldClose(window, true);
-    }
-
     // Check for the press of the 'M' key to toggle between automatic and manual
     // interpolation coefficient change
     if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS)
@@ -338,10 +288,3 @@ void processInput(GLFWwindow* window)
         }
     }
 }
-
-// Resize the viewport when the window is resized
-// -----------------------------------------------------------------------------
-void framebuffer_size_callback(GLFWwindow* /*window*/, int width, int height)
-{
-    glViewport(0, 0, width, height);
-}
\ No newline at end of file
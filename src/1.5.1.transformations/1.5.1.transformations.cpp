@@ -1,62 +1,51 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 #include <learnopengl/shader_s.h>
+#include <learnopengl/application.h>
+#include <learnopengl/image.h>
+#include <learnopengl/profiler.h>
+#include <learnopengl/gpu_timer.h>
+#include <learnopengl/simulation.h>
 
 #include <iostream>
 
-void framebuffer_size_callback(GLFWwindow *window, int width, int height);
 void processInput(GLFWwindow *window);
 
 // window (screen) settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 800;
 
-// rotation angle
-float rotationAngle = 0.0f;
+// rotation speed, in radians per second
+const float ROTATION_SPEED = 0.6f;
+
+// what processInput reads from the keyboard
+struct RotationInput {
+    bool autonomous;    // rotate autonomously
+    float direction;    // otherwise: 1 counter-clockwise, -1 clockwise, 0 still
+};
+RotationInput input = { true, 0.0f };
 
-// rotate autonomously
-bool rotateAutonomously = true;
+// what the simulation thread computes
+struct Rotation {
+    float angle;
+    RotationInput input;
+};
 
-int main()
+int main(int argc, char** argv)
 {
-    // Init GLFW
-    // ------------------------------
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-    // Create window
-    // --------------------
-    GLFWwindow *window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", NULL, NULL);
+    // glfw window, OpenGL context and headless mode (see learnopengl/application.h)
+    // ------------------------------------------------------------------------
+    GLFWwindow *window = Application::init(argc, argv, "LearnOpenGL", SCR_WIDTH, SCR_HEIGHT);
     if (window == NULL)
-    {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
         return -1;
-    }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
-    // glad: load all OpenGL function pointers
-    // ---------------------------------------
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cout << "Failed to initialize GLAD" << std::endl;
-        return -1;
-    }
+    // timer queries for the GPU_ZONEs, when the context has them
+    GpuTimer::init();
 
     // build and compile our shader zprogram
     // ------------------------------------
@@ -109,19 +98,16 @@ int main()
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     // load image, create texture and generate mipmaps
-    int width, height, nrChannels;
-    stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis.
-    unsigned char *data = stbi_load("resources/textures/container.jpg", &width, &height, &nrChannels, 0);
-    if (data)
+    Image image = Image::load("resources/textures/container.jpg", true); // flip the loaded texture on the y-axis.
+    if (image)
     {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, image.width(), image.height(), 0, GL_RGB, GL_UNSIGNED_BYTE, image.data());
         glGenerateMipmap(GL_TEXTURE_2D);
     }
     else
     {
         std::cout << "Failed to load texture" << std::endl;
     }
-    stbi_image_free(data);
     // texture 2
     // ---------
     glGenTextures(1, &texture2);
@@ -133,18 +119,17 @@ int main()
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     // load image, create texture and generate mipmaps
-    data = stbi_load("resources/textures/awesomeface.png", &width, &height, &nrChannels, 0);
-    if (data)
+    image = Image::load("resources/textures/awesomeface.png", true);
+    if (image)
     {
         // note that the awesomeface.png has transparency and thus an alpha channel, so make sure to tell OpenGL the data type is of GL_RGBA
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, image.width(), image.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, image.data());
         glGenerateMipmap(GL_TEXTURE_2D);
     }
     else
     {
         std::cout << "Failed to load texture" << std::endl;
     }
-    stbi_image_free(data);
 
     // tell opengl for each sampler to which texture unit it belongs to (only has to be done once)
     // -------------------------------------------------------------------------------------------
@@ -152,44 +137,74 @@ int main()
     ourShader.setInt("texture1", 0);
     ourShader.setInt("texture2", 1);
 
+    // the rotation advances 60 times a second on its own thread, whatever the frame rate
+    // ---------------------------------------------------------------------------------
+    Rotation initial = { 0.0f, input };
+    Simulation<Rotation> simulation(initial, 60.0, [](Rotation &rotation, double dt) {
+        const float direction = rotation.input.autonomous ? 1.0f : rotation.input.direction;
+        rotation.angle += direction * ROTATION_SPEED * static_cast<float>(dt);
+    });
+    // headless runs step once a frame instead, so that every run draws the same frames
+    if (!Application::headless())
+        simulation.start();
+
     // render loop
     // -----------
-    while (!glfwWindowShouldClose(window))
+    // zones are recorded with -DENABLE_PROFILER=ON (see learnopengl/profiler.h)
+    while (Application::beginFrame())
     {
         // input
         // -----
-        processInput(window);
-
-        // render
-        // ------
-        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        // bind textures on corresponding texture units
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture1);
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, texture2);
+        {
+            PROFILE_ZONE("input");
+            processInput(window);
+            const RotationInput latest = input;
+            simulation.post([latest](Rotation &rotation) { rotation.input = latest; });
+        }
 
         // create transformations
         glm::mat4 transform = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
-        transform = glm::translate(transform, glm::vec3(0.5f, -0.5f, 0.0f));
-        transform = glm::rotate(transform, rotationAngle, glm::vec3(0.0f, 0.0f, 1.0f));
-
-        // get matrix's uniform location and set matrix
-        ourShader.use();
-        unsigned int transformLoc = glGetUniformLocation(ourShader.ID, "transform");
-        glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
+        {
+            PROFILE_ZONE("update");
+            if (Application::headless())
+                simulation.step();
+            float rotationAngle = simulation.interpolate([](const Rotation &a, const Rotation &b, float t) {
+                Rotation r = b;
+                r.angle = a.angle + (b.angle - a.angle) * t;
+                return r;
+            }).angle;
+            transform = glm::translate(transform, glm::vec3(0.5f, -0.5f, 0.0f));
+            transform = glm::rotate(transform, rotationAngle, glm::vec3(0.0f, 0.0f, 1.0f));
+        }
 
-        // render container
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        // render
+        // ------
+        {
+            PROFILE_ZONE("draw");
+            GPU_ZONE("draw");
+            glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            // bind textures on corresponding texture units
+            GLState::bindTextureUnit(0, GL_TEXTURE_2D, texture1);
+            GLState::bindTextureUnit(1, GL_TEXTURE_2D, texture2);
+
+            // get matrix's uniform location and set matrix
+            ourShader.use();
+            unsigned int transformLoc = glGetUniformLocation(ourShader.ID, "transform");
+            glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
+
+            // render container
+            GLState::bindVertexArray(VAO);
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        }
 
         // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
         // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        Application::endFrame();
     }
+    simulation.stop();
+    PROFILE_WRITE_TRACE("1.5.1.transformations.trace.json");
 
     // optional: de-allocate all resources once they've outlived their purpose:
     // ------------------------------------------------------------------------
@@ -199,46 +214,30 @@ int main()
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
     // ------------------------------------------------------------------
-    glfwTerminate();
-    return 0;
+    return Application::terminate();
 }
 
 // process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
 // ---------------------------------------------------------------------------------------------------------
 void processInput(GLFWwindow *window)
 {
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
-
     // On space press, toggle autonomous rotation
     if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS)
     {
-        rotateAutonomously = !rotateAutonomously;
+        input.autonomous = !input.autonomous;
     }
 
-    if (!rotateAutonomously)
+    // the simulation turns the container while the keys are held
+    input.direction = 0.0f;
+    // On D or right arrow key press, rotate clockwise
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
     {
-        // On D or right arrow key press, rotate clockwise
-        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
-        {
-            rotationAngle -= 0.01f;
-        }
+        input.direction -= 1.0f;
+    }
 
-        // On A or left arrow key press, rotate counter-clockwise
-        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
-        {
-            rotationAngle += 0.01f;
-        }
-    } else {
-        rotationAngle += 0.01f;
+    // On A or left arrow key press, rotate counter-clockwise
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
+    {
+        input.direction += 1.0f;
     }
 }
-
-// glfw: whenever the window size changed (by OS or user resize) this callback function executes
-// ---------------------------------------------------------------------------------------------
-void framebuffer_size_callback(GLFWwindow *window, int width, int height)
-{
-    // make sure the viewport matches the new window dimensions; note that width and
-    // height will be significantly larger than specified on retina displays.
-    glViewport(0, 0, width, height);
-}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include <learnopengl/application.h>
+
+#include <learnopengl/gl_handle.h>
+#include <learnopengl/gpu_timer.h>
+#include <learnopengl/headless.h>
+#include <learnopengl/profiler.h>
+#include <learnopengl/resource_manager.h>
+#include <learnopengl/shader_cache.h>
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    struct ApplicationState {
+        GLFWwindow* window = NULL;
+        int width = 0;
+        int height = 0;
+        double start = 0.0;
+        double frameStart = 0.0;
+        double deltaTime = 0.0;
+        bool firstFrame = true;
+        std::vector<std::function<void()> > cleanups;
+    };
+
+    ApplicationState& state()
+    {
+        static ApplicationState instance;
+        return instance;
+    }
+
+    // make sure the viewport matches the new window dimensions; note that width and
+    // height will be significantly larger than specified on retina displays.
+    void framebufferSizeCallback(GLFWwindow* /*window*/, int width, int height)
+    {
+        state().width = width;
+        state().height = height;
+        glViewport(0, 0, width, height);
+    }
+
+    // runs after FramePacer::frame() polled the events of the frame
+    void closeOnEscape(GLFWwindow* window)
+    {
+        if(glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+            glfwSetWindowShouldClose(window, true);
+    }
+}
+
+GLFWwindow* Application::init(int argc, char** argv, const char* title, int width, int height)
+{
+    ApplicationState &s = state();
+
+    // --headless, --frames N, --screenshot FILE (see learnopengl/headless.h)
+    Headless::parseArguments(argc, argv);
+
+    Headless::initHints();
+    if(!glfwInit())
+    {
+        std::cout << "ERROR::APPLICATION::GLFW:: failed to initialize GLFW" << std::endl;
+        return NULL;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+    Headless::windowHints();
+
+    s.window = glfwCreateWindow(width, height, title, NULL, NULL);
+    if(s.window == NULL)
+    {
+        std::cout << "ERROR::APPLICATION::WINDOW:: failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return NULL;
+    }
+    glfwMakeContextCurrent(s.window);
+    glfwSetFramebufferSizeCallback(s.window, framebufferSizeCallback);
+
+    // glad: load all OpenGL function pointers
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cout << "ERROR::APPLICATION::GLAD:: failed to initialize GLAD" << std::endl;
+        glfwTerminate();
+        s.window = NULL;
+        return NULL;
+    }
+    glfwGetFramebufferSize(s.window, &s.width, &s.height);
+    GLContext::created();
+
+    // Offscreen framebuffer and frame timing when running headless
+    Headless::begin(s.window);
+
+    s.start = s.frameStart = glfwGetTime();
+    PROFILE_THREAD("main");
+    return s.window;
+}
+
+GLFWwindow* Application::window()
+{
+    return state().window;
+}
+
+bool Application::headless()
+{
+    return Headless::enabled();
+}
+
+bool Application::beginFrame()
+{
+    ApplicationState &s = state();
+    if(Headless::shouldClose(s.window, closeOnEscape))
+        return false;
+    const double now = glfwGetTime();
+    s.deltaTime = now - s.frameStart;
+    s.frameStart = now;
+    return true;
+}
+
+void Application::endFrame()
+{
+    // glfw: swap buffers. The IO events are polled by the next beginFrame(), once it has waited for --fps-cap,
+    // so that the input of a frame is as recent as possible
+    GpuTimer::frame();
+    {
+        PROFILE_ZONE("swap");
+        glfwSwapBuffers(state().window);
+    }
+    // resources released a few frames ago are deleted now that no recorded command can use them
+    ResourceManager::endFrame();
+    // by now the startup shaders are built, including the ones whose checks waited for their first use()
+    if(state().firstFrame)
+    {
+        state().firstFrame = false;
+        if(ProgramBinaryCache::stats().programs > 0)
+            ProgramBinaryCache::printSummary();
+    }
+    PROFILE_FRAME();
+}
+
+double Application::time()
+{
+    return glfwGetTime() - state().start;
+}
+
+double Application::deltaTime()
+{
+    return state().deltaTime;
+}
+
+int Application::width()
+{
+    return state().width;
+}
+
+int Application::height()
+{
+    return state().height;
+}
+
+void Application::onExit(const std::function<void()> &cleanup)
+{
+    state().cleanups.push_back(cleanup);
+}
+
+int Application::terminate()
+{
+    ApplicationState &s = state();
+    while(!s.cleanups.empty())
+    {
+        s.cleanups.back()();
+        s.cleanups.pop_back();
+    }
+    // the pooled resources still referenced go too, GL objects can't outlive the context
+    ResourceManager::clear();
+    // the GL handles destroyed from now on (e.g. main's locals) have nothing to delete
+    GLContext::destroyed();
+    // glfw: terminate, clearing all previously allocated GLFW resources.
+    glfwTerminate();
+    s.window = NULL;
+    return 0;
+}
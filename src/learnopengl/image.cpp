@@ -0,0 +1,112 @@
+#include <learnopengl/image.h>
+
+#include <glad/glad.h>
+
+// stb_image only picks its SIMD decoders by itself on x86-64; ask for them on 32 bit x86 with SSE2 and on ARM
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STBI_SSE2
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define STBI_NEON
+#endif
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    // swaps the rows in place: stb's own flip is a global setting shared by every thread
+    void flipRows(unsigned char *pixels, int width, int height, int channels)
+    {
+        const size_t stride = static_cast<size_t>(width) * channels;
+        for(int top = 0, bottom = height - 1; top < bottom; top++, bottom--)
+            std::swap_ranges(pixels + top * stride, pixels + (top + 1) * stride, pixels + bottom * stride);
+    }
+}
+
+Image::Image() : pixels(0), w(0), h(0), n(0)
+{
+}
+
+Image::~Image()
+{
+    stbi_image_free(pixels);
+}
+
+Image::Image(Image &&other) : pixels(other.pixels), w(other.w), h(other.h), n(other.n)
+{
+    other.pixels = 0;
+}
+
+Image& Image::operator=(Image &&other)
+{
+    if(this != &other)
+    {
+        stbi_image_free(pixels);
+        pixels = other.pixels, w = other.w, h = other.h, n = other.n;
+        other.pixels = 0;
+    }
+    return *this;
+}
+
+Image Image::load(const std::string &path, bool flipVertically, int channels)
+{
+    int width, height, fileChannels;
+    unsigned char *pixels = stbi_load(path.c_str(), &width, &height, &fileChannels, channels);
+    if(!pixels)
+    {
+        std::cout << "ERROR::IMAGE::LOAD:: " << path << ": " << stbi_failure_reason() << std::endl;
+        return Image();
+    }
+    return decoded(pixels, width, height, channels ? channels : fileChannels, flipVertically);
+}
+
+Image Image::loadFromMemory(const unsigned char *bytes, int size, bool flipVertically, int channels)
+{
+    int width, height, fileChannels;
+    unsigned char *pixels = stbi_load_from_memory(bytes, size, &width, &height, &fileChannels, channels);
+    if(!pixels)
+    {
+        std::cout << "ERROR::IMAGE::LOAD:: in memory: " << stbi_failure_reason() << std::endl;
+        return Image();
+    }
+    return decoded(pixels, width, height, channels ? channels : fileChannels, flipVertically);
+}
+
+bool Image::writePng(const std::string &path, int width, int height, int channels, const unsigned char *pixels,
+                     bool flipVertically)
+{
+    const int stride = width * channels;
+    if(!flipVertically)
+        return stbi_write_png(path.c_str(), width, height, channels, pixels, stride) != 0;
+    std::vector<unsigned char> flipped(pixels, pixels + static_cast<size_t>(stride) * height);
+    flipRows(&flipped[0], width, height, channels);
+    return stbi_write_png(path.c_str(), width, height, channels, &flipped[0], stride) != 0;
+}
+
+unsigned int Image::format() const
+{
+    switch(n)
+    {
+    case 1: return GL_RED;
+    case 2: return GL_RG;
+    case 3: return GL_RGB;
+    default: return GL_RGBA;
+    }
+}
+
+Image Image::decoded(unsigned char *pixels, int width, int height, int channels, bool flipVertically)
+{
+    if(flipVertically)
+        flipRows(pixels, width, height, channels);
+    Image image;
+    image.pixels = pixels, image.w = width, image.h = height, image.n = channels;
+    return image;
+}
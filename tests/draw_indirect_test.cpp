@@ -0,0 +1,120 @@
+// IndirectDrawList::build on a batch whose ranges are filled by hand: instance merging, command order, per-LOD
+// firstIndex/baseVertex, baseInstance offsets and submission groups. build() doesn't call OpenGL, so no context
+// is needed.
+
+#include <glad/glad.h>
+
+#include <learnopengl/draw_indirect.h>
+
+#include "test.h"
+
+static MeshBatch::Range makeRange(unsigned int firstIndex, unsigned int indexCount, int baseVertex, unsigned int texture)
+{
+    MeshBatch::Range range;
+    range.firstIndex = firstIndex;
+    range.indexCount = indexCount;
+    range.baseVertex = baseVertex;
+    Texture diffuse;
+    diffuse.id = texture;
+    diffuse.type = "texture_diffuse";
+    range.textures.push_back(diffuse);
+    return range;
+}
+
+static MeshLod makeLod(unsigned int firstIndex, unsigned int indexCount)
+{
+    MeshLod lod = { firstIndex, indexCount, 0.0f };
+    return lod;
+}
+
+// the model matrix of instance i is a scale by i, so instances can be told apart by their [0][0]
+static glm::mat4 instance(float i)
+{
+    return glm::mat4(i);
+}
+
+static bool sameCommand(const DrawElementsIndirectCommand &command, GLuint count, GLuint instanceCount, GLuint firstIndex,
+                        GLint baseVertex, GLuint baseInstance)
+{
+    return command.count == count && command.instanceCount == instanceCount && command.firstIndex == firstIndex &&
+           command.baseVertex == baseVertex && command.baseInstance == baseInstance;
+}
+
+// box (no LODs), rock (3 LODs) and a differently textured crate, packed one after the other
+static void buildCommands()
+{
+    MeshBatch batch;
+    batch.ranges.push_back(makeRange(0, 36, 0, 1));
+    MeshBatch::Range rock = makeRange(36, 300, 24, 1);
+    rock.lods.push_back(makeLod(36, 300));
+    rock.lods.push_back(makeLod(336, 120));
+    rock.lods.push_back(makeLod(456, 30));
+    batch.ranges.push_back(rock);
+    batch.ranges.push_back(makeRange(486, 60, 140, 2));
+
+    IndirectDrawList list;
+    list.add(batch, instance(1.0f));            // every range, LOD 0
+    list.add(batch, 1, instance(2.0f), 1);
+    list.add(batch, 0, instance(3.0f));
+    list.add(batch, 1, instance(4.0f), 7);      // clamped to the last LOD
+    list.add(batch, 1, instance(5.0f), 1);
+    list.build();
+
+    // sorted by range then LOD, instances of a same mesh in submission order
+    const vector<DrawElementsIndirectCommand> &commands = list.getCommands();
+    CHECK(commands.size() == 5);
+    if(commands.size() == 5)
+    {
+        CHECK(sameCommand(commands[0], 36, 2, 0, 0, 0));
+        CHECK(sameCommand(commands[1], 300, 1, 36, 24, 2));
+        CHECK(sameCommand(commands[2], 120, 2, 336, 24, 3));
+        CHECK(sameCommand(commands[3], 30, 1, 456, 24, 5));
+        CHECK(sameCommand(commands[4], 60, 1, 486, 140, 6));
+    }
+
+    // the matrices indexed by baseInstance
+    const vector<glm::mat4> &instances = list.getInstances();
+    const float expected[] = { 1.0f, 3.0f, 1.0f, 2.0f, 5.0f, 4.0f, 1.0f };
+    CHECK(instances.size() == 7);
+    for(unsigned int i = 0; i < instances.size() && i < 7; i++)
+        CHECK(instances[i][0][0] == expected[i]);
+
+    // box and rock share their textures: one group; the crate gets its own
+    const vector<IndirectDrawGroup> &groups = list.getGroups();
+    CHECK(groups.size() == 2);
+    if(groups.size() == 2)
+    {
+        CHECK(groups[0].batch == &batch && groups[0].firstCommand == 0 && groups[0].commandCount == 4);
+        CHECK(groups[1].batch == &batch && groups[1].range == 2 && groups[1].firstCommand == 4 && groups[1].commandCount == 1);
+    }
+}
+
+// commands of different batches are never merged, and clear() starts a new frame
+static void separateBatches()
+{
+    MeshBatch first, second;
+    first.ranges.push_back(makeRange(0, 36, 0, 1));
+    second.ranges.push_back(makeRange(0, 36, 0, 1));
+
+    IndirectDrawList list;
+    list.add(first, instance(1.0f));
+    list.add(second, instance(2.0f));
+    list.add(first, instance(3.0f));
+    list.build();
+    CHECK(list.getCommands().size() == 2);
+    CHECK(list.getGroups().size() == 2);
+    CHECK(list.getInstances().size() == 3);
+
+    list.clear();
+    list.add(second, instance(4.0f));
+    list.build();
+    CHECK(list.getCommands().size() == 1);
+    CHECK(list.getInstances().size() == 1 && list.getInstances()[0][0][0] == 4.0f);
+}
+
+int main()
+{
+    RUN_TEST(buildCommands);
+    RUN_TEST(separateBatches);
+    return test::result();
+}
@@ -0,0 +1,133 @@
+// FrameGraph::compile: pass order, culling, texture aliasing and the declarations it rejects. compile() doesn't
+// call OpenGL, so no context is needed.
+
+#include <glad/glad.h>
+
+#include <learnopengl/frame_graph.h>
+
+#include "test.h"
+
+#include <vector>
+
+static void noExecute(const FrameGraphPassResources &)
+{
+}
+
+// present <- blur <- scene, declared the other way round: reads of textures whose writers come later
+static void outOfOrderChain()
+{
+    FrameGraph graph;
+    const FrameGraphTextureDesc desc(64, 64);
+    FrameGraphResource screen = graph.importFramebuffer("screen", 0, 64, 64);
+    FrameGraphResource color = graph.createTexture("color", desc);
+    FrameGraphResource blurred = graph.createTexture("blurred", desc);
+    const unsigned int present = graph.addPass("present",
+        [&](FrameGraphBuilder &builder) { builder.read(blurred); builder.write(screen); }, noExecute);
+    const unsigned int blur = graph.addPass("blur",
+        [&](FrameGraphBuilder &builder) { builder.read(color); builder.write(blurred); }, noExecute);
+    const unsigned int scene = graph.addPass("scene",
+        [&](FrameGraphBuilder &builder) { builder.write(color); }, noExecute);
+
+    CHECK(graph.compile());
+    std::vector<unsigned int> expected;
+    expected.push_back(scene);
+    expected.push_back(blur);
+    expected.push_back(present);
+    CHECK(graph.passOrder() == expected);
+}
+
+// debug passes nothing reads are culled, unless they declare a side effect or write an output
+static void culling()
+{
+    FrameGraph graph;
+    const FrameGraphTextureDesc desc(64, 64);
+    FrameGraphResource screen = graph.importFramebuffer("screen", 0, 64, 64);
+    FrameGraphResource color = FRAME_GRAPH_INVALID, normals = FRAME_GRAPH_INVALID, exported = FRAME_GRAPH_INVALID;
+    const unsigned int scene = graph.addPass("scene",
+        [&](FrameGraphBuilder &builder) { color = builder.create("color", desc); }, noExecute);
+    const unsigned int debugNormals = graph.addPass("debugNormals",
+        [&](FrameGraphBuilder &builder) { normals = builder.create("normals", desc); }, noExecute);
+    const unsigned int debugOverlay = graph.addPass("debugOverlay",
+        [&](FrameGraphBuilder &builder) { builder.read(normals); builder.create("overlay", desc); }, noExecute);
+    const unsigned int capture = graph.addPass("capture",
+        [&](FrameGraphBuilder &builder) { builder.read(color); builder.sideEffect(); }, noExecute);
+    const unsigned int exporter = graph.addPass("export",
+        [&](FrameGraphBuilder &builder) { builder.read(color); exported = builder.create("exported", desc); }, noExecute);
+    const unsigned int present = graph.addPass("present",
+        [&](FrameGraphBuilder &builder) { builder.read(color); builder.write(screen); }, noExecute);
+    graph.markOutput(exported);
+
+    CHECK(graph.compile());
+    CHECK(!graph.isCulled(scene));
+    CHECK(graph.isCulled(debugNormals));
+    CHECK(graph.isCulled(debugOverlay));
+    CHECK(!graph.isCulled(capture));
+    CHECK(!graph.isCulled(exporter));
+    CHECK(!graph.isCulled(present));
+    CHECK(graph.passOrder().size() == 4);
+}
+
+// a -> b -> c -> d -> screen: a and c don't overlap and share a texture, b overlaps both, d has another format
+static void aliasing()
+{
+    FrameGraph graph;
+    const FrameGraphTextureDesc desc(64, 64, GL_RGBA8);
+    FrameGraphResource screen = graph.importFramebuffer("screen", 0, 64, 64);
+    FrameGraphResource a = FRAME_GRAPH_INVALID, b = FRAME_GRAPH_INVALID, c = FRAME_GRAPH_INVALID, d = FRAME_GRAPH_INVALID;
+    graph.addPass("pass0", [&](FrameGraphBuilder &builder) { a = builder.create("a", desc); }, noExecute);
+    graph.addPass("pass1", [&](FrameGraphBuilder &builder) { builder.read(a); b = builder.create("b", desc); }, noExecute);
+    graph.addPass("pass2", [&](FrameGraphBuilder &builder) { builder.read(b); c = builder.create("c", desc); }, noExecute);
+    graph.addPass("pass3",
+        [&](FrameGraphBuilder &builder) { builder.read(c); d = builder.create("d", FrameGraphTextureDesc(64, 64, GL_RGBA16F)); },
+        noExecute);
+    graph.addPass("pass4", [&](FrameGraphBuilder &builder) { builder.read(d); builder.write(screen); }, noExecute);
+
+    CHECK(graph.compile());
+    CHECK(graph.physicalSlot(a) == graph.physicalSlot(c));
+    CHECK(graph.physicalSlot(a) != graph.physicalSlot(b));
+    CHECK(graph.physicalSlot(b) != graph.physicalSlot(c));
+    CHECK(graph.physicalSlot(d) != graph.physicalSlot(a));
+    CHECK(graph.physicalSlot(d) != graph.physicalSlot(b));
+    CHECK(graph.physicalCount() == 3);
+}
+
+static void rejectsCycle()
+{
+    FrameGraph graph;
+    const FrameGraphTextureDesc desc(64, 64);
+    FrameGraphResource first = graph.importTexture("first", 1, desc);
+    FrameGraphResource second = graph.importTexture("second", 2, desc);
+    graph.addPass("ping", [&](FrameGraphBuilder &builder) { builder.read(first); builder.write(second); }, noExecute);
+    graph.addPass("pong", [&](FrameGraphBuilder &builder) { builder.read(second); builder.write(first); }, noExecute);
+    CHECK(!graph.compile());
+}
+
+static void rejectsReadOfUnwrittenTexture()
+{
+    FrameGraph graph;
+    FrameGraphResource screen = graph.importFramebuffer("screen", 0, 64, 64);
+    FrameGraphResource orphan = graph.createTexture("orphan", FrameGraphTextureDesc(64, 64));
+    graph.addPass("present", [&](FrameGraphBuilder &builder) { builder.read(orphan); builder.write(screen); }, noExecute);
+    CHECK(!graph.compile());
+}
+
+static void rejectsFramebufferWithOtherTargets()
+{
+    FrameGraph graph;
+    FrameGraphResource screen = graph.importFramebuffer("screen", 0, 64, 64);
+    graph.addPass("present",
+        [&](FrameGraphBuilder &builder) { builder.write(screen); builder.create("extra", FrameGraphTextureDesc(64, 64)); },
+        noExecute);
+    CHECK(!graph.compile());
+}
+
+int main()
+{
+    RUN_TEST(outOfOrderChain);
+    RUN_TEST(culling);
+    RUN_TEST(aliasing);
+    RUN_TEST(rejectsCycle);
+    RUN_TEST(rejectsReadOfUnwrittenTexture);
+    RUN_TEST(rejectsFramebufferWithOtherTargets);
+    return test::result();
+}
@@ -0,0 +1,213 @@
+// Import-time mesh optimizations on a generated grid whose triangles are shuffled with a fixed seed: every pass
+// must keep the same triangles with the same winding, and the cache ones must not make the ACMR worse.
+
+#include <learnopengl/mesh_optimizer.h>
+
+#include "test.h"
+
+#include <algorithm>
+#include <vector>
+
+struct GridVertex {
+    glm::vec3 Position;
+};
+
+// a triangle as its corners rotated so the smallest one comes first: rotations keep the winding
+struct Triangle {
+    unsigned int a, b, c;
+
+    bool operator<(const Triangle &other) const
+    {
+        if(a != other.a)
+            return a < other.a;
+        if(b != other.b)
+            return b < other.b;
+        return c < other.c;
+    }
+
+    bool operator==(const Triangle &other) const
+    {
+        return a == other.a && b == other.b && c == other.c;
+    }
+};
+
+static Triangle makeTriangle(unsigned int a, unsigned int b, unsigned int c)
+{
+    Triangle t;
+    if(a <= b && a <= c)
+        t.a = a, t.b = b, t.c = c;
+    else if(b <= a && b <= c)
+        t.a = b, t.b = c, t.c = a;
+    else
+        t.a = c, t.b = a, t.c = b;
+    return t;
+}
+
+// the triangles of the index buffer, in vertex ids of the given table (identity if empty), sorted
+static vector<Triangle> sortedTriangles(const vector<unsigned int> &indices, const vector<unsigned int> &ids = vector<unsigned int>())
+{
+    vector<Triangle> triangles;
+    for(size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        if(ids.empty())
+            triangles.push_back(makeTriangle(indices[i], indices[i + 1], indices[i + 2]));
+        else
+            triangles.push_back(makeTriangle(ids[indices[i]], ids[indices[i + 1]], ids[indices[i + 2]]));
+    }
+    sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+// size x size quads on a bumpy surface, triangles shuffled so the input order is cache unfriendly
+static void makeGrid(unsigned int size, vector<GridVertex> &vertices, vector<unsigned int> &indices)
+{
+    vertices.clear();
+    indices.clear();
+    for(unsigned int y = 0; y <= size; y++)
+        for(unsigned int x = 0; x <= size; x++)
+        {
+            GridVertex v;
+            v.Position = glm::vec3(float(x), float(y), sin(float(x) * 0.7f) * cos(float(y) * 0.4f));
+            vertices.push_back(v);
+        }
+
+    vector<Triangle> triangles;
+    for(unsigned int y = 0; y < size; y++)
+        for(unsigned int x = 0; x < size; x++)
+        {
+            const unsigned int i = y * (size + 1) + x;
+            Triangle first = { i, i + 1, i + size + 2 }, second = { i, i + size + 2, i + size + 1 };
+            triangles.push_back(first);
+            triangles.push_back(second);
+        }
+    unsigned int seed = 12345u;
+    for(size_t i = triangles.size() - 1; i > 0; i--)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        std::swap(triangles[i], triangles[(seed >> 8) % (i + 1)]);
+    }
+    for(size_t i = 0; i < triangles.size(); i++)
+    {
+        indices.push_back(triangles[i].a);
+        indices.push_back(triangles[i].b);
+        indices.push_back(triangles[i].c);
+    }
+}
+
+static void analyzeCache()
+{
+    vector<unsigned int> indices;
+    indices.push_back(0), indices.push_back(1), indices.push_back(2);
+    VertexCacheStats single = analyzeVertexCache(indices, 3);
+    CHECK(single.transformed == 3 && single.acmr == 3.0f && single.atvr == 1.0f);
+
+    // the second copy of the triangle hits the cache
+    indices.push_back(2), indices.push_back(0), indices.push_back(1);
+    VertexCacheStats twice = analyzeVertexCache(indices, 3);
+    CHECK(twice.transformed == 3 && twice.acmr == 1.5f);
+
+    // fewer than 3 indices: no triangle, no division by zero
+    indices.resize(2);
+    VertexCacheStats partial = analyzeVertexCache(indices, 3);
+    CHECK(partial.transformed == 2 && partial.acmr == 0.0f);
+    CHECK(analyzeVertexCache(vector<unsigned int>(), 3).acmr == 0.0f);
+}
+
+static void vertexCache()
+{
+    vector<GridVertex> vertices;
+    vector<unsigned int> indices;
+    makeGrid(32, vertices, indices);
+    const vector<unsigned int> original = indices;
+
+    optimizeVertexCache(indices, vertices.size());
+    CHECK(indices.size() == original.size());
+    CHECK(sortedTriangles(indices) == sortedTriangles(original));
+    const float before = analyzeVertexCache(original, vertices.size()).acmr;
+    const float after = analyzeVertexCache(indices, vertices.size()).acmr;
+    CHECK(after <= before);
+    CHECK(after < 1.0f);
+}
+
+static void vertexFetch()
+{
+    vector<GridVertex> vertices;
+    vector<unsigned int> indices;
+    makeGrid(16, vertices, indices);
+    const vector<GridVertex> originalVertices = vertices;
+    const vector<unsigned int> originalIndices = indices;
+
+    vector<unsigned int> remap = optimizeVertexFetch(vertices, indices);
+    CHECK(vertices.size() == originalVertices.size());
+    CHECK(indices.size() == originalIndices.size());
+
+    // every index addresses the same position as before
+    bool samePositions = true;
+    for(size_t i = 0; i < indices.size(); i++)
+        samePositions = samePositions && vertices[indices[i]].Position == originalVertices[originalIndices[i]].Position;
+    CHECK(samePositions);
+    bool remapped = true;
+    for(size_t i = 0; i < indices.size(); i++)
+        remapped = remapped && remap[originalIndices[i]] == indices[i];
+    CHECK(remapped);
+
+    // vertices come in the order of their first reference
+    unsigned int next = 0;
+    bool firstReferenceOrder = true;
+    for(size_t i = 0; i < indices.size(); i++)
+    {
+        firstReferenceOrder = firstReferenceOrder && indices[i] <= next;
+        if(indices[i] == next)
+            next++;
+    }
+    CHECK(firstReferenceOrder);
+
+    // the remap is a permutation, so the triangles are the same once mapped back
+    vector<unsigned int> sortedRemap = remap;
+    sort(sortedRemap.begin(), sortedRemap.end());
+    bool permutation = true;
+    for(unsigned int v = 0; v < sortedRemap.size(); v++)
+        permutation = permutation && sortedRemap[v] == v;
+    CHECK(permutation);
+    vector<unsigned int> inverse(remap.size());
+    for(unsigned int v = 0; v < remap.size(); v++)
+        inverse[remap[v]] = v;
+    CHECK(sortedTriangles(indices, inverse) == sortedTriangles(originalIndices));
+}
+
+static void overdraw()
+{
+    vector<GridVertex> vertices;
+    vector<unsigned int> indices;
+    makeGrid(32, vertices, indices);
+    optimizeVertexCache(indices, vertices.size());
+    const vector<unsigned int> cacheOptimized = indices;
+
+    optimizeOverdraw(indices, vertices);
+    CHECK(sortedTriangles(indices) == sortedTriangles(cacheOptimized));
+    const float before = analyzeVertexCache(cacheOptimized, vertices.size()).acmr;
+    const float after = analyzeVertexCache(indices, vertices.size()).acmr;
+    CHECK(after <= before * 1.05f);
+}
+
+static void wholePipeline()
+{
+    vector<GridVertex> vertices;
+    vector<unsigned int> indices;
+    makeGrid(32, vertices, indices);
+    MeshOptimizationReport report;
+    optimizeMesh(vertices, indices, true, &report);
+    CHECK(report.triangles == 32 * 32 * 2);
+    CHECK(report.acmrAfter() <= report.acmrBefore());
+    CHECK(MeshOptimizationReport().acmrBefore() == 0.0f);
+}
+
+int main()
+{
+    RUN_TEST(analyzeCache);
+    RUN_TEST(vertexCache);
+    RUN_TEST(vertexFetch);
+    RUN_TEST(overdraw);
+    RUN_TEST(wholePipeline);
+    return test::result();
+}
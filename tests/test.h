@@ -0,0 +1,58 @@
+// Minimal unit test harness for the tests in this directory, run by ctest. A test is a function of CHECKs:
+//
+//     static void textureDescEquality()
+//     {
+//         CHECK(FrameGraphTextureDesc(4, 4) == FrameGraphTextureDesc(4, 4, GL_RGBA8));
+//     }
+//
+//     int main()
+//     {
+//         RUN_TEST(textureDescEquality);
+//         return test::result();
+//     }
+//
+// A failed CHECK prints its file, line and expression and the test goes on; the executable fails if any did.
+
+#ifndef TEST_HARNESS_H
+#define TEST_HARNESS_H
+
+#include <iostream>
+
+namespace test {
+
+inline unsigned int& failures()
+{
+    static unsigned int count = 0;
+    return count;
+}
+
+inline bool check(bool ok, const char *expression, const char *file, int line)
+{
+    if(!ok)
+    {
+        std::cout << file << ":" << line << ": CHECK(" << expression << ") failed" << std::endl;
+        failures()++;
+    }
+    return ok;
+}
+
+inline void run(void (*function)(), const char *name)
+{
+    const unsigned int before = failures();
+    function();
+    std::cout << (failures() == before ? "[ OK ] " : "[FAIL] ") << name << std::endl;
+}
+
+inline int result()
+{
+    if(failures())
+        std::cout << failures() << " check(s) failed" << std::endl;
+    return failures() ? 1 : 0;
+}
+
+} // namespace test
+
+#define CHECK(condition) test::check((condition), #condition, __FILE__, __LINE__)
+#define RUN_TEST(function) test::run(function, #function)
+
+#endif